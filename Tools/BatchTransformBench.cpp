@@ -0,0 +1,288 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Checks that the batch transforms in Framework::BatchTransform give the same bits as glm applied
+//to one element at a time, and times both.
+//
+//Usage: BatchTransformBench [-iterations <n>] [-threads <n>]
+//	-iterations <n>		Number of passes over the test data to time. The default is 20.
+//	-threads <n>		Threads for the threaded timings. The default is 0, one per core.
+//
+//Every function is checked with counts that leave partial blocks of 1 to 3 elements, and with
+//counts large enough to be split across several threads. The exit code is 0 if nothing differed,
+//and 1 otherwise.
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <glm/glm.hpp>
+#include "../framework/BatchTransform.h"
+#include "BenchCommon.h"
+
+namespace
+{
+	//Enough for three threads at the batch functions' minimum sizes, and not a multiple of 4.
+	const size_t g_numPoints = 3 * 32768 + 7;
+	const size_t g_numMatrices = 3 * 8192 + 5;
+
+	//Small counts test the partial blocks; the full counts test the threading.
+	const size_t g_smallCounts[] = {1, 2, 3, 4, 5, 6, 7, 1001};
+
+	glm::vec4 RandomVec4()
+	{
+		return glm::vec4(Bench::RandomFloat(-100.0f, 100.0f), Bench::RandomFloat(-100.0f, 100.0f),
+			Bench::RandomFloat(-100.0f, 100.0f), Bench::RandomFloat(-2.0f, 2.0f));
+	}
+
+	//Random, but affine, as TransformPoints expects.
+	glm::mat4 RandomMatrix()
+	{
+		glm::mat4 theMatrix;
+		for(int iColumn = 0; iColumn < 4; iColumn++)
+			theMatrix[iColumn] = glm::vec4(glm::vec3(RandomVec4()), iColumn == 3 ? 1.0f : 0.0f);
+		return theMatrix;
+	}
+
+	struct TestData
+	{
+		glm::mat4 theMatrix;
+		std::vector<glm::vec3> points;
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+		std::vector<glm::vec4> vectors;
+		std::vector<glm::mat4> lefts;
+		std::vector<glm::mat4> rights;
+		std::vector<unsigned int> parentIndices;
+	};
+
+	void MakeTestData(TestData &data)
+	{
+		data.theMatrix = RandomMatrix();
+		for(size_t iPoint = 0; iPoint < g_numPoints; iPoint++)
+		{
+			glm::vec4 random = RandomVec4();
+			data.points.push_back(glm::vec3(random));
+			data.x.push_back(random.x);
+			data.y.push_back(random.y);
+			data.z.push_back(random.z);
+			data.vectors.push_back(RandomVec4());
+		}
+
+		for(size_t iMatrix = 0; iMatrix < g_numMatrices; iMatrix++)
+		{
+			data.lefts.push_back(RandomMatrix());
+			data.rights.push_back(RandomMatrix());
+			data.parentIndices.push_back((Bench::NextRandom() >> 8) % (unsigned int)g_numMatrices);
+		}
+	}
+
+	template<typename T>
+	int CountDifferences(const char *strName, size_t count, unsigned int numThreads,
+		const std::vector<T> &results, const std::vector<T> &expected)
+	{
+		int numDifferences = 0;
+		for(size_t iElement = 0; iElement < count; iElement++)
+		{
+			if(memcmp(&results[iElement], &expected[iElement], sizeof(T)) != 0)
+				numDifferences++;
+		}
+
+		if(numDifferences != 0)
+		{
+			printf("DIFFERENT: %s, %d elements on %u threads: %d differ\n", strName, (int)count, numThreads,
+				numDifferences);
+		}
+
+		return numDifferences;
+	}
+
+	int CheckPoints(const TestData &data, size_t count, unsigned int numThreads)
+	{
+		std::vector<glm::vec3> expected3(count);
+		std::vector<glm::vec4> expected4(count);
+		std::vector<glm::vec4> expectedVectors(count);
+		for(size_t iPoint = 0; iPoint < count; iPoint++)
+		{
+			expected4[iPoint] = data.theMatrix * glm::vec4(data.points[iPoint], 1.0f);
+			expected3[iPoint] = glm::vec3(expected4[iPoint]);
+			expectedVectors[iPoint] = data.theMatrix * data.vectors[iPoint];
+		}
+
+		std::vector<glm::vec3> points3(count);
+		std::vector<glm::vec4> points4(count);
+		std::vector<glm::vec4> vectors(count);
+		Framework::TransformPoints(data.theMatrix, &data.points[0], &points3[0], count, numThreads);
+		Framework::TransformPoints(data.theMatrix, &data.points[0], &points4[0], count, numThreads);
+		Framework::TransformVectors(data.theMatrix, &data.vectors[0], &vectors[0], count, numThreads);
+
+		int numDifferences = CountDifferences("TransformPoints to vec3", count, numThreads, points3, expected3);
+		numDifferences += CountDifferences("TransformPoints to vec4", count, numThreads, points4, expected4);
+		numDifferences += CountDifferences("TransformVectors", count, numThreads, vectors, expectedVectors);
+
+		//SoA, with and without w.
+		std::vector<float> outX(count), outY(count), outZ(count), outW(count);
+		std::vector<glm::vec4> soa(count);
+		for(int iPass = 0; iPass < 2; iPass++)
+		{
+			bool bWithW = iPass == 0;
+			Framework::TransformPointsSoA(data.theMatrix, &data.x[0], &data.y[0], &data.z[0],
+				&outX[0], &outY[0], &outZ[0], bWithW ? &outW[0] : NULL, count, numThreads);
+			for(size_t iPoint = 0; iPoint < count; iPoint++)
+				soa[iPoint] = glm::vec4(outX[iPoint], outY[iPoint], outZ[iPoint], bWithW ? outW[iPoint] : 1.0f);
+
+			numDifferences += CountDifferences(bWithW ? "TransformPointsSoA" : "TransformPointsSoA without w",
+				count, numThreads, soa, expected4);
+		}
+
+		return numDifferences;
+	}
+
+	int CheckMatrices(const TestData &data, size_t count, unsigned int numThreads)
+	{
+		std::vector<glm::mat4> expectedPairs(count);
+		std::vector<glm::mat4> expectedOneLeft(count);
+		std::vector<glm::mat4> expectedParents(count);
+		for(size_t iMatrix = 0; iMatrix < count; iMatrix++)
+		{
+			expectedPairs[iMatrix] = data.lefts[iMatrix] * data.rights[iMatrix];
+			expectedOneLeft[iMatrix] = data.theMatrix * data.rights[iMatrix];
+			expectedParents[iMatrix] = data.lefts[data.parentIndices[iMatrix]] * data.rights[iMatrix];
+		}
+
+		std::vector<glm::mat4> results(count);
+		Framework::MultiplyMatrices(&data.lefts[0], &data.rights[0], &results[0], count, numThreads);
+		int numDifferences = CountDifferences("MultiplyMatrices", count, numThreads, results, expectedPairs);
+
+		Framework::MultiplyMatrices(data.theMatrix, &data.rights[0], &results[0], count, numThreads);
+		numDifferences += CountDifferences("MultiplyMatrices, one left", count, numThreads, results,
+			expectedOneLeft);
+
+		Framework::MultiplyMatrices(&data.lefts[0], &data.parentIndices[0], &data.rights[0], &results[0],
+			count, numThreads);
+		numDifferences += CountDifferences("MultiplyMatrices, indexed", count, numThreads, results,
+			expectedParents);
+
+		return numDifferences;
+	}
+
+	int CheckAll(const TestData &data)
+	{
+		const unsigned int threadCounts[] = {1, 3};
+
+		int numDifferences = 0;
+		for(int iThreads = 0; iThreads < 2; iThreads++)
+		{
+			unsigned int numThreads = threadCounts[iThreads];
+			for(size_t iCount = 0; iCount < sizeof(g_smallCounts) / sizeof(g_smallCounts[0]); iCount++)
+			{
+				numDifferences += CheckPoints(data, g_smallCounts[iCount], numThreads);
+				numDifferences += CheckMatrices(data, g_smallCounts[iCount], numThreads);
+			}
+
+			numDifferences += CheckPoints(data, g_numPoints, numThreads);
+			numDifferences += CheckMatrices(data, g_numMatrices, numThreads);
+		}
+
+		return numDifferences;
+	}
+
+	void TimeTransforms(const TestData &data, int iNumIterations, unsigned int numThreads)
+	{
+		std::vector<glm::vec3> points(g_numPoints);
+		std::vector<float> outX(g_numPoints), outY(g_numPoints), outZ(g_numPoints);
+		std::vector<glm::mat4> matrices(g_numMatrices);
+		float checksum = 0.0f;
+
+		printf("per point:\n");
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			for(size_t iPoint = 0; iPoint < g_numPoints; iPoint++)
+				points[iPoint] = glm::vec3(data.theMatrix * glm::vec4(data.points[iPoint], 1.0f));
+			checksum += points[iIteration % g_numPoints].x;
+		}
+		Bench::PrintTime("glm", start, iNumIterations, g_numPoints, checksum);
+
+		for(int iThreaded = 0; iThreaded < 2; iThreaded++)
+		{
+			unsigned int threads = iThreaded ? numThreads : 1;
+
+			start = std::chrono::steady_clock::now();
+			for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+			{
+				Framework::TransformPoints(data.theMatrix, &data.points[0], &points[0], g_numPoints, threads);
+				checksum += points[iIteration % g_numPoints].x;
+			}
+			Bench::PrintTime(iThreaded ? "TransformPoints, threaded" : "TransformPoints", start, iNumIterations,
+				g_numPoints, checksum);
+
+			start = std::chrono::steady_clock::now();
+			for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+			{
+				Framework::TransformPointsSoA(data.theMatrix, &data.x[0], &data.y[0], &data.z[0],
+					&outX[0], &outY[0], &outZ[0], NULL, g_numPoints, threads);
+				checksum += outX[iIteration % g_numPoints];
+			}
+			Bench::PrintTime(iThreaded ? "TransformPointsSoA, threaded" : "TransformPointsSoA", start, iNumIterations,
+				g_numPoints, checksum);
+		}
+
+		printf("per matrix:\n");
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			for(size_t iMatrix = 0; iMatrix < g_numMatrices; iMatrix++)
+				matrices[iMatrix] = data.lefts[iMatrix] * data.rights[iMatrix];
+			checksum += matrices[iIteration % g_numMatrices][3].x;
+		}
+		Bench::PrintTime("glm", start, iNumIterations, g_numMatrices, checksum);
+
+		for(int iThreaded = 0; iThreaded < 2; iThreaded++)
+		{
+			start = std::chrono::steady_clock::now();
+			for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+			{
+				Framework::MultiplyMatrices(&data.lefts[0], &data.rights[0], &matrices[0], g_numMatrices,
+					iThreaded ? numThreads : 1);
+				checksum += matrices[iIteration % g_numMatrices][3].x;
+			}
+			Bench::PrintTime(iThreaded ? "MultiplyMatrices, threaded" : "MultiplyMatrices", start, iNumIterations,
+				g_numMatrices, checksum);
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int iNumIterations = 20;
+	unsigned int numThreads = 0;
+
+	for(int iArg = 1; iArg < argc; iArg++)
+	{
+		std::string strArg = argv[iArg];
+		bool bHasValue = iArg + 1 < argc;
+		if(strArg == "-iterations" && bHasValue)
+			iNumIterations = atoi(argv[++iArg]);
+		else if(strArg == "-threads" && bHasValue)
+			numThreads = (unsigned int)atoi(argv[++iArg]);
+		else
+		{
+			printf("Usage: BatchTransformBench [-iterations <n>] [-threads <n>]\n");
+			return 1;
+		}
+	}
+
+	TestData data;
+	MakeTestData(data);
+
+	int numDifferences = CheckAll(data);
+	printf("batch against glm: %d differ\n", numDifferences);
+
+	TimeTransforms(data, iNumIterations, numThreads);
+
+	return numDifferences == 0 ? 0 : 1;
+}
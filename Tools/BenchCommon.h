@@ -0,0 +1,117 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef TOOLS_BENCH_COMMON_H
+#define TOOLS_BENCH_COMMON_H
+
+//The pieces that the benchmark programs in Tools share. Each program is a single .cpp file, so
+//everything here is inline.
+
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+namespace Bench
+{
+	//A fixed generator, so that every build of a program tests the same data. All callers in a
+	//program share the one sequence.
+	inline unsigned int NextRandom()
+	{
+		static unsigned int seed = 12345;
+		seed = seed * 1664525 + 1013904223;
+		return seed;
+	}
+
+	//Uses the top 24 bits of the next number, so fMin itself is possible but fMax is not.
+	inline float RandomFloat(float fMin, float fMax)
+	{
+		return fMin + (fMax - fMin) * ((NextRandom() >> 8) / 16777216.0f);
+	}
+
+	inline double SecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	//Prints the nanoseconds per element. The checksum is printed so that the work cannot be
+	//optimized out.
+	inline void PrintTime(const char *strName, double seconds, int iNumIterations, size_t count, float checksum)
+	{
+		printf("%-28s %7.3f ns (checksum %g)\n", strName, seconds * 1.0e9 / ((double)iNumIterations * count),
+			checksum);
+	}
+
+	inline void PrintTime(const char *strName, std::chrono::steady_clock::time_point start, int iNumIterations,
+		size_t count, float checksum)
+	{
+		PrintTime(strName, SecondsSince(start), iNumIterations, count, checksum);
+	}
+
+	//Prints millions of elements per second.
+	inline void PrintRate(const char *strName, std::chrono::steady_clock::time_point start, int iNumIterations,
+		size_t count, float checksum)
+	{
+		double seconds = SecondsSince(start);
+		printf("%-28s %8.1f M/s (checksum %g)\n", strName, (double)iNumIterations * count / seconds / 1.0e6,
+			checksum);
+	}
+
+	//The same bits, except that any two NaNs are the same.
+	inline bool SameResult(float first, float second)
+	{
+		if(first != first && second != second)
+			return true;
+		return memcmp(&first, &second, sizeof(float)) == 0;
+	}
+
+	//Prints the first few differences, and returns how many there were.
+	inline int CountDifferences(const char *strName, const std::vector<float> &results,
+		const std::vector<float> &expected)
+	{
+		int numDifferences = 0;
+		for(size_t iResult = 0; iResult < results.size(); iResult++)
+		{
+			if(SameResult(results[iResult], expected[iResult]))
+				continue;
+
+			if(numDifferences < 10)
+			{
+				printf("DIFFERENT: %s %d: %.9g, not %.9g\n", strName, (int)iResult, results[iResult],
+					expected[iResult]);
+			}
+			numDifferences++;
+		}
+
+		return numDifferences;
+	}
+
+	//The files for -write and -check are the raw floats, in the order the program computes them.
+	//A build with GLM_FORCE_PURE writes the file, and the SIMD builds check against it.
+	inline bool WriteResults(const std::string &strFilename, const std::vector<float> &results)
+	{
+		FILE *pFile = fopen(strFilename.c_str(), "wb");
+		if(!pFile)
+			return false;
+
+		size_t numWritten = fwrite(&results[0], sizeof(float), results.size(), pFile);
+		return fclose(pFile) == 0 && numWritten == results.size();
+	}
+
+	//Reads exactly expected.size() floats. Returns false if the file is missing or too short.
+	inline bool ReadResults(const std::string &strFilename, std::vector<float> &expected)
+	{
+		FILE *pFile = fopen(strFilename.c_str(), "rb");
+		if(!pFile)
+			return false;
+
+		size_t numRead = fread(&expected[0], sizeof(float), expected.size(), pFile);
+		fclose(pFile);
+		return numRead == expected.size();
+	}
+}
+
+
+#endif //TOOLS_BENCH_COMMON_H
@@ -0,0 +1,348 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Times glm's float mat4 multiply, mat4 * vec4, transpose, determinant and inverse, and checks that
+//the SIMD versions give exactly the same results as the generic ones. Also times affineInverse and
+//rigidInverse, and checks that they agree with inverse to within rounding.
+//
+//Usage: GlmMatrixBench [options]
+//	-iterations <n>		Number of passes over the test matrices to time. The default is 2000.
+//	-write <file>		Write the results for the test matrices to this file.
+//	-check <file>		Fail if any result differs from the ones in this file.
+//
+//To check the SIMD code, build this once with GLM_FORCE_PURE and run it with -write, then build it
+//normally and run it with -check. NaN results only need to both be NaN. The check assumes that the
+//compiler does not fuse multiplies and adds, which would change the generic results.
+//
+//The exit code is 0 if nothing differed and the fast inverses were accurate, and 1 otherwise.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include "BenchCommon.h"
+
+namespace
+{
+	const int g_iNumMatrices = 4096;
+
+	//The most affineInverse and rigidInverse may differ from inverse, relative to the size of
+	//the value.
+	const float g_fMaxInverseError = 1.0e-4f;
+
+	const char *GetArchName()
+	{
+#if(GLM_ARCH == GLM_ARCH_PURE)
+		return "pure";
+#elif(defined(GLM_INTRINSIC_AVX))
+		return "AVX";
+#else
+		return "SSE2";
+#endif
+	}
+
+	glm::vec4 RandomVec(float fRange)
+	{
+		return glm::vec4(Bench::RandomFloat(-fRange, fRange), Bench::RandomFloat(-fRange, fRange),
+			Bench::RandomFloat(-fRange, fRange), Bench::RandomFloat(-fRange, fRange));
+	}
+
+	//Mostly general matrices, with some of the kinds that rounding or zeros make interesting.
+	glm::mat4 MakeTestMatrix(int iIndex)
+	{
+		glm::mat4 theMat(RandomVec(10.0f), RandomVec(10.0f), RandomVec(10.0f), RandomVec(10.0f));
+		switch(iIndex % 8)
+		{
+		case 0:
+			theMat = glm::mat4(1.0f);
+			break;
+		case 1:
+			//Affine, like the model matrices.
+			theMat[0].w = theMat[1].w = theMat[2].w = 0.0f;
+			theMat[3].w = 1.0f;
+			break;
+		case 2:
+			//Singular, so the inverse divides by zero.
+			theMat[2] = theMat[1] * 2.0f;
+			break;
+		case 3:
+			theMat *= 1.0e-12f;
+			break;
+		case 4:
+			theMat *= 1.0e12f;
+			break;
+		case 5:
+			//A perspective projection, with its zeros and negative zeros.
+			theMat = glm::mat4(0.0f);
+			theMat[0].x = Bench::RandomFloat(0.5f, 2.0f);
+			theMat[1].y = Bench::RandomFloat(0.5f, 2.0f);
+			theMat[2].z = Bench::RandomFloat(-1.1f, -1.0f);
+			theMat[2].w = -1.0f;
+			theMat[3].z = -0.0f;
+			break;
+		}
+
+		return theMat;
+	}
+
+	struct TestData
+	{
+		std::vector<glm::mat4> left;
+		std::vector<glm::mat4> right;
+		std::vector<glm::vec4> vectors;
+		std::vector<glm::mat4> rigid;
+		std::vector<glm::mat4> affine;
+	};
+
+	//A rotation and a translation, like a camera matrix.
+	glm::mat4 MakeRigidMatrix()
+	{
+		glm::vec3 xAxis = glm::normalize(glm::vec3(RandomVec(1.0f)) + glm::vec3(0.01f));
+		glm::vec3 yAxis = glm::normalize(glm::cross(glm::vec3(RandomVec(1.0f)) + glm::vec3(0.01f), xAxis));
+		glm::vec3 zAxis = glm::cross(xAxis, yAxis);
+
+		return glm::mat4(glm::vec4(xAxis, 0.0f), glm::vec4(yAxis, 0.0f), glm::vec4(zAxis, 0.0f),
+			glm::vec4(glm::vec3(RandomVec(100.0f)), 1.0f));
+	}
+
+	void MakeTestData(TestData &data)
+	{
+		for(int iMatrix = 0; iMatrix < g_iNumMatrices; iMatrix++)
+		{
+			data.left.push_back(MakeTestMatrix(iMatrix));
+			data.right.push_back(MakeTestMatrix(iMatrix / 8 + iMatrix * 3));
+			data.vectors.push_back(RandomVec(100.0f));
+		}
+
+		for(int iMatrix = 0; iMatrix < g_iNumMatrices; iMatrix++)
+		{
+			data.rigid.push_back(MakeRigidMatrix());
+
+			glm::mat4 scale(1.0f);
+			scale[0].x = Bench::RandomFloat(0.25f, 4.0f);
+			scale[1].y = Bench::RandomFloat(0.25f, 4.0f);
+			scale[2].z = Bench::RandomFloat(0.25f, 4.0f);
+			data.affine.push_back(MakeRigidMatrix() * scale);
+		}
+	}
+
+	void AddResults(std::vector<float> &results, const float *pValues, int iNumValues)
+	{
+		results.insert(results.end(), pValues, pValues + iNumValues);
+	}
+
+	std::vector<float> ComputeResults(const TestData &data)
+	{
+		std::vector<float> results;
+		for(int iMatrix = 0; iMatrix < g_iNumMatrices; iMatrix++)
+		{
+			const glm::mat4 &left = data.left[iMatrix];
+			glm::mat4 product = left * data.right[iMatrix];
+			glm::vec4 transformed = left * data.vectors[iMatrix];
+			glm::mat4 transposed = glm::transpose(left);
+			float determinant = glm::determinant(left);
+			glm::mat4 inverted = glm::inverse(left);
+
+			AddResults(results, &product[0][0], 16);
+			AddResults(results, &transformed[0], 4);
+			AddResults(results, &transposed[0][0], 16);
+			AddResults(results, &determinant, 1);
+			AddResults(results, &inverted[0][0], 16);
+		}
+
+		return results;
+	}
+
+	//The results are stored, so none of the work can be optimized out.
+	struct TimingOutput
+	{
+		std::vector<glm::mat4> matrices;
+		std::vector<glm::vec4> vectors;
+		std::vector<float> scalars;
+
+		TimingOutput() : matrices(g_iNumMatrices), vectors(g_iNumMatrices), scalars(g_iNumMatrices) {}
+	};
+
+	template<typename Op>
+	void TimeOp(const char *strName, int iNumIterations, const TestData &data, Op op)
+	{
+		TimingOutput output;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			for(int iMatrix = 0; iMatrix < g_iNumMatrices; iMatrix++)
+				op(data, iMatrix, output);
+		}
+
+		double seconds = Bench::SecondsSince(start);
+
+		float sum = 0.0f;
+		for(int iMatrix = 0; iMatrix < g_iNumMatrices; iMatrix++)
+			sum += output.matrices[iMatrix][3].x + output.vectors[iMatrix].y + output.scalars[iMatrix];
+
+		Bench::PrintTime(strName, seconds, iNumIterations, g_iNumMatrices, sum);
+	}
+
+	void MultiplyOp(const TestData &data, int iMatrix, TimingOutput &output)
+	{
+		output.matrices[iMatrix] = data.left[iMatrix] * data.right[iMatrix];
+	}
+
+	void TransformOp(const TestData &data, int iMatrix, TimingOutput &output)
+	{
+		output.vectors[iMatrix] = data.left[iMatrix] * data.vectors[iMatrix];
+	}
+
+	void TransposeOp(const TestData &data, int iMatrix, TimingOutput &output)
+	{
+		output.matrices[iMatrix] = glm::transpose(data.left[iMatrix]);
+	}
+
+	void DeterminantOp(const TestData &data, int iMatrix, TimingOutput &output)
+	{
+		output.scalars[iMatrix] = glm::determinant(data.right[iMatrix]);
+	}
+
+	void InverseOp(const TestData &data, int iMatrix, TimingOutput &output)
+	{
+		output.matrices[iMatrix] = glm::inverse(data.right[iMatrix]);
+	}
+
+	void AffineInverseOp(const TestData &data, int iMatrix, TimingOutput &output)
+	{
+		output.matrices[iMatrix] = glm::affineInverse(data.affine[iMatrix]);
+	}
+
+	void RigidInverseOp(const TestData &data, int iMatrix, TimingOutput &output)
+	{
+		output.matrices[iMatrix] = glm::rigidInverse(data.rigid[iMatrix]);
+	}
+
+	//The largest difference from inverse, relative to the size of the value.
+	template<typename Inverse>
+	float MaxInverseError(const std::vector<glm::mat4> &matrices, Inverse fastInverse)
+	{
+		float maxError = 0.0f;
+		for(size_t iMatrix = 0; iMatrix < matrices.size(); iMatrix++)
+		{
+			glm::mat4 fast = fastInverse(matrices[iMatrix]);
+			glm::mat4 generic = glm::inverse(matrices[iMatrix]);
+			for(int iColumn = 0; iColumn < 4; iColumn++)
+			{
+				for(int iRow = 0; iRow < 4; iRow++)
+				{
+					float error = fabsf(fast[iColumn][iRow] - generic[iColumn][iRow]) /
+						(1.0f + fabsf(generic[iColumn][iRow]));
+					maxError = std::max(maxError, error);
+				}
+			}
+		}
+
+		return maxError;
+	}
+
+	glm::mat4 AffineInverse(const glm::mat4 &theMatrix) {return glm::affineInverse(theMatrix);}
+	glm::mat4 RigidInverse(const glm::mat4 &theMatrix) {return glm::rigidInverse(theMatrix);}
+
+	//Like Bench::CountDifferences, but names the operation and matrix of each difference.
+	int CountDifferences(const std::vector<float> &results, const std::vector<float> &expected)
+	{
+		const char *opNames[] = {"multiply", "transform", "transpose", "determinant", "inverse"};
+		const int opSizes[] = {16, 4, 16, 1, 16};
+		const int iResultsPerMatrix = 53;
+
+		int numDifferences = 0;
+		for(size_t iResult = 0; iResult < results.size(); iResult++)
+		{
+			if(Bench::SameResult(results[iResult], expected[iResult]))
+				continue;
+
+			if(numDifferences < 10)
+			{
+				int iOffset = (int)(iResult % iResultsPerMatrix);
+				int iOp = 0;
+				while(iOffset >= opSizes[iOp])
+					iOffset -= opSizes[iOp++];
+
+				printf("DIFFERENT: %s of matrix %d, value %d: %.9g, was %.9g\n", opNames[iOp],
+					(int)(iResult / iResultsPerMatrix), iOffset, results[iResult], expected[iResult]);
+			}
+			numDifferences++;
+		}
+
+		return numDifferences;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int iNumIterations = 2000;
+	std::string strWriteFile;
+	std::string strCheckFile;
+
+	for(int iArg = 1; iArg < argc; iArg++)
+	{
+		std::string strArg = argv[iArg];
+		bool bHasValue = iArg + 1 < argc;
+		if(strArg == "-iterations" && bHasValue)
+			iNumIterations = atoi(argv[++iArg]);
+		else if(strArg == "-write" && bHasValue)
+			strWriteFile = argv[++iArg];
+		else if(strArg == "-check" && bHasValue)
+			strCheckFile = argv[++iArg];
+		else
+		{
+			printf("Usage: GlmMatrixBench [-iterations <n>] [-write <file>] [-check <file>]\n");
+			return 1;
+		}
+	}
+
+	TestData data;
+	MakeTestData(data);
+	std::vector<float> results = ComputeResults(data);
+
+	if(!strWriteFile.empty())
+	{
+		if(!Bench::WriteResults(strWriteFile, results))
+		{
+			printf("Could not write the output file: %s\n", strWriteFile.c_str());
+			return 1;
+		}
+	}
+
+	int numDifferences = 0;
+	if(!strCheckFile.empty())
+	{
+		std::vector<float> expected(results.size());
+		if(!Bench::ReadResults(strCheckFile, expected))
+		{
+			printf("Could not read the results file: %s\n", strCheckFile.c_str());
+			return 1;
+		}
+
+		numDifferences = CountDifferences(results, expected);
+		printf("%d of %d results differ\n", numDifferences, (int)results.size());
+	}
+
+	float affineError = MaxInverseError(data.affine, AffineInverse);
+	float rigidError = MaxInverseError(data.rigid, RigidInverse);
+	printf("affineInverse: largest difference from inverse %g\n", affineError);
+	printf("rigidInverse: largest difference from inverse %g\n", rigidError);
+	bool bInversesAccurate = affineError <= g_fMaxInverseError && rigidError <= g_fMaxInverseError;
+
+	printf("glm %s, per operation:\n", GetArchName());
+	TimeOp("mat4 * mat4", iNumIterations, data, MultiplyOp);
+	TimeOp("mat4 * vec4", iNumIterations, data, TransformOp);
+	TimeOp("transpose", iNumIterations, data, TransposeOp);
+	TimeOp("determinant", iNumIterations, data, DeterminantOp);
+	TimeOp("inverse", iNumIterations, data, InverseOp);
+	TimeOp("affineInverse", iNumIterations, data, AffineInverseOp);
+	TimeOp("rigidInverse", iNumIterations, data, RigidInverseOp);
+
+	return numDifferences == 0 && bInversesAccurate ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Checks that the array versions of glm::detail::toFloat16 and toFloat32 give the same bits as the
+//scalar ones, for every half and every float, and times both on vertex-like data.
+//
+//Usage: HalfConvertBench [-iterations <n>] [-nocheck]
+//	-iterations <n>		Number of passes over the test data to time. The default is 200.
+//	-nocheck			Skip checking all 2^32 floats, which takes a while.
+//
+//The exit code is 0 if nothing differed, and 1 otherwise.
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <glm/glm.hpp>
+#include "BenchCommon.h"
+
+namespace
+{
+	const char *GetArchName()
+	{
+#if(defined(GLM_INTRINSIC_F16C))
+		return "F16C";
+#elif((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+		return "SSE2";
+#else
+		return "pure";
+#endif
+	}
+
+	unsigned int FloatBits(float value)
+	{
+		unsigned int bits;
+		memcpy(&bits, &value, sizeof(float));
+		return bits;
+	}
+
+	float BitsFloat(unsigned int bits)
+	{
+		float value;
+		memcpy(&value, &bits, sizeof(float));
+		return value;
+	}
+
+	int CheckAllHalves()
+	{
+		std::vector<glm::detail::hdata> halves(65536);
+		for(int iHalf = 0; iHalf < 65536; iHalf++)
+			halves[iHalf] = (glm::detail::hdata)iHalf;
+
+		std::vector<float> floats(halves.size());
+		glm::detail::toFloat32(&halves[0], &floats[0], halves.size());
+
+		int numDifferences = 0;
+		for(int iHalf = 0; iHalf < 65536; iHalf++)
+		{
+			unsigned int expected = FloatBits(glm::detail::toFloat32(halves[iHalf]));
+			if(FloatBits(floats[iHalf]) == expected)
+				continue;
+
+			if(numDifferences < 10)
+				printf("DIFFERENT: half %04x gave %08x, not %08x\n", iHalf, FloatBits(floats[iHalf]), expected);
+			numDifferences++;
+		}
+
+		return numDifferences;
+	}
+
+	int CheckAllFloats()
+	{
+		//Odd-sized blocks, so the scalar tail is also tested.
+		const unsigned int blockSize = (1 << 20) + 3;
+		std::vector<float> floats(blockSize);
+		std::vector<glm::detail::hdata> halves(blockSize);
+
+		int numDifferences = 0;
+		unsigned long long first = 0;
+		while(first < (1ULL << 32))
+		{
+			unsigned int count = (unsigned int)std::min((unsigned long long)blockSize, (1ULL << 32) - first);
+			for(unsigned int iFloat = 0; iFloat < count; iFloat++)
+				floats[iFloat] = BitsFloat((unsigned int)(first + iFloat));
+
+			glm::detail::toFloat16(&floats[0], &halves[0], count);
+			for(unsigned int iFloat = 0; iFloat < count; iFloat++)
+			{
+				glm::detail::hdata expected = glm::detail::toFloat16(floats[iFloat]);
+				if(halves[iFloat] == expected)
+					continue;
+
+				if(numDifferences < 10)
+				{
+					printf("DIFFERENT: float %08x gave %04x, not %04x\n", FloatBits(floats[iFloat]),
+						(unsigned short)halves[iFloat], (unsigned short)expected);
+				}
+				numDifferences++;
+			}
+
+			first += count;
+		}
+
+		return numDifferences;
+	}
+
+	//Mostly unit-range values, like normals and texture coordinates, with some zeros.
+	std::vector<float> MakeTestFloats()
+	{
+		std::vector<float> floats(1 << 20);
+		for(size_t iFloat = 0; iFloat < floats.size(); iFloat++)
+		{
+			float value = Bench::RandomFloat(-1.0f, 1.0f);
+			floats[iFloat] = (iFloat % 7 == 0) ? 0.0f : value;
+		}
+
+		return floats;
+	}
+
+	void TimeConversions(int iNumIterations)
+	{
+		std::vector<float> floats = MakeTestFloats();
+		std::vector<glm::detail::hdata> halves(floats.size());
+		std::vector<float> results(floats.size());
+		float checksum = 0.0f;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			for(size_t iFloat = 0; iFloat < floats.size(); iFloat++)
+				halves[iFloat] = glm::detail::toFloat16(floats[iFloat]);
+			checksum += halves[iIteration % halves.size()];
+		}
+		Bench::PrintTime("toFloat16", start, iNumIterations, floats.size(), checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			glm::detail::toFloat16(&floats[0], &halves[0], floats.size());
+			checksum += halves[iIteration % halves.size()];
+		}
+		Bench::PrintTime("array", start, iNumIterations, floats.size(), checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			for(size_t iHalf = 0; iHalf < halves.size(); iHalf++)
+				results[iHalf] = glm::detail::toFloat32(halves[iHalf]);
+			checksum += results[iIteration % results.size()];
+		}
+		Bench::PrintTime("toFloat32", start, iNumIterations, halves.size(), checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			glm::detail::toFloat32(&halves[0], &results[0], halves.size());
+			checksum += results[iIteration % results.size()];
+		}
+		Bench::PrintTime("array", start, iNumIterations, halves.size(), checksum);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int iNumIterations = 200;
+	bool bCheckFloats = true;
+
+	for(int iArg = 1; iArg < argc; iArg++)
+	{
+		std::string strArg = argv[iArg];
+		if(strArg == "-iterations" && iArg + 1 < argc)
+			iNumIterations = atoi(argv[++iArg]);
+		else if(strArg == "-nocheck")
+			bCheckFloats = false;
+		else
+		{
+			printf("Usage: HalfConvertBench [-iterations <n>] [-nocheck]\n");
+			return 1;
+		}
+	}
+
+	int numDifferences = CheckAllHalves();
+	printf("halves to floats: %d of 65536 differ\n", numDifferences);
+
+	if(bCheckFloats)
+	{
+		int numFloatDifferences = CheckAllFloats();
+		printf("floats to halves: %d of 2^32 differ\n", numFloatDifferences);
+		numDifferences += numFloatDifferences;
+	}
+
+	printf("glm %s, per value:\n", GetArchName());
+	TimeConversions(iNumIterations);
+
+	return numDifferences == 0 ? 0 : 1;
+}
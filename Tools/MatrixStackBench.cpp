@@ -0,0 +1,67 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Times glutil::MatrixStack against Framework::InlineMatrixStack, the way the tutorials use them:
+//a new stack for each frame, then a push, translate, scale and pop for each object.
+//
+//Usage: MatrixStackBench [frames]
+//	frames		Number of frames to time. The default is 100000.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <glload/gl_3_3.h>
+#include <glutil/glutil.h>
+#include <glm/glm.hpp>
+#include "../framework/FixedMatrixStack.h"
+#include "BenchCommon.h"
+
+namespace
+{
+	const int g_iObjectsPerFrame = 64;
+
+	//Each frame adds to the sum, so the work cannot be optimized out.
+	template<typename Stack, typename Push>
+	double TimeFrames(int iNumFrames, float &sum)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(int iFrame = 0; iFrame < iNumFrames; iFrame++)
+		{
+			Stack modelMatrix;
+			for(int iObject = 0; iObject < g_iObjectsPerFrame; iObject++)
+			{
+				Push push(modelMatrix);
+				modelMatrix.Translate(glm::vec3((float)iObject, 0.5f, (float)iFrame));
+				modelMatrix.Scale(glm::vec3(1.0f, 2.0f, 1.0f));
+				sum += modelMatrix.Top()[3].x;
+			}
+		}
+
+		return Bench::SecondsSince(start);
+	}
+
+	void Report(const char *strName, double seconds, int iNumFrames)
+	{
+		printf("%-24s %8.2f ms total, %6.2f ns per push/translate/scale/pop\n", strName, seconds * 1000.0,
+			seconds * 1.0e9 / ((double)iNumFrames * g_iObjectsPerFrame));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int iNumFrames = argc > 1 ? atoi(argv[1]) : 100000;
+	if(iNumFrames <= 0)
+	{
+		printf("Usage: MatrixStackBench [frames]\n");
+		return 1;
+	}
+
+	float sum = 0.0f;
+	double glutilSeconds = TimeFrames<glutil::MatrixStack, glutil::PushStack>(iNumFrames, sum);
+	double inlineSeconds = TimeFrames<Framework::InlineMatrixStack<8>, Framework::PushStack>(iNumFrames, sum);
+
+	Report("glutil::MatrixStack", glutilSeconds, iNumFrames);
+	Report("InlineMatrixStack<8>", inlineSeconds, iNumFrames);
+	printf("(checksum %g)\n", sum);
+	return 0;
+}
@@ -0,0 +1,237 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Reports statistics for mesh files, and checks them against a baseline. Nothing here needs an
+//OpenGL context, so it can run headless as part of an automated build.
+//
+//Usage: MeshStats [options] <mesh files>
+//	-cache <n>			Post-transform cache size to simulate. The default is 16.
+//	-strips				Load with MESH_GENERATE_STRIPS.
+//	-clusters			Load with MESH_BUILD_CLUSTERS.
+//	-weld				Load with MESH_WELD_VERTICES.
+//	-baseline <file>	Fail if any metric is worse than in this file.
+//	-write <file>		Write the metrics to this file, for use with -baseline.
+//
+//The exit code is 0 if every file loaded and nothing regressed, and 1 otherwise.
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <exception>
+#include <glload/gl_3_3.h>
+#include "../framework/Mesh.h"
+#include "../framework/MeshGeometry.h"
+#include "../framework/MeshStats.h"
+
+namespace
+{
+	struct Metric
+	{
+		const char *strName;
+		double value;
+	};
+
+	//The metrics checked against the baseline. For all of them, lower is better.
+	std::vector<Metric> GetMetrics(const Framework::MeshStats &stats)
+	{
+		size_t iAttribBytes = 0;
+		for(size_t iAttrib = 0; iAttrib < stats.attribBytes.size(); iAttrib++)
+			iAttribBytes += stats.attribBytes[iAttrib];
+
+		Metric metrics[] =
+		{
+			{"attrib_bytes",			(double)iAttribBytes},
+			{"index_bytes",				(double)stats.iIndexBytes},
+			{"draw_cmds",				(double)stats.iNumDrawCmds},
+			{"unreferenced_vertices",	(double)stats.iUnreferencedVertices},
+			{"degenerate_triangles",	(double)stats.iDegenerateTriangles},
+			{"duplicate_triangles",		(double)stats.iDuplicateTriangles},
+			{"acmr",					stats.fAcmr},
+			{"fetch_bytes_per_draw",	(double)stats.iFetchBytesPerDraw},
+		};
+
+		return std::vector<Metric>(metrics, metrics + sizeof(metrics) / sizeof(metrics[0]));
+	}
+
+	void PrintStats(const std::string &strFilename, const Framework::MeshGeometry &geom,
+		const Framework::MeshStats &stats)
+	{
+		printf("%s\n", strFilename.c_str());
+		printf("\tvertices: %d, indices: %d, triangles: %d, draw commands: %d\n", (int)stats.iNumVertices,
+			(int)stats.iNumIndices, (int)stats.iNumTriangles, (int)stats.iNumDrawCmds);
+
+		for(size_t iAttrib = 0; iAttrib < geom.attribs.size(); iAttrib++)
+		{
+			printf("\tattribute %d: %d bytes per vertex, %d bytes\n", (int)geom.attribs[iAttrib].iAttribIx,
+				(int)geom.attribs[iAttrib].VertexBytes(), (int)stats.attribBytes[iAttrib]);
+		}
+		printf("\tindex buffer: %d bytes\n", (int)stats.iIndexBytes);
+
+		printf("\tunreferenced vertices: %d\n", (int)stats.iUnreferencedVertices);
+		printf("\tdegenerate triangles: %d, duplicate triangles: %d\n", (int)stats.iDegenerateTriangles,
+			(int)stats.iDuplicateTriangles);
+		printf("\tcache misses: %d, miss ratio: %.3f, ACMR: %.3f\n", (int)stats.iCacheMisses,
+			stats.fCacheMissRatio, stats.fAcmr);
+		printf("\tfetch per draw: %d bytes\n", (int)stats.iFetchBytesPerDraw);
+	}
+
+	typedef std::map<std::string, std::map<std::string, double> > Baseline;
+
+	//Each line is a metric name, its value, and the mesh filename, which may contain spaces.
+	bool ReadBaseline(const std::string &strFilename, Baseline &baseline)
+	{
+		FILE *pFile = fopen(strFilename.c_str(), "r");
+		if(!pFile)
+			return false;
+
+		char line[1024];
+		while(fgets(line, sizeof(line), pFile))
+		{
+			char strMetric[64];
+			double value = 0.0;
+			int iNameStart = 0;
+			if(sscanf(line, "%63s %lf %n", strMetric, &value, &iNameStart) < 2 || iNameStart == 0)
+				continue;
+
+			std::string strMesh(line + iNameStart);
+			while(!strMesh.empty() && (strMesh[strMesh.size() - 1] == '\n' || strMesh[strMesh.size() - 1] == '\r'))
+				strMesh.erase(strMesh.size() - 1);
+
+			baseline[strMesh][strMetric] = value;
+		}
+
+		fclose(pFile);
+		return true;
+	}
+
+	//Returns the number of metrics that got worse.
+	int CompareToBaseline(const std::string &strFilename, const std::vector<Metric> &metrics,
+		const Baseline &baseline)
+	{
+		Baseline::const_iterator meshIt = baseline.find(strFilename);
+		if(meshIt == baseline.end())
+		{
+			printf("\tnot in the baseline\n");
+			return 0;
+		}
+
+		int numRegressions = 0;
+		for(size_t iMetric = 0; iMetric < metrics.size(); iMetric++)
+		{
+			std::map<std::string, double>::const_iterator valueIt = meshIt->second.find(metrics[iMetric].strName);
+			if(valueIt == meshIt->second.end())
+				continue;
+
+			//Allow for the rounding of the baseline file.
+			double limit = valueIt->second + fabs(valueIt->second) * 1e-5 + 1e-5;
+			if(metrics[iMetric].value > limit)
+			{
+				printf("\tREGRESSION: %s is %g, was %g\n", metrics[iMetric].strName,
+					metrics[iMetric].value, valueIt->second);
+				numRegressions++;
+			}
+		}
+
+		return numRegressions;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	size_t cacheSize = 16;
+	unsigned int loadFlags = 0;
+	std::string strBaselineFile;
+	std::string strWriteFile;
+	std::vector<std::string> meshFiles;
+
+	for(int iArg = 1; iArg < argc; iArg++)
+	{
+		std::string strArg = argv[iArg];
+		bool bHasValue = iArg + 1 < argc;
+		if(strArg == "-cache" && bHasValue)
+			cacheSize = (size_t)atoi(argv[++iArg]);
+		else if(strArg == "-strips")
+			loadFlags |= Framework::MESH_GENERATE_STRIPS;
+		else if(strArg == "-clusters")
+			loadFlags |= Framework::MESH_BUILD_CLUSTERS;
+		else if(strArg == "-weld")
+			loadFlags |= Framework::MESH_WELD_VERTICES;
+		else if(strArg == "-baseline" && bHasValue)
+			strBaselineFile = argv[++iArg];
+		else if(strArg == "-write" && bHasValue)
+			strWriteFile = argv[++iArg];
+		else if(!strArg.empty() && strArg[0] == '-')
+		{
+			printf("Unknown option: %s\n", strArg.c_str());
+			return 1;
+		}
+		else
+			meshFiles.push_back(strArg);
+	}
+
+	if(meshFiles.empty())
+	{
+		printf("Usage: MeshStats [-cache <n>] [-strips] [-clusters] [-weld] [-baseline <file>] [-write <file>]\n"
+			"\t<mesh files>\n");
+		return 1;
+	}
+
+	Baseline baseline;
+	if(!strBaselineFile.empty() && !ReadBaseline(strBaselineFile, baseline))
+	{
+		printf("Could not open the baseline file: %s\n", strBaselineFile.c_str());
+		return 1;
+	}
+
+	FILE *pWriteFile = NULL;
+	if(!strWriteFile.empty())
+	{
+		pWriteFile = fopen(strWriteFile.c_str(), "w");
+		if(!pWriteFile)
+		{
+			printf("Could not open the output file: %s\n", strWriteFile.c_str());
+			return 1;
+		}
+	}
+
+	int numFailures = 0;
+	for(size_t iFile = 0; iFile < meshFiles.size(); iFile++)
+	{
+		Framework::MeshGeometry geom;
+		try
+		{
+			Framework::LoadMeshGeometryFromPath(meshFiles[iFile], geom);
+			Framework::ProcessMeshGeometry(meshFiles[iFile], loadFlags, geom);
+		}
+		catch(std::exception &except)
+		{
+			printf("%s\n\tFAILED: %s\n", meshFiles[iFile].c_str(), except.what());
+			numFailures++;
+			continue;
+		}
+
+		Framework::MeshStats stats;
+		Framework::CalcMeshStats(geom, cacheSize, stats);
+		PrintStats(meshFiles[iFile], geom, stats);
+
+		std::vector<Metric> metrics = GetMetrics(stats);
+		if(!strBaselineFile.empty())
+			numFailures += CompareToBaseline(meshFiles[iFile], metrics, baseline);
+
+		if(pWriteFile)
+		{
+			for(size_t iMetric = 0; iMetric < metrics.size(); iMetric++)
+				fprintf(pWriteFile, "%s %.9g %s\n", metrics[iMetric].strName, metrics[iMetric].value,
+					meshFiles[iFile].c_str());
+		}
+	}
+
+	if(pWriteFile)
+		fclose(pWriteFile);
+
+	return numFailures ? 1 : 0;
+}
@@ -0,0 +1,248 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Checks that Framework::SimplexNoise gives the same values from its single and batch functions,
+//and for any number of threads, and times them in millions of samples per second.
+//
+//Usage: NoiseBench [options]
+//	-iterations <n>		Number of passes over the test data to time. The default is 20.
+//	-threads <n>		Threads for the threaded timings. The default is 0, one per core.
+//	-write <file>		Write the results for the test data to this file.
+//	-check <file>		Fail if any result differs from the ones in this file.
+//
+//To check that the SSE2 code gives the same values as the scalar code, build this once with
+//GLM_FORCE_PURE and run it with -write, then build it normally and run it with -check.
+//
+//The exit code is 0 if nothing differed, and 1 otherwise.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <glm/glm.hpp>
+#include "../framework/SimplexNoise.h"
+#include "BenchCommon.h"
+
+namespace
+{
+	//Not a multiple of 4, so that the partial blocks are tested.
+	const size_t g_numPoints = 65539;
+	const int g_gridWidth = 1027;
+	const int g_gridHeight = 259;
+	const int g_numOctaves = 5;
+
+	struct TestData
+	{
+		std::vector<glm::vec2> points2;
+		std::vector<glm::vec3> points3;
+		glm::vec2 gridOrigin;
+		float gridSpacing;
+	};
+
+	//Negative and positive, and past 256, so that the flooring and wrapping are tested.
+	void MakeTestData(TestData &data)
+	{
+		for(size_t iPoint = 0; iPoint < g_numPoints; iPoint++)
+		{
+			data.points2.push_back(glm::vec2(Bench::RandomFloat(-300.0f, 300.0f),
+				Bench::RandomFloat(-300.0f, 300.0f)));
+			data.points3.push_back(glm::vec3(Bench::RandomFloat(-300.0f, 300.0f),
+				Bench::RandomFloat(-300.0f, 300.0f), Bench::RandomFloat(-300.0f, 300.0f)));
+		}
+
+		data.gridOrigin = glm::vec2(-37.25f, -11.5f);
+		data.gridSpacing = 0.0625f;
+	}
+
+	//Checks the batch functions against the single ones, and returns every batch result.
+	int CheckBatches(const Framework::SimplexNoise &noise, const TestData &data, std::vector<float> &results)
+	{
+		std::vector<float> expected2(g_numPoints);
+		std::vector<float> expected3(g_numPoints);
+		for(size_t iPoint = 0; iPoint < g_numPoints; iPoint++)
+		{
+			expected2[iPoint] = noise.Noise(data.points2[iPoint]);
+			expected3[iPoint] = noise.Noise(data.points3[iPoint]);
+		}
+
+		std::vector<float> batch2(g_numPoints);
+		std::vector<float> batch3(g_numPoints);
+		noise.Noise(&data.points2[0], &batch2[0], g_numPoints, 3);
+		noise.Noise(&data.points3[0], &batch3[0], g_numPoints, 3);
+
+		int numDifferences = Bench::CountDifferences("2D point", batch2, expected2);
+		numDifferences += Bench::CountDifferences("3D point", batch3, expected3);
+
+		//One octave must give the same values as the single function at the grid points.
+		std::vector<float> expectedGrid(g_gridWidth * g_gridHeight);
+		for(int iRow = 0; iRow < g_gridHeight; iRow++)
+		{
+			for(int iColumn = 0; iColumn < g_gridWidth; iColumn++)
+			{
+				glm::vec2 point = data.gridOrigin + data.gridSpacing * glm::vec2(iColumn, iRow);
+				expectedGrid[iRow * g_gridWidth + iColumn] = noise.Noise(point);
+			}
+		}
+
+		std::vector<float> grid(expectedGrid.size());
+		noise.Grid(data.gridOrigin, data.gridSpacing, g_gridWidth, g_gridHeight, 1, &grid[0], 3);
+		numDifferences += Bench::CountDifferences("grid sample", grid, expectedGrid);
+
+		//More octaves must not depend on the number of threads.
+		std::vector<float> fractal(expectedGrid.size());
+		std::vector<float> threadedFractal(expectedGrid.size());
+		noise.Grid(data.gridOrigin, data.gridSpacing, g_gridWidth, g_gridHeight, g_numOctaves, &fractal[0], 1);
+		noise.Grid(data.gridOrigin, data.gridSpacing, g_gridWidth, g_gridHeight, g_numOctaves,
+			&threadedFractal[0], 5);
+		numDifferences += Bench::CountDifferences("threaded octave sample", threadedFractal, fractal);
+
+		float maxValue = 0.0f;
+		for(size_t iPoint = 0; iPoint < g_numPoints; iPoint++)
+			maxValue = std::max(maxValue, std::max(fabsf(batch2[iPoint]), fabsf(batch3[iPoint])));
+		printf("largest value: %g\n", maxValue);
+
+		results.insert(results.end(), batch2.begin(), batch2.end());
+		results.insert(results.end(), batch3.begin(), batch3.end());
+		results.insert(results.end(), fractal.begin(), fractal.end());
+		return numDifferences;
+	}
+
+	void TimeNoise(const Framework::SimplexNoise &noise, const TestData &data, int iNumIterations,
+		unsigned int numThreads)
+	{
+		std::vector<float> results(g_numPoints);
+		std::vector<float> grid(g_gridWidth * g_gridHeight);
+		float checksum = 0.0f;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			for(size_t iPoint = 0; iPoint < g_numPoints; iPoint++)
+				results[iPoint] = noise.Noise(data.points2[iPoint]);
+			checksum += results[iIteration % g_numPoints];
+		}
+		Bench::PrintRate("2D single", start, iNumIterations, g_numPoints, checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			noise.Noise(&data.points2[0], &results[0], g_numPoints, 1);
+			checksum += results[iIteration % g_numPoints];
+		}
+		Bench::PrintRate("2D batch", start, iNumIterations, g_numPoints, checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			noise.Noise(&data.points2[0], &results[0], g_numPoints, numThreads);
+			checksum += results[iIteration % g_numPoints];
+		}
+		Bench::PrintRate("2D batch, threaded", start, iNumIterations, g_numPoints, checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			for(size_t iPoint = 0; iPoint < g_numPoints; iPoint++)
+				results[iPoint] = noise.Noise(data.points3[iPoint]);
+			checksum += results[iIteration % g_numPoints];
+		}
+		Bench::PrintRate("3D single", start, iNumIterations, g_numPoints, checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			noise.Noise(&data.points3[0], &results[0], g_numPoints, 1);
+			checksum += results[iIteration % g_numPoints];
+		}
+		Bench::PrintRate("3D batch", start, iNumIterations, g_numPoints, checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			noise.Noise(&data.points3[0], &results[0], g_numPoints, numThreads);
+			checksum += results[iIteration % g_numPoints];
+		}
+		Bench::PrintRate("3D batch, threaded", start, iNumIterations, g_numPoints, checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			noise.Grid(data.gridOrigin, data.gridSpacing, g_gridWidth, g_gridHeight, 1, &grid[0], 1);
+			checksum += grid[iIteration % grid.size()];
+		}
+		Bench::PrintRate("grid", start, iNumIterations, grid.size(), checksum);
+
+		start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+		{
+			noise.Grid(data.gridOrigin, data.gridSpacing, g_gridWidth, g_gridHeight, 1, &grid[0], numThreads);
+			checksum += grid[iIteration % grid.size()];
+		}
+		Bench::PrintRate("grid, threaded", start, iNumIterations, grid.size(), checksum);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int iNumIterations = 20;
+	unsigned int numThreads = 0;
+	std::string strWriteFile;
+	std::string strCheckFile;
+
+	for(int iArg = 1; iArg < argc; iArg++)
+	{
+		std::string strArg = argv[iArg];
+		bool bHasValue = iArg + 1 < argc;
+		if(strArg == "-iterations" && bHasValue)
+			iNumIterations = atoi(argv[++iArg]);
+		else if(strArg == "-threads" && bHasValue)
+			numThreads = (unsigned int)atoi(argv[++iArg]);
+		else if(strArg == "-write" && bHasValue)
+			strWriteFile = argv[++iArg];
+		else if(strArg == "-check" && bHasValue)
+			strCheckFile = argv[++iArg];
+		else
+		{
+			printf("Usage: NoiseBench [-iterations <n>] [-threads <n>] [-write <file>] [-check <file>]\n");
+			return 1;
+		}
+	}
+
+	TestData data;
+	MakeTestData(data);
+	Framework::SimplexNoise noise(1234);
+
+	std::vector<float> results;
+	int numDifferences = CheckBatches(noise, data, results);
+	printf("batch against single: %d differ\n", numDifferences);
+
+	if(!strWriteFile.empty())
+	{
+		if(!Bench::WriteResults(strWriteFile, results))
+		{
+			printf("Could not write the output file: %s\n", strWriteFile.c_str());
+			return 1;
+		}
+	}
+
+	if(!strCheckFile.empty())
+	{
+		std::vector<float> expected(results.size());
+		if(!Bench::ReadResults(strCheckFile, expected))
+		{
+			printf("Could not read the results file: %s\n", strCheckFile.c_str());
+			return 1;
+		}
+
+		int numFileDifferences = Bench::CountDifferences("result", results, expected);
+		printf("%d of %d results differ from the file\n", numFileDifferences, (int)results.size());
+		numDifferences += numFileDifferences;
+	}
+
+	TimeNoise(noise, data, iNumIterations, numThreads);
+
+	return numDifferences == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Checks that the array versions of glm's pack and unpack functions give the same bits as the
+//scalar ones, and times both.
+//
+//Usage: PackingBench [-iterations <n>]
+//	-iterations <n>		Number of passes over the test data to time. The default is 200.
+//
+//The packing is tested on values in and out of range, infinities and NaN. The unpacking is
+//tested on random bits. The exit code is 0 if nothing differed, and 1 otherwise.
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <glm/glm.hpp>
+#include "BenchCommon.h"
+
+namespace
+{
+	//Not a multiple of 4, so that the scalar tails are tested.
+	const size_t g_numElements = 262147;
+
+	unsigned int RandomBits()
+	{
+		unsigned int random = Bench::NextRandom();
+		return (random >> 16) | (random & 0xffff0000);
+	}
+
+	//Mostly in [-1.5, 1.5], with exact steps and special values mixed in.
+	float RandomComponent()
+	{
+		unsigned int bits = RandomBits();
+		switch(bits % 16)
+		{
+		case 0: return (int)(bits >> 8) % 1024 / 1023.0f;
+		case 1: return (int)(bits >> 8) % 1024 / -511.0f + 0.5f / 511.0f;
+		case 2: return (bits & 0x100) ? -0.0f : 0.0f;
+		case 3: return ((bits & 0x100) ? -1.0f : 1.0f) * (1.0f + (bits >> 20));
+		case 4: return (bits & 0x100) ? -INFINITY : INFINITY;
+		case 5: return NAN;
+		}
+
+		return (bits >> 8) / 5592405.0f - 1.5f;
+	}
+
+	struct TestData
+	{
+		std::vector<glm::vec2> vec2s;
+		std::vector<glm::vec4> vec4s;
+		std::vector<glm::uint> packed;
+	};
+
+	void MakeTestData(TestData &data)
+	{
+		for(size_t iElement = 0; iElement < g_numElements; iElement++)
+		{
+			data.vec2s.push_back(glm::vec2(RandomComponent(), RandomComponent()));
+			data.vec4s.push_back(glm::vec4(RandomComponent(), RandomComponent(), RandomComponent(),
+				RandomComponent()));
+			data.packed.push_back(RandomBits());
+		}
+	}
+
+	//The scalar loop and the array version, for one format in one direction.
+	template<typename In, typename Out>
+	struct Conversion
+	{
+		Out (*Scalar)(const In &);
+		void (*Array)(const In *, Out *, size_t);
+
+		//Returns the number of differences, and stores the times per element.
+		int Run(const std::vector<In> &input, int iNumIterations, double times[2]) const
+		{
+			std::vector<Out> expected(input.size());
+			std::vector<Out> output(input.size());
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+			{
+				for(size_t iElement = 0; iElement < input.size(); iElement++)
+					expected[iElement] = Scalar(input[iElement]);
+			}
+			times[0] = Bench::SecondsSince(start) * 1.0e9 / ((double)iNumIterations * input.size());
+
+			start = std::chrono::steady_clock::now();
+			for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+				Array(&input[0], &output[0], input.size());
+			times[1] = Bench::SecondsSince(start) * 1.0e9 / ((double)iNumIterations * input.size());
+
+			int numDifferences = 0;
+			for(size_t iElement = 0; iElement < input.size(); iElement++)
+			{
+				if(memcmp(&expected[iElement], &output[iElement], sizeof(Out)) != 0)
+					numDifferences++;
+			}
+
+			return numDifferences;
+		}
+	};
+
+	template<typename Vec>
+	int TestFormat(const char *strName, const Conversion<Vec, glm::uint> &pack,
+		const Conversion<glm::uint, Vec> &unpack, const std::vector<Vec> &values,
+		const std::vector<glm::uint> &packed, int iNumIterations)
+	{
+		double packTimes[2];
+		double unpackTimes[2];
+		int numDifferences = pack.Run(values, iNumIterations, packTimes);
+		numDifferences += unpack.Run(packed, iNumIterations, unpackTimes);
+
+		printf("%-14s %7.2f %7.2f %7.2f %7.2f   %d differ\n", strName, packTimes[0], packTimes[1],
+			unpackTimes[0], unpackTimes[1], numDifferences);
+		return numDifferences;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int iNumIterations = 200;
+	for(int iArg = 1; iArg < argc; iArg++)
+	{
+		std::string strArg = argv[iArg];
+		if(strArg == "-iterations" && iArg + 1 < argc)
+			iNumIterations = atoi(argv[++iArg]);
+		else
+		{
+			printf("Usage: PackingBench [-iterations <n>]\n");
+			return 1;
+		}
+	}
+
+	TestData data;
+	MakeTestData(data);
+
+	Conversion<glm::vec2, glm::uint> packUnorm2x16 = {glm::packUnorm2x16, glm::packUnorm2x16};
+	Conversion<glm::vec2, glm::uint> packSnorm2x16 = {glm::packSnorm2x16, glm::packSnorm2x16};
+	Conversion<glm::vec2, glm::uint> packHalf2x16 = {glm::packHalf2x16, glm::packHalf2x16};
+	Conversion<glm::vec4, glm::uint> packUnorm4x8 = {glm::packUnorm4x8, glm::packUnorm4x8};
+	Conversion<glm::vec4, glm::uint> packSnorm4x8 = {glm::packSnorm4x8, glm::packSnorm4x8};
+	Conversion<glm::vec4, glm::uint> packUnorm3x10_1x2 = {glm::packUnorm3x10_1x2, glm::packUnorm3x10_1x2};
+	Conversion<glm::vec4, glm::uint> packSnorm3x10_1x2 = {glm::packSnorm3x10_1x2, glm::packSnorm3x10_1x2};
+
+	Conversion<glm::uint, glm::vec2> unpackUnorm2x16 = {glm::unpackUnorm2x16, glm::unpackUnorm2x16};
+	Conversion<glm::uint, glm::vec2> unpackSnorm2x16 = {glm::unpackSnorm2x16, glm::unpackSnorm2x16};
+	Conversion<glm::uint, glm::vec2> unpackHalf2x16 = {glm::unpackHalf2x16, glm::unpackHalf2x16};
+	Conversion<glm::uint, glm::vec4> unpackUnorm4x8 = {glm::unpackUnorm4x8, glm::unpackUnorm4x8};
+	Conversion<glm::uint, glm::vec4> unpackSnorm4x8 = {glm::unpackSnorm4x8, glm::unpackSnorm4x8};
+	Conversion<glm::uint, glm::vec4> unpackUnorm3x10_1x2 = {glm::unpackUnorm3x10_1x2, glm::unpackUnorm3x10_1x2};
+	Conversion<glm::uint, glm::vec4> unpackSnorm3x10_1x2 = {glm::unpackSnorm3x10_1x2, glm::unpackSnorm3x10_1x2};
+
+	printf("ns per element  pack   array  unpack   array\n");
+	int numDifferences = 0;
+	numDifferences += TestFormat("Unorm2x16", packUnorm2x16, unpackUnorm2x16, data.vec2s, data.packed, iNumIterations);
+	numDifferences += TestFormat("Snorm2x16", packSnorm2x16, unpackSnorm2x16, data.vec2s, data.packed, iNumIterations);
+	numDifferences += TestFormat("Half2x16", packHalf2x16, unpackHalf2x16, data.vec2s, data.packed, iNumIterations);
+	numDifferences += TestFormat("Unorm4x8", packUnorm4x8, unpackUnorm4x8, data.vec4s, data.packed, iNumIterations);
+	numDifferences += TestFormat("Snorm4x8", packSnorm4x8, unpackSnorm4x8, data.vec4s, data.packed, iNumIterations);
+	numDifferences += TestFormat("Unorm3x10_1x2", packUnorm3x10_1x2, unpackUnorm3x10_1x2, data.vec4s,
+		data.packed, iNumIterations);
+	numDifferences += TestFormat("Snorm3x10_1x2", packSnorm3x10_1x2, unpackSnorm3x10_1x2, data.vec4s,
+		data.packed, iNumIterations);
+
+	return numDifferences == 0 ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+//Times the batch quaternion functions against glm on one quaternion at a time, and checks them.
+//MultiplyQuats, QuatsToMatrices and QuatsToRows3x4 must match glm exactly. SlerpQuats is compared
+//with a slerp done in doubles, and NlerpQuats with SlerpQuats for small steps.
+//
+//Usage: QuatBatchBench [-iterations <n>]
+//	-iterations <n>		Number of passes over the test quaternions to time. The default is 500.
+//
+//The exit code is 0 if every check passed, and 1 otherwise.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "../framework/BatchQuaternion.h"
+#include "BenchCommon.h"
+
+namespace
+{
+	//Not a multiple of 4, so that the partial blocks are tested.
+	const size_t g_numQuats = 16383;
+
+	//The largest errors the header documents, in radians and in length.
+	const double g_maxSlerpError = 1.0e-6;
+	const double g_maxUnitError = 1.0e-6;
+	const double g_maxNlerpError = 1.0e-4;
+
+	//The largest step for which the nlerp error is documented.
+	const double g_maxNlerpStep = 10.0 * 3.14159265358979 / 180.0;
+
+	glm::fquat RandomQuat()
+	{
+		glm::fquat theQuat(Bench::RandomFloat(-1.0f, 1.0f), Bench::RandomFloat(-1.0f, 1.0f),
+			Bench::RandomFloat(-1.0f, 1.0f), Bench::RandomFloat(-1.0f, 1.0f));
+		return glm::normalize(theQuat);
+	}
+
+	//A rotation of a random axis by up to fMaxAngle radians.
+	glm::fquat RandomStep(float fMaxAngle)
+	{
+		glm::vec3 axis = glm::normalize(glm::vec3(Bench::RandomFloat(-1.0f, 1.0f), Bench::RandomFloat(-1.0f, 1.0f),
+			Bench::RandomFloat(-1.0f, 1.0f)) + glm::vec3(0.001f));
+		float halfAngle = Bench::RandomFloat(0.0f, fMaxAngle) * 0.5f;
+		return glm::fquat(cosf(halfAngle), axis * sinf(halfAngle));
+	}
+
+	struct TestData
+	{
+		Framework::QuatArray from;
+		Framework::QuatArray to;
+		Framework::QuatArray near;			//Within 10 degrees of from.
+		std::vector<float> alphas;
+		std::vector<glm::vec3> translations;
+	};
+
+	void MakeTestData(TestData &data)
+	{
+		data.from.resize(g_numQuats);
+		data.to.resize(g_numQuats);
+		data.near.resize(g_numQuats);
+		for(size_t iQuat = 0; iQuat < g_numQuats; iQuat++)
+		{
+			glm::fquat from = RandomQuat();
+			data.from.Set(iQuat, from);
+
+			//Some nearly equal or nearly opposite pairs, for the edges of slerp.
+			switch(iQuat % 8)
+			{
+			case 0: data.to.Set(iQuat, from); break;
+			case 1: data.to.Set(iQuat, from * RandomStep(0.001f)); break;
+			case 2: data.to.Set(iQuat, -(from * RandomStep(0.05f))); break;
+			default: data.to.Set(iQuat, RandomQuat()); break;
+			}
+
+			data.near.Set(iQuat, from * RandomStep((float)g_maxNlerpStep));
+			data.alphas.push_back(Bench::RandomFloat(0.0f, 1.0f));
+			data.translations.push_back(glm::vec3(Bench::RandomFloat(-100.0f, 100.0f), Bench::RandomFloat(-100.0f, 100.0f),
+				Bench::RandomFloat(-100.0f, 100.0f)));
+		}
+	}
+
+	bool SameQuat(const glm::fquat &first, const glm::fquat &second)
+	{
+		return first.w == second.w && first.x == second.x && first.y == second.y && first.z == second.z;
+	}
+
+	//Returns the number of quaternions or matrices that differ from glm.
+	int CheckExact(const TestData &data)
+	{
+		int numDifferences = 0;
+
+		Framework::QuatArray products;
+		Framework::MultiplyQuats(data.from, data.to, products);
+		for(size_t iQuat = 0; iQuat < g_numQuats; iQuat++)
+		{
+			if(!SameQuat(products.Get(iQuat), data.from.Get(iQuat) * data.to.Get(iQuat)))
+				numDifferences++;
+		}
+
+		std::vector<glm::mat4> matrices(g_numQuats);
+		std::vector<glm::vec4> rows(g_numQuats * 3);
+		Framework::QuatsToMatrices(products, &matrices[0]);
+		Framework::QuatsToRows3x4(products, &data.translations[0], &rows[0]);
+		for(size_t iQuat = 0; iQuat < g_numQuats; iQuat++)
+		{
+			glm::mat4 expected = glm::mat4_cast(products.Get(iQuat));
+			if(matrices[iQuat] != expected)
+				numDifferences++;
+
+			for(int iRow = 0; iRow < 3; iRow++)
+			{
+				glm::vec4 expectedRow(expected[0][iRow], expected[1][iRow], expected[2][iRow],
+					data.translations[iQuat][iRow]);
+				if(rows[iQuat * 3 + iRow] != expectedRow)
+					numDifferences++;
+			}
+		}
+
+		return numDifferences;
+	}
+
+	struct DQuat
+	{
+		double w, x, y, z;
+	};
+
+	DQuat ToDouble(const glm::fquat &theQuat)
+	{
+		DQuat result = {theQuat.w, theQuat.x, theQuat.y, theQuat.z};
+		return result;
+	}
+
+	double Dot(const DQuat &first, const DQuat &second)
+	{
+		return first.w * second.w + first.x * second.x + first.y * second.y + first.z * second.z;
+	}
+
+	DQuat ExactSlerp(DQuat from, DQuat to, double alpha)
+	{
+		double length = sqrt(Dot(from, from));
+		from.w /= length; from.x /= length; from.y /= length; from.z /= length;
+		length = sqrt(Dot(to, to));
+		to.w /= length; to.x /= length; to.y /= length; to.z /= length;
+
+		double cosAngle = Dot(from, to);
+		if(cosAngle < 0.0)
+		{
+			to.w = -to.w; to.x = -to.x; to.y = -to.y; to.z = -to.z;
+			cosAngle = -cosAngle;
+		}
+
+		double angle = acos(std::min(cosAngle, 1.0));
+		double fromScale = 1.0 - alpha;
+		double toScale = alpha;
+		if(angle > 1.0e-9)
+		{
+			fromScale = sin((1.0 - alpha) * angle) / sin(angle);
+			toScale = sin(alpha * angle) / sin(angle);
+		}
+
+		DQuat result = {fromScale * from.w + toScale * to.w, fromScale * from.x + toScale * to.x,
+			fromScale * from.y + toScale * to.y, fromScale * from.z + toScale * to.z};
+		return result;
+	}
+
+	//The angle of the rotation between the two, in radians.
+	double AngleBetween(const DQuat &first, const DQuat &second)
+	{
+		double cosHalf = fabs(Dot(first, second)) / sqrt(Dot(first, first) * Dot(second, second));
+		return 2.0 * acos(std::min(cosHalf, 1.0));
+	}
+
+	struct Errors
+	{
+		double angle;
+		double length;
+	};
+
+	Errors MaxErrors(const Framework::QuatArray &from, const Framework::QuatArray &to,
+		const std::vector<float> &alphas, const Framework::QuatArray &results)
+	{
+		Errors errors = {0.0, 0.0};
+		for(size_t iQuat = 0; iQuat < results.size(); iQuat++)
+		{
+			DQuat expected = ExactSlerp(ToDouble(from.Get(iQuat)), ToDouble(to.Get(iQuat)), alphas[iQuat]);
+			DQuat result = ToDouble(results.Get(iQuat));
+			errors.angle = std::max(errors.angle, AngleBetween(result, expected));
+			errors.length = std::max(errors.length, fabs(sqrt(Dot(result, result)) - 1.0));
+		}
+
+		return errors;
+	}
+
+	//The results are stored, so none of the work can be optimized out. The arrays are reused, so
+	//that allocation is not timed.
+	struct TimingOutput
+	{
+		Framework::QuatArray quats;
+		std::vector<glm::mat4> matrices;
+		std::vector<glm::vec4> rows;
+
+		TimingOutput() : matrices(g_numQuats), rows(g_numQuats * 3) {quats.resize(g_numQuats);}
+	};
+
+	template<typename Op>
+	void TimeOp(const char *strName, int iNumIterations, const TestData &data, Op op)
+	{
+		TimingOutput output;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(int iIteration = 0; iIteration < iNumIterations; iIteration++)
+			op(data, output);
+
+		double seconds = Bench::SecondsSince(start);
+
+		float sum = 0.0f;
+		for(size_t iQuat = 0; iQuat < g_numQuats; iQuat++)
+			sum += output.quats.x[iQuat] + output.matrices[iQuat][1].x + output.rows[iQuat].w;
+
+		Bench::PrintTime(strName, seconds, iNumIterations, g_numQuats, sum);
+	}
+
+	void GlmMultiplyOp(const TestData &data, TimingOutput &output)
+	{
+		for(size_t iQuat = 0; iQuat < g_numQuats; iQuat++)
+			output.quats.Set(iQuat, data.from.Get(iQuat) * data.to.Get(iQuat));
+	}
+
+	void BatchMultiplyOp(const TestData &data, TimingOutput &output)
+	{
+		Framework::MultiplyQuats(data.from, data.to, output.quats);
+	}
+
+	void GlmSlerpOp(const TestData &data, TimingOutput &output)
+	{
+		for(size_t iQuat = 0; iQuat < g_numQuats; iQuat++)
+			output.quats.Set(iQuat, glm::mix(data.from.Get(iQuat), data.to.Get(iQuat), data.alphas[iQuat]));
+	}
+
+	void BatchSlerpOp(const TestData &data, TimingOutput &output)
+	{
+		Framework::SlerpQuats(data.from, data.to, data.alphas, output.quats);
+	}
+
+	void BatchNlerpOp(const TestData &data, TimingOutput &output)
+	{
+		Framework::NlerpQuats(data.from, data.to, data.alphas, output.quats);
+	}
+
+	void GlmMatrixOp(const TestData &data, TimingOutput &output)
+	{
+		for(size_t iQuat = 0; iQuat < g_numQuats; iQuat++)
+			output.matrices[iQuat] = glm::mat4_cast(data.from.Get(iQuat));
+	}
+
+	void BatchMatrixOp(const TestData &data, TimingOutput &output)
+	{
+		Framework::QuatsToMatrices(data.from, &output.matrices[0]);
+	}
+
+	void BatchRowsOp(const TestData &data, TimingOutput &output)
+	{
+		Framework::QuatsToRows3x4(data.from, &data.translations[0], &output.rows[0]);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int iNumIterations = 500;
+	for(int iArg = 1; iArg < argc; iArg++)
+	{
+		std::string strArg = argv[iArg];
+		if(strArg == "-iterations" && iArg + 1 < argc)
+			iNumIterations = atoi(argv[++iArg]);
+		else
+		{
+			printf("Usage: QuatBatchBench [-iterations <n>]\n");
+			return 1;
+		}
+	}
+
+	TestData data;
+	MakeTestData(data);
+
+	int numDifferences = CheckExact(data);
+	printf("multiply and matrices: %d differ from glm\n", numDifferences);
+
+	Framework::QuatArray slerped;
+	Framework::SlerpQuats(data.from, data.to, data.alphas, slerped);
+	Errors slerpErrors = MaxErrors(data.from, data.to, data.alphas, slerped);
+	printf("SlerpQuats: largest error %g radians, %g in length\n", slerpErrors.angle, slerpErrors.length);
+
+	Framework::QuatArray nlerped;
+	Framework::NlerpQuats(data.from, data.near, data.alphas, nlerped);
+	Errors nlerpErrors = MaxErrors(data.from, data.near, data.alphas, nlerped);
+	printf("NlerpQuats, steps of up to 10 degrees: largest error %g radians\n", nlerpErrors.angle);
+
+	bool bAccurate = slerpErrors.angle <= g_maxSlerpError && slerpErrors.length <= g_maxUnitError &&
+		nlerpErrors.angle <= g_maxNlerpError;
+
+	printf("Per quaternion:\n");
+	TimeOp("glm multiply", iNumIterations, data, GlmMultiplyOp);
+	TimeOp("MultiplyQuats", iNumIterations, data, BatchMultiplyOp);
+	TimeOp("glm::mix", iNumIterations, data, GlmSlerpOp);
+	TimeOp("SlerpQuats", iNumIterations, data, BatchSlerpOp);
+	TimeOp("NlerpQuats", iNumIterations, data, BatchNlerpOp);
+	TimeOp("glm::mat4_cast", iNumIterations, data, GlmMatrixOp);
+	TimeOp("QuatsToMatrices", iNumIterations, data, BatchMatrixOp);
+	TimeOp("QuatsToRows3x4", iNumIterations, data, BatchRowsOp);
+
+	return numDifferences == 0 && bAccurate ? 0 : 1;
+}
@@ -12,62 +12,167 @@
 #include <GL/freeglut.h>
 #include "../framework/framework.h"
 #include "../framework/Mesh.h"
+#include "../framework/MeshGeometry.h"
+#include "../framework/MeshGenerators.h"
+#include "../framework/MeshLoader.h"
+#include "../framework/MeshClusters.h"
+#include "../framework/ProgramCache.h"
+#include "../framework/ShaderLibrary.h"
+#include "../framework/ProgramUniforms.h"
+#include "../framework/GLStateCache.h"
+#include "../framework/FixedMatrixStack.h"
 #include "../framework/directories.h"
 #include <glimg/glimg.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 
 #define ARRAY_COUNT( array ) (sizeof( array ) / (sizeof( array[0] ) * (sizeof( array ) != sizeof(void*) || sizeof( array[0] ) <= sizeof(void*))))
 
+//Deep enough for the scene's nesting, with room to spare. These never allocate.
+typedef Framework::InlineMatrixStack<8> MatrixStack;
+
 struct ProgramData
 {
 	GLuint theProgram;
-	GLuint globalUniformBlockIndex;
-	GLuint modelToWorldMatrixUnif;
-	GLuint baseColorUnif;
+	Framework::ProgramUniforms *pUniforms;		//Shared by every copy, since it shadows the program's values; see g_programUniforms.
+	int modelToWorldMatrixUnif;
+	int modelToClipMatrixUnif;		//-1 unless the program was built with PRECOMBINED_TRANSFORM.
+	int baseColorUnif;
+
+	//While this is valid, the real program is still being built, and the fields above are a copy of
+	//ObjectColor's.
+	Framework::ShaderLibrary::ProgramHandle hPending;
 };
 
 float g_fzNear = 1.0f;
 float g_fzFar = 1000.0f;
 
-ProgramData Texture;
+//Element 0 does the whole world transform in the vertex shader. Element 1 is built with
+//PRECOMBINED_TRANSFORM, and is given one model-to-clip matrix per object instead.
+ProgramData Texture[2];
 ProgramData ObjectColor;
-ProgramData UniformColorTint;
+ProgramData UniformColorTint[2];
+
+bool g_bPrecombineTransforms = false;
+glm::mat4 g_worldToClipMatrix;		//Updated at the start of each frame.
 
 GLuint g_GlobalMatricesUBO;
 
 static const int g_iGlobalMatricesBindingIndex = 0;
 
-ProgramData LoadProgram(const std::string &strVertexShader, const std::string &strFragmentShader)
-{
-	std::vector<GLuint> shaderList;
+//Program binaries are cached in the working directory. Run twice to compare
+//the cold and warm startup times printed by UpdatePrograms.
+Framework::ProgramCache g_programCache("ProgramCache_");
+Framework::ShaderLibrary g_shaderLibrary(&g_programCache);
+bool g_bProgramsPending = false;
+Framework::UniformUploadStats g_uniformStats;		//From the last frame.
+Framework::GLStateCache &g_glState = Framework::GetGLStateCache();
 
-	shaderList.push_back(Framework::LoadShader(GL_VERTEX_SHADER, strVertexShader));
-	shaderList.push_back(Framework::LoadShader(GL_FRAGMENT_SHADER, strFragmentShader));
+//Every program's uniform table, one per program built. Freed on exit, along with the meshes.
+std::vector<Framework::ProgramUniforms *> g_programUniforms;
 
+ProgramData MakeProgramData(GLuint program)
+{
 	ProgramData data;
-	data.theProgram = Framework::CreateProgram(shaderList);
-	data.modelToWorldMatrixUnif = glGetUniformLocation(data.theProgram, "modelToWorldMatrix");
-	data.globalUniformBlockIndex = glGetUniformBlockIndex(data.theProgram, "GlobalMatrices");
-	data.baseColorUnif = glGetUniformLocation(data.theProgram, "baseColor");
+	data.theProgram = program;
+	g_programUniforms.reserve(g_programUniforms.size() + 1);
+	data.pUniforms = new Framework::ProgramUniforms(program, &g_uniformStats);
+	g_programUniforms.push_back(data.pUniforms);
+	data.modelToWorldMatrixUnif = data.pUniforms->FindUniform("modelToWorldMatrix");
+	data.modelToClipMatrixUnif = data.pUniforms->FindUniform("modelToClipMatrix");
+	data.baseColorUnif = data.pUniforms->FindUniform("baseColor");
 
-	glUniformBlockBinding(data.theProgram, data.globalUniformBlockIndex, g_iGlobalMatricesBindingIndex);
+	data.pUniforms->SetBlockBinding(data.pUniforms->FindBlock("GlobalMatrices"), g_iGlobalMatricesBindingIndex);
 
 	return data;
 }
 
+ProgramData LoadProgram(const std::string &strVertexShader, const std::string &strFragmentShader,
+	const std::string &strFragmentDefines = "")
+{
+	return MakeProgramData(g_shaderLibrary.LoadProgram(strVertexShader, "", strFragmentShader, strFragmentDefines));
+}
+
+//Draws with ObjectColor until the program is ready; see UpdatePrograms.
+ProgramData BeginProgram(const std::string &strVertexShader, const std::string &strVertexDefines,
+	const std::string &strFragmentShader, const std::string &strFragmentDefines = "")
+{
+	ProgramData data = ObjectColor;
+	data.hPending = g_shaderLibrary.BeginProgram(strVertexShader, strVertexDefines, strFragmentShader,
+		strFragmentDefines);
+	g_bProgramsPending = true;
+	return data;
+}
+
+//Returns true if the program is still pending.
+bool UpdateProgram(ProgramData &data)
+{
+	if(!data.hPending.IsValid())
+		return false;
+
+	if(!g_shaderLibrary.IsProgramReady(data.hPending))
+		return true;
+
+	data = MakeProgramData(g_shaderLibrary.FinishProgram(data.hPending));
+	return false;
+}
+
+//Called at the start of each frame. With parallel shader compiles, nothing waits for the driver.
+//Without them, the first frame is drawn with the stand-ins, and the second waits for whatever the
+//driver has not finished by then.
+void UpdatePrograms()
+{
+	if(!g_bProgramsPending)
+		return;
+
+	try
+	{
+		bool bPending = false;
+		for(int iProgram = 0; iProgram < 2; iProgram++)
+		{
+			bPending = UpdateProgram(Texture[iProgram]) || bPending;
+			bPending = UpdateProgram(UniformColorTint[iProgram]) || bPending;
+		}
+
+		if(bPending)
+			return;
+	}
+	catch(std::exception &except)
+	{
+		printf("%s\n", except.what());
+		throw;
+	}
+
+	g_bProgramsPending = false;
+	g_shaderLibrary.DeleteShaders();
+
+	const Framework::ProgramCacheStats &cacheStats = g_programCache.GetStats();
+	const Framework::ShaderLibraryStats &shaderStats = g_shaderLibrary.GetStats();
+	printf("Programs: %d from the cache in %.2f ms, %d compiled in %.2f ms (%d of %d shaders compiled)\n",
+		cacheStats.iNumHits, cacheStats.hitSeconds * 1000.0,
+		cacheStats.iNumMisses, cacheStats.missSeconds * 1000.0,
+		shaderStats.iNumShadersCompiled, shaderStats.iNumShaderRequests);
+	printf("All programs ready after %d ms%s\n", glutGet(GLUT_ELAPSED_TIME),
+		g_shaderLibrary.HasParallelCompile() ? ", compiled in parallel" : "");
+}
+
 void InitializeProgram()
 {
-	Texture = LoadProgram("PosOnlyWorldTransformUBO.vert", "ColorUniform.frag");
+	//ObjectColor is needed at once, as the stand-in for the others.
 	ObjectColor = LoadProgram("PosColorWorldTransformUBO.vert", "ColorPassthrough.frag");
-	UniformColorTint = LoadProgram("PosColorWorldTransformUBO.vert", "ColorMultUniform.frag");
+	Texture[0] = BeginProgram("PosOnlyWorldTransformUBO.vert", "", "ColorUniform.frag");
+	UniformColorTint[0] = BeginProgram("PosColorWorldTransformUBO.vert", "", "ColorPassthrough.frag",
+		"MULTIPLY_BASE_COLOR");
+	Texture[1] = BeginProgram("PosOnlyWorldTransformUBO.vert", "PRECOMBINED_TRANSFORM", "ColorUniform.frag");
+	UniformColorTint[1] = BeginProgram("PosColorWorldTransformUBO.vert", "PRECOMBINED_TRANSFORM",
+		"ColorPassthrough.frag", "MULTIPLY_BASE_COLOR");
 
 	glGenBuffers(1, &g_GlobalMatricesUBO);
-	glBindBuffer(GL_UNIFORM_BUFFER, g_GlobalMatricesUBO);
+	g_glState.BindBuffer(GL_UNIFORM_BUFFER, g_GlobalMatricesUBO);
 	glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::mat4) * 2, NULL, GL_STREAM_DRAW);
-	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-	glBindBufferRange(GL_UNIFORM_BUFFER, g_iGlobalMatricesBindingIndex, g_GlobalMatricesUBO, 0, sizeof(glm::mat4) * 2);
+	g_glState.BindBufferRange(GL_UNIFORM_BUFFER, g_iGlobalMatricesBindingIndex, g_GlobalMatricesUBO, 0, sizeof(glm::mat4) * 2);
 }
 
 GLuint g_checkerTexture = 0;
@@ -82,7 +187,8 @@ void LoadCheckerTexture()
 		std::auto_ptr<glimg::ImageSet> pImageSet(glimg::loaders::dds::LoadFromFile(filename.c_str()));
 
 		glGenTextures(1, &g_checkerTexture);
-		glBindTexture(GL_TEXTURE_2D, g_checkerTexture);
+		g_glState.ActiveTexture(GL_TEXTURE0);
+		g_glState.BindTexture(GL_TEXTURE_2D, g_checkerTexture);
 
 		for(int mipmapLevel = 0; mipmapLevel < pImageSet->GetMipmapCount(); mipmapLevel++)
 		{
@@ -95,7 +201,6 @@ void LoadCheckerTexture()
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, pImageSet->GetMipmapCount() - 1);
-		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 	catch(std::exception &e)
 	{
@@ -114,17 +219,28 @@ glm::mat4 CalcLookAtMatrix(const glm::vec3 &cameraPt, const glm::vec3 &lookPt, c
 	glm::vec3 rightDir = glm::normalize(glm::cross(lookDir, upDir));
 	glm::vec3 perpUpDir = glm::cross(rightDir, lookDir);
 
-	glm::mat4 rotMat(1.0f);
-	rotMat[0] = glm::vec4(rightDir, 0.0f);
-	rotMat[1] = glm::vec4(perpUpDir, 0.0f);
-	rotMat[2] = glm::vec4(-lookDir, 0.0f);
+	//The camera's own axes and position make the camera-to-world matrix, which is rigid.
+	glm::mat4 cameraToWorld(1.0f);
+	cameraToWorld[0] = glm::vec4(rightDir, 0.0f);
+	cameraToWorld[1] = glm::vec4(perpUpDir, 0.0f);
+	cameraToWorld[2] = glm::vec4(-lookDir, 0.0f);
+	cameraToWorld[3] = glm::vec4(cameraPt, 1.0f);
 
-	rotMat = glm::transpose(rotMat);
+	return glm::rigidInverse(cameraToWorld);
+}
 
-	glm::mat4 transMat(1.0f);
-	transMat[3] = glm::vec4(-cameraPt, 1.0f);
+//Makes the program for the current transform mode current, and gives it the model's transform.
+//Stand-ins are never precombined, so they get the model-to-world matrix whichever mode is used.
+const ProgramData &UseProgram(const ProgramData *pPrograms, const glm::mat4 &modelToWorld)
+{
+	const ProgramData &data = pPrograms[g_bPrecombineTransforms ? 1 : 0];
+	g_glState.UseProgram(data.theProgram);
+	if(data.modelToClipMatrixUnif != -1)
+		data.pUniforms->SetMat4(data.modelToClipMatrixUnif, g_worldToClipMatrix * modelToWorld);
+	else
+		data.pUniforms->SetMat4(data.modelToWorldMatrixUnif, modelToWorld);
 
-	return rotMat * transMat;
+	return data;
 }
 
 Framework::Mesh *g_pConeMesh = NULL;
@@ -134,19 +250,58 @@ Framework::Mesh *g_pCubeColorMesh = NULL;
 Framework::Mesh *g_pPlaneMesh = NULL;
 Framework::Mesh *g_pSphereMesh = NULL;
 
+Framework::Mesh::VaoHandle g_hPlaneTexVao;
+
+//Only drawn while benchmarking; made the first time it is needed.
+Framework::Mesh *g_pDenseSphereMesh = NULL;
+bool g_bBenchmark = false;
+GLuint g_benchmarkQueries[2] = {0, 0};
+int g_iBenchmarkFrame = 0;
+int g_iBenchmarkSamples = 0;
+GLuint64 g_benchmarkNanoseconds = 0;
+const int g_iBenchmarkSamplesPerReport = 60;
+
+glm::mat4 g_cameraToClipMatrix;
+Framework::ClusterCullStats g_sphereCullStats;		//From the last frame.
+
+Framework::Mesh *CreateMesh(const std::string &strName, unsigned int loadFlags, Framework::MeshGeometry &geom)
+{
+	Framework::ProcessMeshGeometry(strName, loadFlags, geom);
+	return new Framework::Mesh(geom);
+}
+
 //Called after the window and OpenGL are initialized. Called exactly once, before the main loop.
 void init()
 {
+#ifdef _DEBUG
+	//Throws as soon as anything changes bindings behind the cache's back.
+	g_glState.SetVerify(true);
+#endif
+
 	InitializeProgram();
 
 	try
 	{
-		g_pConeMesh = new Framework::Mesh("UnitConeTint.xml");
-		g_pCylinderMesh = new Framework::Mesh("UnitCylinderTint.xml");
-		g_pCubeTintMesh = new Framework::Mesh("UnitCubeTint.xml");
-		g_pCubeColorMesh = new Framework::Mesh("UnitCubeColor.xml");
-		g_pPlaneMesh = new Framework::Mesh("UnitPlane.xml");
-		g_pSphereMesh= new Framework::Mesh("UnitSphere.xml");
+		Framework::MeshGeometry geom;
+
+		Framework::GenerateCone(24, geom);
+		g_pConeMesh = CreateMesh("UnitConeTint", 0, geom);
+		Framework::GenerateCylinder(24, geom);
+		g_pCylinderMesh = CreateMesh("UnitCylinderTint", 0, geom);
+		Framework::GenerateCube(1, false, geom);
+		g_pCubeTintMesh = CreateMesh("UnitCubeTint", 0, geom);
+		Framework::GenerateCube(1, true, geom);
+		g_pCubeColorMesh = CreateMesh("UnitCubeColor", 0, geom);
+
+		//The plane is read from data/UnitPlane.xml; the other meshes are generated.
+		std::vector<std::string> meshFiles(1, "UnitPlane.xml");
+		g_pPlaneMesh = Framework::LoadMeshes(meshFiles, 0, 1)[0];
+
+		//The sphere is the only mesh detailed enough to be worth culling in pieces.
+		Framework::GenerateSphere(48, 96, geom);
+		g_pSphereMesh = CreateMesh("UnitSphere", Framework::MESH_BUILD_CLUSTERS, geom);
+
+		g_hPlaneTexVao = g_pPlaneMesh->GetVaoHandle("tex");
 	}
 	catch(std::exception &except)
 	{
@@ -154,15 +309,15 @@ void init()
 		throw;
 	}
 
-	glEnable(GL_CULL_FACE);
+	g_glState.Enable(GL_CULL_FACE);
 	glCullFace(GL_BACK);
 	glFrontFace(GL_CW);
 
-	glEnable(GL_DEPTH_TEST);
+	g_glState.Enable(GL_DEPTH_TEST);
 	glDepthMask(GL_TRUE);
 	glDepthFunc(GL_LEQUAL);
 	glDepthRange(0.0f, 1.0f);
-	glEnable(GL_DEPTH_CLAMP);
+	g_glState.Enable(GL_DEPTH_CLAMP);
 
 	LoadCheckerTexture();
 }
@@ -171,84 +326,74 @@ static float g_fYAngle = 0.0f;
 static float g_fXAngle = 0.0f;
 
 //Trees are 3x3 in X/Z, and fTrunkHeight+fConeHeight in the Y.
-void DrawTree(glutil::MatrixStack &modelMatrix, float fTrunkHeight = 2.0f, float fConeHeight = 3.0f)
+void DrawTree(Framework::FixedMatrixStack &modelMatrix, float fTrunkHeight = 2.0f, float fConeHeight = 3.0f)
 {
 	//Draw trunk.
 	{
-		glutil::PushStack push(modelMatrix);
+		Framework::PushStack push(modelMatrix);
 
 		modelMatrix.Scale(glm::vec3(1.0f, fTrunkHeight, 1.0f));
 		modelMatrix.Translate(glm::vec3(0.0f, 0.5f, 0.0f));
 
-		glUseProgram(UniformColorTint.theProgram);
-		glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-		glUniform4f(UniformColorTint.baseColorUnif, 0.694f, 0.4f, 0.106f, 1.0f);
+		const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+		tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.694f, 0.4f, 0.106f, 1.0f));
 		g_pCylinderMesh->Render();
-		glUseProgram(0);
 	}
 
 	//Draw the treetop
 	{
-		glutil::PushStack push(modelMatrix);
+		Framework::PushStack push(modelMatrix);
 
 		modelMatrix.Translate(glm::vec3(0.0f, fTrunkHeight, 0.0f));
 		modelMatrix.Scale(glm::vec3(3.0f, fConeHeight, 3.0f));
 
-		glUseProgram(UniformColorTint.theProgram);
-		glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-		glUniform4f(UniformColorTint.baseColorUnif, 0.0f, 1.0f, 0.0f, 1.0f);
+		const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+		tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
 		g_pConeMesh->Render();
-		glUseProgram(0);
 	}
 }
 
 const float g_fColumnBaseHeight = 0.25f;
 
 //Columns are 1x1 in the X/Z, and fHieght units in the Y.
-void DrawColumn(glutil::MatrixStack &modelMatrix, float fHeight = 5.0f)
+void DrawColumn(Framework::FixedMatrixStack &modelMatrix, float fHeight = 5.0f)
 {
 	//Draw the bottom of the column.
 	{
-		glutil::PushStack push(modelMatrix);
+		Framework::PushStack push(modelMatrix);
 
 		modelMatrix.Scale(glm::vec3(1.0f, g_fColumnBaseHeight, 1.0f));
 		modelMatrix.Translate(glm::vec3(0.0f, 0.5f, 0.0f));
 
-		glUseProgram(UniformColorTint.theProgram);
-		glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-		glUniform4f(UniformColorTint.baseColorUnif, 1.0f, 1.0f, 1.0f, 1.0f);
+		const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+		tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
 		g_pCubeTintMesh->Render();
-		glUseProgram(0);
 	}
 
 	//Draw the top of the column.
 	{
-		glutil::PushStack push(modelMatrix);
+		Framework::PushStack push(modelMatrix);
 
 		modelMatrix.Translate(glm::vec3(0.0f, fHeight - g_fColumnBaseHeight, 0.0f));
 		modelMatrix.Scale(glm::vec3(1.0f, g_fColumnBaseHeight, 1.0f));
 		modelMatrix.Translate(glm::vec3(0.0f, 0.5f, 0.0f));
 
-		glUseProgram(UniformColorTint.theProgram);
-		glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-		glUniform4f(UniformColorTint.baseColorUnif, 0.9f, 0.9f, 0.9f, 0.9f);
+		const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+		tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.9f, 0.9f, 0.9f, 0.9f));
 		g_pCubeTintMesh->Render();
-		glUseProgram(0);
 	}
 
 	//Draw the main column.
 	{
-		glutil::PushStack push(modelMatrix);
+		Framework::PushStack push(modelMatrix);
 
 		modelMatrix.Translate(glm::vec3(0.0f, g_fColumnBaseHeight, 0.0f));
 		modelMatrix.Scale(glm::vec3(0.8f, fHeight - (g_fColumnBaseHeight * 2.0f), 0.8f));
 		modelMatrix.Translate(glm::vec3(0.0f, 0.5f, 0.0f));
 
-		glUseProgram(UniformColorTint.theProgram);
-		glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-		glUniform4f(UniformColorTint.baseColorUnif, 0.9f, 0.9f, 0.9f, 0.9f);
+		const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+		tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.9f, 0.9f, 0.9f, 0.9f));
 		g_pCylinderMesh->Render();
-		glUseProgram(0);
 	}
 }
 
@@ -368,13 +513,13 @@ static const TreeData g_forest[] =
 	{25.0f, 45.0f, 2.0f, 3.0f},
 };
 
-void DrawForest(glutil::MatrixStack &modelMatrix)
+void DrawForest(Framework::FixedMatrixStack &modelMatrix)
 {
 	for(int iTree = 0; iTree < ARRAY_COUNT(g_forest); iTree++)
 	{
 		const TreeData &currTree = g_forest[iTree];
 
-		glutil::PushStack push(modelMatrix);
+		Framework::PushStack push(modelMatrix);
 		modelMatrix.Translate(glm::vec3(currTree.fXPos, 0.0f, currTree.fZPos));
 		DrawTree(modelMatrix, currTree.fTrunkHeight, currTree.fConeHeight);
 	}
@@ -387,8 +532,6 @@ static glm::vec3 g_camTarget(20.0f, 0.4f, 35.0f);
 static glm::vec3 g_sphereCamRelPos(90.0f, -12.0f, 35.0f);
 
 glm::vec3 ResolvePosition(){
-	glutil::MatrixStack tempMat;
-
 	float alpha = Framework::DegToRad(g_sphereCamRelPos.x);
 
 	float fSinAlpha = sinf(alpha);
@@ -400,8 +543,6 @@ glm::vec3 ResolvePosition(){
 
 glm::vec3 ResolveCamPosition()
 {
-	glutil::MatrixStack tempMat;
-
 	float phi = Framework::DegToRad(g_sphereCamRelPos.x);
 	float theta = Framework::DegToRad(g_sphereCamRelPos.y + 90.0f);
 
@@ -416,8 +557,6 @@ glm::vec3 ResolveCamPosition()
 
 glm::vec3 obliczSterowanie()
 {
-	glutil::MatrixStack tempMat;
-
 	float alpha = Framework::DegToRad(g_sphereCamRelPos.x);
 
 	float fSinAlpha = sinf(alpha);
@@ -447,8 +586,69 @@ bool granica() {
 	}
 };
 
+void ResetBenchmark()
+{
+	g_iBenchmarkFrame = 0;
+	g_iBenchmarkSamples = 0;
+	g_benchmarkNanoseconds = 0;
+}
+
+//A grid of spheres with over 100,000 vertices each, small enough on screen that the time goes
+//to transforming vertices. Each frame's GPU time is read back on the next frame, so that the query
+//does not wait for the GPU.
+void DrawDenseSpheres(Framework::FixedMatrixStack &modelMatrix)
+{
+	if(!g_pDenseSphereMesh)
+	{
+		Framework::MeshGeometry geom;
+		Framework::GenerateSphere(256, 512, geom);
+		g_pDenseSphereMesh = CreateMesh("DenseSphere", 0, geom);
+		glGenQueries(2, g_benchmarkQueries);
+	}
+
+	if(g_iBenchmarkFrame > 0)
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(g_benchmarkQueries[(g_iBenchmarkFrame + 1) % 2], GL_QUERY_RESULT, &elapsed);
+		g_benchmarkNanoseconds += elapsed;
+		g_iBenchmarkSamples++;
+	}
+
+	if(g_iBenchmarkSamples == g_iBenchmarkSamplesPerReport)
+	{
+		printf("Dense spheres: %.3f ms on the GPU, %s transform\n",
+			g_benchmarkNanoseconds / (g_iBenchmarkSamples * 1000000.0),
+			g_bPrecombineTransforms ? "precombined" : "per-vertex");
+		g_iBenchmarkSamples = 0;
+		g_benchmarkNanoseconds = 0;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, g_benchmarkQueries[g_iBenchmarkFrame % 2]);
+	for(int iRow = 0; iRow < 5; iRow++)
+	{
+		for(int iColumn = 0; iColumn < 5; iColumn++)
+		{
+			Framework::PushStack push(modelMatrix);
+
+			modelMatrix.Translate(glm::vec3(g_camTarget.x + (iColumn - 2) * 3.0f, g_camTarget.y + 8.0f,
+				g_camTarget.z + (iRow - 2) * 3.0f));
+
+			const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+			tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.5f, 0.5f, 1.0f, 1.0f));
+			g_pDenseSphereMesh->Render();
+		}
+	}
+	glEndQuery(GL_TIME_ELAPSED);
+
+	g_iBenchmarkFrame++;
+}
+
 void display()
 {
+	UpdatePrograms();
+	g_uniformStats = Framework::UniformUploadStats();
+	g_glState.ResetStats();
+
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	glClearDepth(1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -457,29 +657,25 @@ void display()
 	{
 		const glm::vec3 &camPos = ResolveCamPosition();
 
-		glutil::MatrixStack camMatrix;
+		MatrixStack camMatrix;
 		camMatrix.SetMatrix(CalcLookAtMatrix(camPos, g_camTarget, glm::vec3(0.0f, 1.0f, 0.0f)));
 
-		glBindBuffer(GL_UNIFORM_BUFFER, g_GlobalMatricesUBO);
+		g_glState.BindBuffer(GL_UNIFORM_BUFFER, g_GlobalMatricesUBO);
 		glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(camMatrix.Top()));
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		g_worldToClipMatrix = g_cameraToClipMatrix * camMatrix.Top();
 
-		glutil::MatrixStack modelMatrix;
+		MatrixStack modelMatrix;
 
 		//Render the ground plane.
 		{
-			glutil::PushStack push(modelMatrix);
+			Framework::PushStack push(modelMatrix);
 
 			modelMatrix.Scale(glm::vec3(200.0f, 1.0f, 200.0f));
 
-			glUseProgram(Texture.theProgram);
-
-			glUniformMatrix4fv(Texture.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, g_checkerTexture);
-			g_pPlaneMesh->Render("tex");
-			glUseProgram(0);
-
+			UseProgram(Texture, modelMatrix.Top());
+			g_glState.ActiveTexture(GL_TEXTURE0);
+			g_glState.BindTexture(GL_TEXTURE_2D, g_checkerTexture);
+			g_pPlaneMesh->Render(g_hPlaneTexVao);
 		}
 
 		//Draw the trees
@@ -487,39 +683,32 @@ void display()
 
 		//Draw the building.
 		{
-			glutil::PushStack push(modelMatrix);
+			Framework::PushStack push(modelMatrix);
 			modelMatrix.Translate(glm::vec3(20.0f, 0.0f, -10.0f));
 
 		}
 
 		{
 
-			glutil::MatrixStack tempMat;
-
 			float alpha = Framework::DegToRad(g_sphereCamRelPos.x + 90.0f);
 
 			float fSinAlpha = sinf(alpha);
 			float fCosAlpha = cosf(alpha);
 
-			glutil::PushStack push(modelMatrix);
+			Framework::PushStack push(modelMatrix);
 
 			modelMatrix.Translate(glm::vec3((g_camTarget.x + (fCosAlpha/2)), g_camTarget.y , (g_camTarget.z + (fSinAlpha/2))));
 			modelMatrix.Scale(1.0f, 2.0f, 1.0f);
 
-			glUseProgram(UniformColorTint.theProgram);
-			glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-			glUniform4f(UniformColorTint.baseColorUnif, 0.694f, 0.4f, 0.106f, 1.0f);
+			const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+			tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.694f, 0.4f, 0.106f, 1.0f));
 			g_pCylinderMesh->Render();
-			glUseProgram(0);
-
 		}
 
 		{
 
 
-			glutil::PushStack push(modelMatrix);
-
-			glutil::MatrixStack tempMat;
+			Framework::PushStack push(modelMatrix);
 
 			float alpha = Framework::DegToRad(g_sphereCamRelPos.x + 90.0f);
 
@@ -531,20 +720,15 @@ void display()
 			modelMatrix.Translate(vector);
 			modelMatrix.Scale(1.0f, 1.5f, 1.0f);
 
-			glUseProgram(UniformColorTint.theProgram);
-			glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-			glUniform4f(UniformColorTint.baseColorUnif, 0.694f, 0.4f, 0.106f, 1.0f);
+			const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+			tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.694f, 0.4f, 0.106f, 1.0f));
 			g_pCylinderMesh->Render();
-			glUseProgram(0);
-
 		}
 
 		{
 
 
-			glutil::PushStack push(modelMatrix);
-
-			glutil::MatrixStack tempMat;
+			Framework::PushStack push(modelMatrix);
 
 			float alpha = Framework::DegToRad(g_sphereCamRelPos.x + 90.0f);
 
@@ -554,19 +738,14 @@ void display()
 			modelMatrix.Translate(glm::vec3((g_camTarget.x - fCosAlpha), (g_camTarget.y + 2.0f), (g_camTarget.z - fSinAlpha)));
 			modelMatrix.Scale(1.0f, 1.5f, 1.0f);
 
-			glUseProgram(UniformColorTint.theProgram);
-			glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-			glUniform4f(UniformColorTint.baseColorUnif, 0.694f, 0.4f, 0.106f, 1.0f);
+			const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+			tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.694f, 0.4f, 0.106f, 1.0f));
 			g_pCylinderMesh->Render();
-			glUseProgram(0);
-
 		}
 
 
 		{
-			glutil::PushStack push(modelMatrix);
-
-			glutil::MatrixStack tempMat;
+			Framework::PushStack push(modelMatrix);
 
 			float alpha = Framework::DegToRad(g_sphereCamRelPos.x + 90.0f);
 
@@ -576,53 +755,63 @@ void display()
 			modelMatrix.Translate(glm::vec3((g_camTarget.x - (fCosAlpha/2)), g_camTarget.y, g_camTarget.z - (fSinAlpha/2)));
 			modelMatrix.Scale(1.0f, 2.0f, 1.0f);
 
-			glUseProgram(UniformColorTint.theProgram);
-			glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-			glUniform4f(UniformColorTint.baseColorUnif, 0.694f, 0.4f, 0.106f, 1.0f);
+			const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+			tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.694f, 0.4f, 0.106f, 1.0f));
 			g_pCylinderMesh->Render();
-			glUseProgram(0);
 		}
 
 		{
-			glutil::PushStack push(modelMatrix);
+			Framework::PushStack push(modelMatrix);
 
 			modelMatrix.Translate(glm::vec3(g_camTarget.x, g_camTarget.y + 2.0f, g_camTarget.z));
 			modelMatrix.Scale(2.0f, 2.0f, 2.0f);
 
-			glUseProgram(UniformColorTint.theProgram);
-			glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-			glUniform4f(UniformColorTint.baseColorUnif, 0.694f, 0.4f, 0.106f, 1.0f);
+			const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+			tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.694f, 0.4f, 0.106f, 1.0f));
 			g_pCylinderMesh->Render();
-			glUseProgram(0);
 		}
 
 		{
-			glutil::PushStack push(modelMatrix);
+			Framework::PushStack push(modelMatrix);
 
 			modelMatrix.Translate(glm::vec3(g_camTarget.x, g_camTarget.y + 4.0f, g_camTarget.z));
 			modelMatrix.Scale(2.0f, 2.0f, 2.0f);
 
-			glUseProgram(UniformColorTint.theProgram);
-			glUniformMatrix4fv(UniformColorTint.modelToWorldMatrixUnif, 1, GL_FALSE, glm::value_ptr(modelMatrix.Top()));
-			glUniform4f(UniformColorTint.baseColorUnif, 0.694f, 0.4f, 0.106f, 1.0f);
-			g_pSphereMesh->Render();
-			glUseProgram(0);
+			const ProgramData &tint = UseProgram(UniformColorTint, modelMatrix.Top());
+			tint.pUniforms->SetVec4(tint.baseColorUnif, glm::vec4(0.694f, 0.4f, 0.106f, 1.0f));
+			g_sphereCullStats = Framework::ClusterCullStats();
+			g_pSphereMesh->RenderCulled(camMatrix.Top() * modelMatrix.Top(), g_cameraToClipMatrix,
+				true, &g_sphereCullStats);
 		}
+
+		if(g_bBenchmark)
+			DrawDenseSpheres(modelMatrix);
 	}
 
 	glutSwapBuffers();
+
+	static bool bFirstFrame = true;
+	if(bFirstFrame)
+	{
+		printf("First frame after %d ms\n", glutGet(GLUT_ELAPSED_TIME));
+		bFirstFrame = false;
+	}
+
+	//Keep drawing until the real programs replace their stand-ins, and while benchmarking.
+	if(g_bProgramsPending || g_bBenchmark)
+		glutPostRedisplay();
 }
 
 //Called whenever the window is resized. The new window size is given, in pixels.
 //This is an opportunity to call glViewport or glScissor to keep up with the change in size.
 void reshape (int w, int h)
 {
-	glutil::MatrixStack persMatrix;
+	MatrixStack persMatrix;
 	persMatrix.Perspective(45.0f, (w / (float)h), g_fzNear, g_fzFar);
+	g_cameraToClipMatrix = persMatrix.Top();
 
-	glBindBuffer(GL_UNIFORM_BUFFER, g_GlobalMatricesUBO);
+	g_glState.BindBuffer(GL_UNIFORM_BUFFER, g_GlobalMatricesUBO);
 	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(persMatrix.Top()));
-	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
 	glViewport(0, 0, (GLsizei) w, (GLsizei) h);
 	glutPostRedisplay();
@@ -649,6 +838,11 @@ void keyboard(unsigned char key, int x, int y)
 		g_pCubeColorMesh = NULL;
 		delete g_pPlaneMesh;
 		g_pPlaneMesh = NULL;
+		delete g_pDenseSphereMesh;
+		g_pDenseSphereMesh = NULL;
+		for(size_t iTable = 0; iTable < g_programUniforms.size(); iTable++)
+			delete g_programUniforms[iTable];
+		g_programUniforms.clear();
 		glutLeaveMainLoop();
 		return;
 	case 'w': if (granica())g_camTarget = obliczSterowanie() + g_camTarget; break;
@@ -663,11 +857,25 @@ void keyboard(unsigned char key, int x, int y)
 	case 'A': g_sphereCamRelPos.x -= 1.125f; break;
 	case 'E': g_sphereCamRelPos.y -= 1.125f; break;
 	case 'Q': g_sphereCamRelPos.y += 1.125f; break;
+	case 'b':
+		g_bBenchmark = !g_bBenchmark;
+		ResetBenchmark();
+		break;
+	case 'p':
+		g_bPrecombineTransforms = !g_bPrecombineTransforms;
+		ResetBenchmark();
+		printf("Transforms: %s\n", g_bPrecombineTransforms ? "precombined" : "per-vertex");
+		break;
 		
 	case 32:
 		g_bDrawLookatPoint = !g_bDrawLookatPoint;
 		printf("Target: %f, %f, %f\n", g_camTarget.x, g_camTarget.y, g_camTarget.z);
 		printf("Position: %f, %f, %f\n", g_sphereCamRelPos.x, g_sphereCamRelPos.y, g_sphereCamRelPos.z);
+		printf("Sphere triangles: %d drawn, %d culled\n", (int)g_sphereCullStats.iTrianglesDrawn,
+			(int)g_sphereCullStats.iTrianglesCulled);
+		printf("Uniforms: %d uploaded, %d skipped\n", g_uniformStats.iNumUploads, g_uniformStats.iNumSkipped);
+		printf("GL state: %d calls made, %d elided\n", g_glState.GetStats().iNumCalls,
+			g_glState.GetStats().iNumElided);
 		break;
 	}
 
@@ -1,10 +1,17 @@
 #version 330
 
 smooth in vec4 interpColor;
+#ifdef MULTIPLY_BASE_COLOR
+uniform vec4 baseColor;
+#endif
 
 out vec4 outputColor;
 
 void main()
 {
+#ifdef MULTIPLY_BASE_COLOR
+	outputColor = interpColor * baseColor;
+#else
 	outputColor = interpColor;
+#endif
 }
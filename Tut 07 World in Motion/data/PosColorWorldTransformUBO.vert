@@ -5,18 +5,24 @@ layout(location = 1) in vec4 color;
 
 smooth out vec4 interpColor;
 
-layout(std140) uniform GlobalMatrices
-{
-	mat4 cameraToClipMatrix;
-	mat4 worldToCameraMatrix;
-};
+//With PRECOMBINED_TRANSFORM, the program is given the whole model-to-clip transform, computed
+//once per object, instead of doing three matrix multiplies for every vertex.
+#ifdef PRECOMBINED_TRANSFORM
+uniform mat4 modelToClipMatrix;
+#else
+#include "GlobalMatrices.glsl"
 
 uniform mat4 modelToWorldMatrix;
+#endif
 
 void main()
 {
+#ifdef PRECOMBINED_TRANSFORM
+	gl_Position = modelToClipMatrix * position;
+#else
 	vec4 temp = modelToWorldMatrix * position;
 	temp = worldToCameraMatrix * temp;
 	gl_Position = cameraToClipMatrix * temp;
+#endif
 	interpColor = color;
 }
@@ -3,20 +3,24 @@
 layout(location = 0) in vec4 position;
 layout(location = 5) in vec2 texCoord;
 
-layout(std140) uniform GlobalMatrices
-{
-	mat4 cameraToClipMatrix;
-	mat4 worldToCameraMatrix;
-};
+#ifdef PRECOMBINED_TRANSFORM
+uniform mat4 modelToClipMatrix;
+#else
+#include "GlobalMatrices.glsl"
 
 uniform mat4 modelToWorldMatrix;
+#endif
 
 out vec2 colorCoord;
 
 void main()
 {
+#ifdef PRECOMBINED_TRANSFORM
+	gl_Position = modelToClipMatrix * position;
+#else
 	vec4 temp = modelToWorldMatrix * position;
 	temp = worldToCameraMatrix * temp;
 	gl_Position = cameraToClipMatrix * temp;
+#endif
 	colorCoord = texCoord;
 }
@@ -0,0 +1,442 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "BatchQuaternion.h"
+
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+#define FRAMEWORK_BATCH_SSE
+#endif
+
+
+namespace Framework
+{
+	void QuatArray::resize(size_t count)
+	{
+		w.resize(count);
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+	}
+
+	void QuatArray::Set(size_t iQuat, const glm::fquat &quat)
+	{
+		w[iQuat] = quat.w;
+		x[iQuat] = quat.x;
+		y[iQuat] = quat.y;
+		z[iQuat] = quat.z;
+	}
+
+	namespace
+	{
+		//Above this cosine, slerp is done as nlerp, since the angle is too small to divide by.
+		const float g_fSlerpCosLimit = 0.9995f;
+
+		void CheckSizes(const QuatArray &first, size_t secondSize)
+		{
+			if(first.size() != secondSize)
+				throw std::runtime_error("The quaternion arrays must be the same size.");
+		}
+
+#ifdef FRAMEWORK_BATCH_SSE
+		//Four quaternions, one component per register.
+		struct Quat4
+		{
+			__m128 w, x, y, z;
+		};
+
+		//Loads count quaternions, up to 4. Missing ones are the identity.
+		Quat4 LoadQuats(const QuatArray &quats, size_t iFirst, size_t count)
+		{
+			Quat4 result;
+			if(count == 4)
+			{
+				result.w = _mm_loadu_ps(&quats.w[iFirst]);
+				result.x = _mm_loadu_ps(&quats.x[iFirst]);
+				result.y = _mm_loadu_ps(&quats.y[iFirst]);
+				result.z = _mm_loadu_ps(&quats.z[iFirst]);
+				return result;
+			}
+
+			float w[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+			float x[4] = {0.0f}, y[4] = {0.0f}, z[4] = {0.0f};
+			for(size_t iQuat = 0; iQuat < count; iQuat++)
+			{
+				w[iQuat] = quats.w[iFirst + iQuat];
+				x[iQuat] = quats.x[iFirst + iQuat];
+				y[iQuat] = quats.y[iFirst + iQuat];
+				z[iQuat] = quats.z[iFirst + iQuat];
+			}
+
+			result.w = _mm_loadu_ps(w);
+			result.x = _mm_loadu_ps(x);
+			result.y = _mm_loadu_ps(y);
+			result.z = _mm_loadu_ps(z);
+			return result;
+		}
+
+		void StoreQuats(const Quat4 &quats, QuatArray &out, size_t iFirst, size_t count)
+		{
+			if(count == 4)
+			{
+				_mm_storeu_ps(&out.w[iFirst], quats.w);
+				_mm_storeu_ps(&out.x[iFirst], quats.x);
+				_mm_storeu_ps(&out.y[iFirst], quats.y);
+				_mm_storeu_ps(&out.z[iFirst], quats.z);
+				return;
+			}
+
+			float w[4], x[4], y[4], z[4];
+			_mm_storeu_ps(w, quats.w);
+			_mm_storeu_ps(x, quats.x);
+			_mm_storeu_ps(y, quats.y);
+			_mm_storeu_ps(z, quats.z);
+			for(size_t iQuat = 0; iQuat < count; iQuat++)
+				out.Set(iFirst + iQuat, glm::fquat(w[iQuat], x[iQuat], y[iQuat], z[iQuat]));
+		}
+
+		__m128 LoadAlphas(const float *pAlphas, size_t count)
+		{
+			float alphas[4] = {0.0f};
+			for(size_t iAlpha = 0; iAlpha < count; iAlpha++)
+				alphas[iAlpha] = pAlphas[iAlpha];
+			return _mm_loadu_ps(alphas);
+		}
+
+		__m128 Dot(const Quat4 &q, const Quat4 &p)
+		{
+			__m128 result = _mm_add_ps(_mm_mul_ps(q.x, p.x), _mm_mul_ps(q.y, p.y));
+			result = _mm_add_ps(result, _mm_mul_ps(q.z, p.z));
+			return _mm_add_ps(result, _mm_mul_ps(q.w, p.w));
+		}
+
+		//The same operations in the same order as glm's operator*.
+		Quat4 Multiply(const Quat4 &q, const Quat4 &p)
+		{
+			Quat4 result;
+			result.w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(q.w, p.w), _mm_mul_ps(q.x, p.x)),
+				_mm_mul_ps(q.y, p.y)), _mm_mul_ps(q.z, p.z));
+			result.x = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(q.w, p.x), _mm_mul_ps(q.x, p.w)),
+				_mm_mul_ps(q.y, p.z)), _mm_mul_ps(q.z, p.y));
+			result.y = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(q.w, p.y), _mm_mul_ps(q.y, p.w)),
+				_mm_mul_ps(q.z, p.x)), _mm_mul_ps(q.x, p.z));
+			result.z = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(q.w, p.z), _mm_mul_ps(q.z, p.w)),
+				_mm_mul_ps(q.x, p.y)), _mm_mul_ps(q.y, p.x));
+			return result;
+		}
+
+		//Negates the quaternions in p whose dot product with q is negative, so that interpolating
+		//between them goes the shorter way. Returns the dot products, made positive.
+		__m128 MakeShortestPath(const Quat4 &q, Quat4 &p)
+		{
+			__m128 cosAngle = Dot(q, p);
+			__m128 flip = _mm_and_ps(_mm_cmplt_ps(cosAngle, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+			p.w = _mm_xor_ps(p.w, flip);
+			p.x = _mm_xor_ps(p.x, flip);
+			p.y = _mm_xor_ps(p.y, flip);
+			p.z = _mm_xor_ps(p.z, flip);
+			return _mm_xor_ps(cosAngle, flip);
+		}
+
+		Quat4 Blend(const Quat4 &q, __m128 qScale, const Quat4 &p, __m128 pScale)
+		{
+			Quat4 result;
+			result.w = _mm_add_ps(_mm_mul_ps(q.w, qScale), _mm_mul_ps(p.w, pScale));
+			result.x = _mm_add_ps(_mm_mul_ps(q.x, qScale), _mm_mul_ps(p.x, pScale));
+			result.y = _mm_add_ps(_mm_mul_ps(q.y, qScale), _mm_mul_ps(p.y, pScale));
+			result.z = _mm_add_ps(_mm_mul_ps(q.z, qScale), _mm_mul_ps(p.z, pScale));
+			return result;
+		}
+
+		Quat4 Normalize(const Quat4 &q)
+		{
+			__m128 length = _mm_sqrt_ps(Dot(q, q));
+			Quat4 result;
+			result.w = _mm_div_ps(q.w, length);
+			result.x = _mm_div_ps(q.x, length);
+			result.y = _mm_div_ps(q.y, length);
+			result.z = _mm_div_ps(q.z, length);
+			return result;
+		}
+
+		//acos for [0, 1], from Abramowitz and Stegun 4.4.46. The error is under 2e-8.
+		__m128 AcosPositive(__m128 value)
+		{
+			__m128 poly = _mm_set1_ps(-0.0012624911f);
+			poly = _mm_add_ps(_mm_mul_ps(poly, value), _mm_set1_ps(0.0066700901f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, value), _mm_set1_ps(-0.0170881256f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, value), _mm_set1_ps(0.0308918810f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, value), _mm_set1_ps(-0.0501743046f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, value), _mm_set1_ps(0.0889789874f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, value), _mm_set1_ps(-0.2145988016f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, value), _mm_set1_ps(1.5707963050f));
+			return _mm_mul_ps(poly, _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), value)));
+		}
+
+		//sin for [0, pi/2], from its Taylor series to the 11th power. The error is under 6e-8.
+		__m128 SinQuarterTurn(__m128 angle)
+		{
+			__m128 angleSq = _mm_mul_ps(angle, angle);
+			__m128 poly = _mm_set1_ps(-1.0f / 39916800.0f);
+			poly = _mm_add_ps(_mm_mul_ps(poly, angleSq), _mm_set1_ps(1.0f / 362880.0f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, angleSq), _mm_set1_ps(-1.0f / 5040.0f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, angleSq), _mm_set1_ps(1.0f / 120.0f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, angleSq), _mm_set1_ps(-1.0f / 6.0f));
+			poly = _mm_add_ps(_mm_mul_ps(poly, angleSq), _mm_set1_ps(1.0f));
+			return _mm_mul_ps(poly, angle);
+		}
+
+		Quat4 Nlerp(const Quat4 &from, Quat4 to, __m128 alpha)
+		{
+			MakeShortestPath(from, to);
+			return Normalize(Blend(from, _mm_sub_ps(_mm_set1_ps(1.0f), alpha), to, alpha));
+		}
+
+		Quat4 Slerp(const Quat4 &from, Quat4 to, __m128 alpha)
+		{
+			__m128 cosAngle = _mm_min_ps(MakeShortestPath(from, to), _mm_set1_ps(1.0f));
+			__m128 oneMinusAlpha = _mm_sub_ps(_mm_set1_ps(1.0f), alpha);
+
+			__m128 angle = AcosPositive(cosAngle);
+			__m128 sinAngle = _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(cosAngle, cosAngle)));
+			__m128 fromScale = _mm_div_ps(SinQuarterTurn(_mm_mul_ps(oneMinusAlpha, angle)), sinAngle);
+			__m128 toScale = _mm_div_ps(SinQuarterTurn(_mm_mul_ps(alpha, angle)), sinAngle);
+
+			//Nearly equal quaternions are lerped instead.
+			__m128 useLerp = _mm_cmpgt_ps(cosAngle, _mm_set1_ps(g_fSlerpCosLimit));
+			fromScale = _mm_or_ps(_mm_and_ps(useLerp, oneMinusAlpha), _mm_andnot_ps(useLerp, fromScale));
+			toScale = _mm_or_ps(_mm_and_ps(useLerp, alpha), _mm_andnot_ps(useLerp, toScale));
+
+			//The approximations leave the length slightly off.
+			return Normalize(Blend(from, fromScale, to, toScale));
+		}
+
+		//Columns 0 to 2 of mat3_cast, with the same operations in the same order. columns[i][j]
+		//is the j component of column i, for each of the four quaternions.
+		void RotationColumns(const Quat4 &q, __m128 columns[3][3])
+		{
+			__m128 one = _mm_set1_ps(1.0f);
+			__m128 twoX = _mm_add_ps(q.x, q.x);
+			__m128 twoY = _mm_add_ps(q.y, q.y);
+			__m128 twoZ = _mm_add_ps(q.z, q.z);
+			__m128 twoW = _mm_add_ps(q.w, q.w);
+
+			__m128 xx = _mm_mul_ps(twoX, q.x);
+			__m128 yy = _mm_mul_ps(twoY, q.y);
+			__m128 zz = _mm_mul_ps(twoZ, q.z);
+			__m128 xy = _mm_mul_ps(twoX, q.y);
+			__m128 xz = _mm_mul_ps(twoX, q.z);
+			__m128 yz = _mm_mul_ps(twoY, q.z);
+			__m128 wx = _mm_mul_ps(twoW, q.x);
+			__m128 wy = _mm_mul_ps(twoW, q.y);
+			__m128 wz = _mm_mul_ps(twoW, q.z);
+
+			columns[0][0] = _mm_sub_ps(_mm_sub_ps(one, yy), zz);
+			columns[0][1] = _mm_add_ps(xy, wz);
+			columns[0][2] = _mm_sub_ps(xz, wy);
+
+			columns[1][0] = _mm_sub_ps(xy, wz);
+			columns[1][1] = _mm_sub_ps(_mm_sub_ps(one, xx), zz);
+			columns[1][2] = _mm_add_ps(yz, wx);
+
+			columns[2][0] = _mm_add_ps(xz, wy);
+			columns[2][1] = _mm_sub_ps(yz, wx);
+			columns[2][2] = _mm_sub_ps(_mm_sub_ps(one, xx), yy);
+		}
+
+		template<typename Op>
+		void RunBlocks(const QuatArray &from, const QuatArray &to, const float *pAlphas, float alpha,
+			QuatArray &out, Op op)
+		{
+			for(size_t iFirst = 0; iFirst < from.size(); iFirst += 4)
+			{
+				size_t count = std::min(from.size() - iFirst, (size_t)4);
+				__m128 alphas = pAlphas ? LoadAlphas(pAlphas + iFirst, count) : _mm_set1_ps(alpha);
+				if(pAlphas && count == 4)
+					alphas = _mm_loadu_ps(pAlphas + iFirst);
+
+				Quat4 result = op(LoadQuats(from, iFirst, count), LoadQuats(to, iFirst, count), alphas);
+				StoreQuats(result, out, iFirst, count);
+			}
+		}
+#else
+		glm::fquat Nlerp(const glm::fquat &from, glm::fquat to, float alpha)
+		{
+			if(glm::dot(from, to) < 0.0f)
+				to = -to;
+			return glm::normalize(from * (1.0f - alpha) + to * alpha);
+		}
+
+		glm::fquat Slerp(const glm::fquat &from, glm::fquat to, float alpha)
+		{
+			float cosAngle = glm::dot(from, to);
+			if(cosAngle < 0.0f)
+			{
+				to = -to;
+				cosAngle = -cosAngle;
+			}
+
+			if(cosAngle > g_fSlerpCosLimit)
+				return glm::normalize(from * (1.0f - alpha) + to * alpha);
+
+			float angle = acosf(cosAngle);
+			return (from * sinf((1.0f - alpha) * angle) + to * sinf(alpha * angle)) / sinf(angle);
+		}
+
+		template<typename Op>
+		void RunBlocks(const QuatArray &from, const QuatArray &to, const float *pAlphas, float alpha,
+			QuatArray &out, Op op)
+		{
+			for(size_t iQuat = 0; iQuat < from.size(); iQuat++)
+				out.Set(iQuat, op(from.Get(iQuat), to.Get(iQuat), pAlphas ? pAlphas[iQuat] : alpha));
+		}
+#endif
+
+		template<typename Op>
+		void Interpolate(const QuatArray &from, const QuatArray &to, const float *pAlphas, float alpha,
+			QuatArray &out, Op op)
+		{
+			CheckSizes(from, to.size());
+			out.resize(from.size());
+			RunBlocks(from, to, pAlphas, alpha, out, op);
+		}
+
+		const float *GetAlphas(const QuatArray &quats, const std::vector<float> &alphas)
+		{
+			CheckSizes(quats, alphas.size());
+			return alphas.empty() ? NULL : &alphas[0];
+		}
+	}
+
+	void MultiplyQuats(const QuatArray &left, const QuatArray &right, QuatArray &out)
+	{
+		CheckSizes(left, right.size());
+		out.resize(left.size());
+#ifdef FRAMEWORK_BATCH_SSE
+		for(size_t iFirst = 0; iFirst < left.size(); iFirst += 4)
+		{
+			size_t count = std::min(left.size() - iFirst, (size_t)4);
+			StoreQuats(Multiply(LoadQuats(left, iFirst, count), LoadQuats(right, iFirst, count)),
+				out, iFirst, count);
+		}
+#else
+		for(size_t iQuat = 0; iQuat < left.size(); iQuat++)
+			out.Set(iQuat, left.Get(iQuat) * right.Get(iQuat));
+#endif
+	}
+
+	void NlerpQuats(const QuatArray &from, const QuatArray &to, float alpha, QuatArray &out)
+	{
+		Interpolate(from, to, NULL, alpha, out, Nlerp);
+	}
+
+	void NlerpQuats(const QuatArray &from, const QuatArray &to, const std::vector<float> &alphas,
+		QuatArray &out)
+	{
+		Interpolate(from, to, GetAlphas(from, alphas), 0.0f, out, Nlerp);
+	}
+
+	void SlerpQuats(const QuatArray &from, const QuatArray &to, float alpha, QuatArray &out)
+	{
+		Interpolate(from, to, NULL, alpha, out, Slerp);
+	}
+
+	void SlerpQuats(const QuatArray &from, const QuatArray &to, const std::vector<float> &alphas,
+		QuatArray &out)
+	{
+		Interpolate(from, to, GetAlphas(from, alphas), 0.0f, out, Slerp);
+	}
+
+	void QuatsToMatrices(const QuatArray &quats, glm::mat4 *pOut)
+	{
+#ifdef FRAMEWORK_BATCH_SSE
+		for(size_t iFirst = 0; iFirst < quats.size(); iFirst += 4)
+		{
+			size_t count = std::min(quats.size() - iFirst, (size_t)4);
+			__m128 columns[3][3];
+			RotationColumns(LoadQuats(quats, iFirst, count), columns);
+
+			//Transposing gives the column for each of the four matrices.
+			__m128 matrixColumns[3][4];
+			for(int iColumn = 0; iColumn < 3; iColumn++)
+			{
+				matrixColumns[iColumn][0] = columns[iColumn][0];
+				matrixColumns[iColumn][1] = columns[iColumn][1];
+				matrixColumns[iColumn][2] = columns[iColumn][2];
+				matrixColumns[iColumn][3] = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(matrixColumns[iColumn][0], matrixColumns[iColumn][1],
+					matrixColumns[iColumn][2], matrixColumns[iColumn][3]);
+			}
+
+			for(size_t iQuat = 0; iQuat < count; iQuat++)
+			{
+				glm::mat4 &theMatrix = pOut[iFirst + iQuat];
+				_mm_storeu_ps(&theMatrix[0][0], matrixColumns[0][iQuat]);
+				_mm_storeu_ps(&theMatrix[1][0], matrixColumns[1][iQuat]);
+				_mm_storeu_ps(&theMatrix[2][0], matrixColumns[2][iQuat]);
+				theMatrix[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+			}
+		}
+#else
+		for(size_t iQuat = 0; iQuat < quats.size(); iQuat++)
+			pOut[iQuat] = glm::mat4_cast(quats.Get(iQuat));
+#endif
+	}
+
+	void QuatsToRows3x4(const QuatArray &quats, const glm::vec3 *pTranslations, glm::vec4 *pOutRows)
+	{
+#ifdef FRAMEWORK_BATCH_SSE
+		for(size_t iFirst = 0; iFirst < quats.size(); iFirst += 4)
+		{
+			size_t count = std::min(quats.size() - iFirst, (size_t)4);
+			__m128 columns[3][3];
+			RotationColumns(LoadQuats(quats, iFirst, count), columns);
+
+			float translations[3][4] = {{0.0f}};
+			for(size_t iQuat = 0; pTranslations && iQuat < count; iQuat++)
+			{
+				translations[0][iQuat] = pTranslations[iFirst + iQuat].x;
+				translations[1][iQuat] = pTranslations[iFirst + iQuat].y;
+				translations[2][iQuat] = pTranslations[iFirst + iQuat].z;
+			}
+
+			//Row i of each matrix is component i of the three columns, then the translation.
+			__m128 rows[3][4];
+			for(int iRow = 0; iRow < 3; iRow++)
+			{
+				rows[iRow][0] = columns[0][iRow];
+				rows[iRow][1] = columns[1][iRow];
+				rows[iRow][2] = columns[2][iRow];
+				rows[iRow][3] = _mm_loadu_ps(translations[iRow]);
+				_MM_TRANSPOSE4_PS(rows[iRow][0], rows[iRow][1], rows[iRow][2], rows[iRow][3]);
+			}
+
+			for(size_t iQuat = 0; iQuat < count; iQuat++)
+			{
+				glm::vec4 *pRows = pOutRows + (iFirst + iQuat) * 3;
+				_mm_storeu_ps(&pRows[0][0], rows[0][iQuat]);
+				_mm_storeu_ps(&pRows[1][0], rows[1][iQuat]);
+				_mm_storeu_ps(&pRows[2][0], rows[2][iQuat]);
+			}
+		}
+#else
+		for(size_t iQuat = 0; iQuat < quats.size(); iQuat++)
+		{
+			glm::mat3 rotation = glm::mat3_cast(quats.Get(iQuat));
+			glm::vec3 translation = pTranslations ? pTranslations[iQuat] : glm::vec3(0.0f);
+			for(int iRow = 0; iRow < 3; iRow++)
+			{
+				pOutRows[iQuat * 3 + iRow] = glm::vec4(rotation[0][iRow], rotation[1][iRow],
+					rotation[2][iRow], translation[iRow]);
+			}
+		}
+#endif
+	}
+}
@@ -0,0 +1,60 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_BATCH_QUATERNION_H
+#define FRAMEWORK_BATCH_QUATERNION_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Framework
+{
+	//An array of quaternions, stored as one array per component so that four can be worked on
+	//at once. For animating many objects; one-off quaternions should just use glm::fquat.
+	struct QuatArray
+	{
+		std::vector<float> w;
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+
+		size_t size() const {return w.size();}
+		void resize(size_t count);
+
+		glm::fquat Get(size_t iQuat) const {return glm::fquat(w[iQuat], x[iQuat], y[iQuat], z[iQuat]);}
+		void Set(size_t iQuat, const glm::fquat &quat);
+	};
+
+	//These resize the output to match the inputs, whose sizes must be the same. The output may be
+	//the same array as an input.
+
+	//out[i] = left[i] * right[i]. The same as glm's operator*, bit for bit.
+	void MultiplyQuats(const QuatArray &left, const QuatArray &right, QuatArray &out);
+
+	//Normalized linear interpolation, along the shorter way around. The rate of rotation is not
+	//constant, but it is cheap, and within 0.0001 radians of slerp for steps of up to 10 degrees.
+	void NlerpQuats(const QuatArray &from, const QuatArray &to, float alpha, QuatArray &out);
+	void NlerpQuats(const QuatArray &from, const QuatArray &to, const std::vector<float> &alphas,
+		QuatArray &out);
+
+	//Spherical linear interpolation, along the shorter way around. With SSE2, it uses polynomial
+	//approximations of acos and sin; the results are unit length and within 1e-6 radians of an
+	//exact slerp of unit quaternions.
+	void SlerpQuats(const QuatArray &from, const QuatArray &to, float alpha, QuatArray &out);
+	void SlerpQuats(const QuatArray &from, const QuatArray &to, const std::vector<float> &alphas,
+		QuatArray &out);
+
+	//pOut must have room for quats.size() matrices. The same as glm::mat4_cast, bit for bit.
+	void QuatsToMatrices(const QuatArray &quats, glm::mat4 *pOut);
+
+	//Writes the rotations, with the given translations, as 3x4 row-major matrices: three
+	//glm::vec4 per quaternion, each a row of the rotation with the translation in w. This is the
+	//compact form for per-instance transforms. pTranslations may be NULL for no translation.
+	//pOutRows must have room for 3 * quats.size() rows.
+	void QuatsToRows3x4(const QuatArray &quats, const glm::vec3 *pTranslations, glm::vec4 *pOutRows);
+}
+
+
+#endif //FRAMEWORK_BATCH_QUATERNION_H
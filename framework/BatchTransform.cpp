@@ -0,0 +1,218 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include "BatchTransform.h"
+#include "ParallelFor.h"
+
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+#define FRAMEWORK_BATCH_SSE
+#endif
+
+
+namespace Framework
+{
+	namespace
+	{
+		//Below this many items per thread, starting the threads costs more than they save.
+		const size_t g_minPointsPerThread = 32768;
+		const size_t g_minMatricesPerThread = 8192;
+
+#ifdef FRAMEWORK_BATCH_SSE
+		struct SSEMatrix
+		{
+			explicit SSEMatrix(const glm::mat4 &theMatrix)
+			{
+				glm::detail::sse_load_ps(theMatrix, columns);
+			}
+
+			__m128 Transform(__m128 vec) const {return glm::detail::sse_mul_ps(columns, vec);}
+
+			__m128 columns[4];
+		};
+#endif
+
+		struct PointKernel
+		{
+			const glm::mat4 *pMatrix;
+			const glm::vec3 *pPoints;
+			glm::vec3 *pOut3;
+			glm::vec4 *pOut4;
+
+			void operator()(size_t begin, size_t end) const
+			{
+#ifdef FRAMEWORK_BATCH_SSE
+				SSEMatrix theMatrix(*pMatrix);
+				for(size_t iPoint = begin; iPoint < end; iPoint++)
+				{
+					const glm::vec3 &point = pPoints[iPoint];
+					__m128 result = theMatrix.Transform(_mm_setr_ps(point.x, point.y, point.z, 1.0f));
+					if(pOut4)
+						_mm_storeu_ps(&pOut4[iPoint][0], result);
+					else
+					{
+						_mm_storel_pi((__m64 *)&pOut3[iPoint][0], result);
+						_mm_store_ss(&pOut3[iPoint][2], _mm_movehl_ps(result, result));
+					}
+				}
+#else
+				for(size_t iPoint = begin; iPoint < end; iPoint++)
+				{
+					glm::vec4 result = *pMatrix * glm::vec4(pPoints[iPoint], 1.0f);
+					if(pOut4)
+						pOut4[iPoint] = result;
+					else
+						pOut3[iPoint] = glm::vec3(result);
+				}
+#endif
+			}
+		};
+
+		struct VectorKernel
+		{
+			const glm::mat4 *pMatrix;
+			const glm::vec4 *pVectors;
+			glm::vec4 *pOut;
+
+			void operator()(size_t begin, size_t end) const
+			{
+#ifdef FRAMEWORK_BATCH_SSE
+				SSEMatrix theMatrix(*pMatrix);
+				for(size_t iVec = begin; iVec < end; iVec++)
+					_mm_storeu_ps(&pOut[iVec][0], theMatrix.Transform(_mm_loadu_ps(&pVectors[iVec][0])));
+#else
+				for(size_t iVec = begin; iVec < end; iVec++)
+					pOut[iVec] = *pMatrix * pVectors[iVec];
+#endif
+			}
+		};
+
+		struct SoAKernel
+		{
+			const glm::mat4 *pMatrix;
+			const float *pX;
+			const float *pY;
+			const float *pZ;
+			float *pOut[4];
+
+			//The same operations in the same order as glm's mat4 * vec4, with w = 1.
+			void TransformPoint(size_t iPoint) const
+			{
+				const glm::mat4 &theMatrix = *pMatrix;
+				glm::vec4 point(pX[iPoint], pY[iPoint], pZ[iPoint], 1.0f);
+				for(int iComp = 0; iComp < 4; iComp++)
+				{
+					if(pOut[iComp])
+					{
+						pOut[iComp][iPoint] = theMatrix[0][iComp] * point.x + theMatrix[1][iComp] * point.y +
+							theMatrix[2][iComp] * point.z + theMatrix[3][iComp];
+					}
+				}
+			}
+
+			void operator()(size_t begin, size_t end) const
+			{
+				size_t iPoint = begin;
+#ifdef FRAMEWORK_BATCH_SSE
+				//Each matrix element, in all four components.
+				__m128 elements[4][4];
+				for(int iColumn = 0; iColumn < 4; iColumn++)
+				{
+					for(int iComp = 0; iComp < 4; iComp++)
+						elements[iColumn][iComp] = _mm_set1_ps((*pMatrix)[iColumn][iComp]);
+				}
+
+				for(; iPoint + 4 <= end; iPoint += 4)
+				{
+					__m128 x = _mm_loadu_ps(pX + iPoint);
+					__m128 y = _mm_loadu_ps(pY + iPoint);
+					__m128 z = _mm_loadu_ps(pZ + iPoint);
+					for(int iComp = 0; iComp < 4; iComp++)
+					{
+						if(!pOut[iComp])
+							continue;
+
+						__m128 result = _mm_add_ps(_mm_mul_ps(elements[0][iComp], x),
+							_mm_mul_ps(elements[1][iComp], y));
+						result = _mm_add_ps(result, _mm_mul_ps(elements[2][iComp], z));
+						result = _mm_add_ps(result, elements[3][iComp]);
+						_mm_storeu_ps(pOut[iComp] + iPoint, result);
+					}
+				}
+#endif
+				for(; iPoint < end; iPoint++)
+					TransformPoint(iPoint);
+			}
+		};
+
+		struct MultiplyKernel
+		{
+			const glm::mat4 *pLeft;			//One matrix for all if bSameLeft.
+			const unsigned int *pLeftIndices;			//NULL to pair the matrices up in order.
+			const glm::mat4 *pRight;
+			glm::mat4 *pOut;
+			bool bSameLeft;
+
+			void operator()(size_t begin, size_t end) const
+			{
+				for(size_t iMatrix = begin; iMatrix < end; iMatrix++)
+				{
+					size_t iLeft = bSameLeft ? 0 : (pLeftIndices ? pLeftIndices[iMatrix] : iMatrix);
+					pOut[iMatrix] = pLeft[iLeft] * pRight[iMatrix];
+				}
+			}
+		};
+	}
+
+	void TransformPoints(const glm::mat4 &theMatrix, const glm::vec3 *pPoints, glm::vec3 *pOut,
+		size_t count, unsigned int numThreads)
+	{
+		PointKernel kernel = {&theMatrix, pPoints, pOut, NULL};
+		ParallelFor(kernel, count, g_minPointsPerThread, numThreads);
+	}
+
+	void TransformPoints(const glm::mat4 &theMatrix, const glm::vec3 *pPoints, glm::vec4 *pOut,
+		size_t count, unsigned int numThreads)
+	{
+		PointKernel kernel = {&theMatrix, pPoints, NULL, pOut};
+		ParallelFor(kernel, count, g_minPointsPerThread, numThreads);
+	}
+
+	void TransformVectors(const glm::mat4 &theMatrix, const glm::vec4 *pVectors, glm::vec4 *pOut,
+		size_t count, unsigned int numThreads)
+	{
+		VectorKernel kernel = {&theMatrix, pVectors, pOut};
+		ParallelFor(kernel, count, g_minPointsPerThread, numThreads);
+	}
+
+	void TransformPointsSoA(const glm::mat4 &theMatrix, const float *pX, const float *pY, const float *pZ,
+		float *pOutX, float *pOutY, float *pOutZ, float *pOutW, size_t count, unsigned int numThreads)
+	{
+		//Ranges start on multiples of 4, so each thread's loads line up with the arrays.
+		SoAKernel kernel = {&theMatrix, pX, pY, pZ, {pOutX, pOutY, pOutZ, pOutW}};
+		ParallelFor(kernel, count, g_minPointsPerThread, numThreads, 4);
+	}
+
+	void MultiplyMatrices(const glm::mat4 *pLeft, const glm::mat4 *pRight, glm::mat4 *pOut,
+		size_t count, unsigned int numThreads)
+	{
+		MultiplyKernel kernel = {pLeft, NULL, pRight, pOut, false};
+		ParallelFor(kernel, count, g_minMatricesPerThread, numThreads);
+	}
+
+	void MultiplyMatrices(const glm::mat4 &left, const glm::mat4 *pRight, glm::mat4 *pOut,
+		size_t count, unsigned int numThreads)
+	{
+		MultiplyKernel kernel = {&left, NULL, pRight, pOut, true};
+		ParallelFor(kernel, count, g_minMatricesPerThread, numThreads);
+	}
+
+	void MultiplyMatrices(const glm::mat4 *pParents, const unsigned int *pParentIndices,
+		const glm::mat4 *pLocals, glm::mat4 *pOut, size_t count, unsigned int numThreads)
+	{
+		MultiplyKernel kernel = {pParents, pParentIndices, pLocals, pOut, false};
+		ParallelFor(kernel, count, g_minMatricesPerThread, numThreads);
+	}
+}
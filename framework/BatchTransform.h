@@ -0,0 +1,49 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_BATCH_TRANSFORM_H
+#define FRAMEWORK_BATCH_TRANSFORM_H
+
+#include <glm/glm.hpp>
+
+namespace Framework
+{
+	//Applies matrices to whole arrays at once, for instancing, culling and baking. Arrays may have
+	//any alignment, though 16-byte aligned ones load faster. The output may be the same array as
+	//an input, but must not partly overlap one.
+	//
+	//Large batches are split across threads. If numThreads is 0, one thread per hardware core is
+	//used. Batches too small to gain from more threads are done on the calling thread.
+
+	//Transforms points, with a w of 1. Only x, y and z of the result are kept, so theMatrix
+	//should be affine. Use the glm::vec4 output for projections.
+	void TransformPoints(const glm::mat4 &theMatrix, const glm::vec3 *pPoints, glm::vec3 *pOut,
+		size_t count, unsigned int numThreads = 0);
+	void TransformPoints(const glm::mat4 &theMatrix, const glm::vec3 *pPoints, glm::vec4 *pOut,
+		size_t count, unsigned int numThreads = 0);
+
+	void TransformVectors(const glm::mat4 &theMatrix, const glm::vec4 *pVectors, glm::vec4 *pOut,
+		size_t count, unsigned int numThreads = 0);
+
+	//Transforms points stored as separate x, y and z arrays, with a w of 1. pOutW may be NULL if
+	//theMatrix is affine and w is not wanted.
+	void TransformPointsSoA(const glm::mat4 &theMatrix, const float *pX, const float *pY, const float *pZ,
+		float *pOutX, float *pOutY, float *pOutZ, float *pOutW, size_t count, unsigned int numThreads = 0);
+
+	//pOut[i] = pLeft[i] * pRight[i].
+	void MultiplyMatrices(const glm::mat4 *pLeft, const glm::mat4 *pRight, glm::mat4 *pOut,
+		size_t count, unsigned int numThreads = 0);
+
+	//pOut[i] = left * pRight[i].
+	void MultiplyMatrices(const glm::mat4 &left, const glm::mat4 *pRight, glm::mat4 *pOut,
+		size_t count, unsigned int numThreads = 0);
+
+	//pOut[i] = pParents[pParentIndices[i]] * pLocals[i], for one level of a hierarchy at a time.
+	//pOut must not be the same array as pParents.
+	void MultiplyMatrices(const glm::mat4 *pParents, const unsigned int *pParentIndices,
+		const glm::mat4 *pLocals, glm::mat4 *pOut, size_t count, unsigned int numThreads = 0);
+}
+
+
+#endif //FRAMEWORK_BATCH_TRANSFORM_H
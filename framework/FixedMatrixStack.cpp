@@ -0,0 +1,229 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <assert.h>
+#include <math.h>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include "framework.h"
+#include "FixedMatrixStack.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		bool IsAffineMatrix(const glm::mat4 &theMatrix)
+		{
+			return theMatrix[0].w == 0.0f && theMatrix[1].w == 0.0f && theMatrix[2].w == 0.0f &&
+				theMatrix[3].w == 1.0f;
+		}
+
+		//Right-multiplies by a rotation in the plane of columns iFirst and iSecond. Only those two
+		//columns change, so this is 8 multiply-adds instead of 64.
+		void RotateColumns(glm::mat4 &theMatrix, int iFirst, int iSecond, float angRadCCW)
+		{
+			float fCos = cosf(angRadCCW);
+			float fSin = sinf(angRadCCW);
+			glm::vec4 first = theMatrix[iFirst];
+			glm::vec4 second = theMatrix[iSecond];
+			theMatrix[iFirst] = first * fCos + second * fSin;
+			theMatrix[iSecond] = second * fCos - first * fSin;
+		}
+
+		glm::mat4 MakeRotation(const glm::vec3 &axisOfRotation, float angRadCCW)
+		{
+			float fCos = cosf(angRadCCW);
+			float fInvCos = 1.0f - fCos;
+			float fSin = sinf(angRadCCW);
+			glm::vec3 axis = glm::normalize(axisOfRotation);
+
+			glm::mat4 theMat(1.0f);
+			theMat[0].x = (axis.x * axis.x) + ((1 - axis.x * axis.x) * fCos);
+			theMat[1].x = axis.x * axis.y * (fInvCos) - (axis.z * fSin);
+			theMat[2].x = axis.x * axis.z * (fInvCos) + (axis.y * fSin);
+
+			theMat[0].y = axis.x * axis.y * (fInvCos) + (axis.z * fSin);
+			theMat[1].y = (axis.y * axis.y) + ((1 - axis.y * axis.y) * fCos);
+			theMat[2].y = axis.y * axis.z * (fInvCos) - (axis.x * fSin);
+
+			theMat[0].z = axis.x * axis.z * (fInvCos) - (axis.y * fSin);
+			theMat[1].z = axis.y * axis.z * (fInvCos) + (axis.x * fSin);
+			theMat[2].z = (axis.z * axis.z) + ((1 - axis.z * axis.z) * fCos);
+			return theMat;
+		}
+	}
+
+	FixedMatrixStack::FixedMatrixStack(glm::mat4 *pStorage, size_t capacity, const glm::mat4 &initialMatrix)
+		: m_currMatrix(initialMatrix)
+		, m_pStorage(pStorage)
+		, m_capacity(capacity)
+		, m_depth(0)
+		, m_bAffine(IsAffineMatrix(initialMatrix))
+	{}
+
+	void FixedMatrixStack::Push()
+	{
+		assert(m_depth < m_capacity && "FixedMatrixStack overflow");
+		m_pStorage[m_depth++] = m_currMatrix;
+	}
+
+	void FixedMatrixStack::Pop()
+	{
+		assert(m_depth > 0 && "FixedMatrixStack underflow");
+		m_currMatrix = m_pStorage[--m_depth];
+		m_bAffine = IsAffineMatrix(m_currMatrix);
+	}
+
+	void FixedMatrixStack::Reset()
+	{
+		assert(m_depth > 0 && "FixedMatrixStack underflow");
+		m_currMatrix = m_pStorage[m_depth - 1];
+		m_bAffine = IsAffineMatrix(m_currMatrix);
+	}
+
+	//Right-multiplying by a translation, scale or rotation only adds together multiples of the first
+	//three columns, so these work on the columns directly instead of doing a full multiply. That
+	//holds whether or not the current matrix is affine, and keeps it affine if it was.
+	void FixedMatrixStack::Rotate(const glm::vec3 axis, float angDegCCW)
+	{
+		RotateRadians(axis, DegToRad(angDegCCW));
+	}
+
+	void FixedMatrixStack::RotateRadians(const glm::vec3 axis, float angRadCCW)
+	{
+		glm::mat4 rotation = MakeRotation(axis, angRadCCW);
+		glm::vec4 column0 = m_currMatrix[0];
+		glm::vec4 column1 = m_currMatrix[1];
+		glm::vec4 column2 = m_currMatrix[2];
+		for(int iColumn = 0; iColumn < 3; iColumn++)
+		{
+			m_currMatrix[iColumn] = column0 * rotation[iColumn].x + column1 * rotation[iColumn].y +
+				column2 * rotation[iColumn].z;
+		}
+	}
+
+	void FixedMatrixStack::RotateX(float angDegCCW)
+	{
+		RotateColumns(m_currMatrix, 1, 2, DegToRad(angDegCCW));
+	}
+
+	void FixedMatrixStack::RotateY(float angDegCCW)
+	{
+		RotateColumns(m_currMatrix, 2, 0, DegToRad(angDegCCW));
+	}
+
+	void FixedMatrixStack::RotateZ(float angDegCCW)
+	{
+		RotateColumns(m_currMatrix, 0, 1, DegToRad(angDegCCW));
+	}
+
+	void FixedMatrixStack::Scale(const glm::vec3 &scaleVec)
+	{
+		m_currMatrix[0] *= scaleVec.x;
+		m_currMatrix[1] *= scaleVec.y;
+		m_currMatrix[2] *= scaleVec.z;
+	}
+
+	void FixedMatrixStack::Translate(const glm::vec3 &offsetVec)
+	{
+		m_currMatrix[3] += m_currMatrix[0] * offsetVec.x + m_currMatrix[1] * offsetVec.y +
+			m_currMatrix[2] * offsetVec.z;
+	}
+
+	void FixedMatrixStack::LookAt(const glm::vec3 &cameraPos, const glm::vec3 &lookatPos, const glm::vec3 &upDir)
+	{
+		glm::vec3 lookDir = glm::normalize(lookatPos - cameraPos);
+		glm::vec3 rightDir = glm::normalize(glm::cross(lookDir, glm::normalize(upDir)));
+		glm::vec3 perpUpDir = glm::cross(rightDir, lookDir);
+
+		glm::mat4 cameraToWorld(1.0f);
+		cameraToWorld[0] = glm::vec4(rightDir, 0.0f);
+		cameraToWorld[1] = glm::vec4(perpUpDir, 0.0f);
+		cameraToWorld[2] = glm::vec4(-lookDir, 0.0f);
+		cameraToWorld[3] = glm::vec4(cameraPos, 1.0f);
+
+		ApplyMatrix(glm::rigidInverse(cameraToWorld));
+	}
+
+	void FixedMatrixStack::Perspective(float degFOV, float aspectRatio, float zNear, float zFar)
+	{
+		float frustumScale = 1.0f / tanf(DegToRad(degFOV) / 2.0f);
+
+		glm::mat4 theMat(0.0f);
+		theMat[0].x = frustumScale / aspectRatio;
+		theMat[1].y = frustumScale;
+		theMat[2].z = (zFar + zNear) / (zNear - zFar);
+		theMat[2].w = -1.0f;
+		theMat[3].z = (2 * zFar * zNear) / (zNear - zFar);
+
+		ApplyMatrix(theMat);
+	}
+
+	void FixedMatrixStack::Orthographic(float left, float right, float bottom, float top, float zNear, float zFar)
+	{
+		glm::mat4 theMat(1.0f);
+		theMat[0].x = 2.0f / (right - left);
+		theMat[1].y = 2.0f / (top - bottom);
+		theMat[2].z = -2.0f / (zFar - zNear);
+		theMat[3].x = -(right + left) / (right - left);
+		theMat[3].y = -(top + bottom) / (top - bottom);
+		theMat[3].z = -(zFar + zNear) / (zFar - zNear);
+
+		ApplyMatrix(theMat);
+	}
+
+	void FixedMatrixStack::PixelPerfectOrtho(glm::ivec2 size, glm::vec2 depthRange, bool isTopLeft)
+	{
+		if(isTopLeft)
+		{
+			Translate(-1.0f, 1.0f, (depthRange.x + depthRange.y) / 2.0f);
+			Scale(2.0f / size.x, -2.0f / size.y, 1.0f);
+		}
+		else
+		{
+			Translate(-1.0f, -1.0f, (depthRange.x + depthRange.y) / 2.0f);
+			Scale(2.0f / size.x, 2.0f / size.y, 1.0f);
+		}
+
+		Scale(1.0f, 1.0f, 2.0f / (depthRange.y - depthRange.x));
+	}
+
+	void FixedMatrixStack::ApplyMatrix(const glm::mat4 &theMatrix)
+	{
+		if(!m_bAffine || !IsAffineMatrix(theMatrix))
+		{
+			m_currMatrix *= theMatrix;
+			m_bAffine = IsAffineMatrix(m_currMatrix);
+			return;
+		}
+
+		//Both have a bottom row of (0, 0, 0, 1), so the product's is known, and the other column
+		//entries need only 3 terms: 36 multiply-adds instead of 64.
+		glm::mat4 result(1.0f);
+		for(int iColumn = 0; iColumn < 4; iColumn++)
+		{
+			const glm::vec4 &column = theMatrix[iColumn];
+			glm::vec3 product = glm::vec3(m_currMatrix[0]) * column.x + glm::vec3(m_currMatrix[1]) * column.y +
+				glm::vec3(m_currMatrix[2]) * column.z;
+			result[iColumn] = glm::vec4(product, column.w);
+		}
+
+		result[3] += glm::vec4(glm::vec3(m_currMatrix[3]), 0.0f);
+		m_currMatrix = result;
+	}
+
+	void FixedMatrixStack::SetMatrix(const glm::mat4 &theMatrix)
+	{
+		m_currMatrix = theMatrix;
+		m_bAffine = IsAffineMatrix(theMatrix);
+	}
+
+	void FixedMatrixStack::SetIdentity()
+	{
+		m_currMatrix = glm::mat4(1.0f);
+		m_bAffine = true;
+	}
+}
@@ -0,0 +1,118 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_FIXED_MATRIX_STACK_H
+#define FRAMEWORK_FIXED_MATRIX_STACK_H
+
+#include <glm/glm.hpp>
+
+namespace Framework
+{
+	//The same interface as glutil::MatrixStack, but the preserved matrices are kept in storage
+	//given by the derived class, so the stack never allocates. Make stacks as InlineMatrixStack,
+	//and pass them around as FixedMatrixStack, which works for any depth.
+	//
+	//Pushing past the capacity, or popping an empty stack, is checked in debug builds only.
+	class FixedMatrixStack
+	{
+	public:
+		void Push();
+		void Pop();
+		//Restores the current matrix to the most recently preserved one, without popping it.
+		void Reset();
+
+		const glm::mat4 &Top() const {return m_currMatrix;}
+		size_t GetDepth() const {return m_depth;}
+		size_t GetCapacity() const {return m_capacity;}
+		bool IsAffine() const {return m_bAffine;}
+
+		//Angles are counter-clockwise.
+		void Rotate(const glm::vec3 axis, float angDegCCW);
+		void RotateRadians(const glm::vec3 axis, float angRadCCW);
+		void RotateX(float angDegCCW);
+		void RotateY(float angDegCCW);
+		void RotateZ(float angDegCCW);
+
+		void Scale(const glm::vec3 &scaleVec);
+		void Scale(float scaleX, float scaleY, float scaleZ) {Scale(glm::vec3(scaleX, scaleY, scaleZ));}
+		void Scale(float uniformScale) {Scale(glm::vec3(uniformScale));}
+
+		void Translate(const glm::vec3 &offsetVec);
+		void Translate(float transX, float transY, float transZ) {Translate(glm::vec3(transX, transY, transZ));}
+
+		void LookAt(const glm::vec3 &cameraPos, const glm::vec3 &lookatPos, const glm::vec3 &upDir);
+
+		void Perspective(float degFOV, float aspectRatio, float zNear, float zFar);
+		void Orthographic(float left, float right, float bottom, float top, float zNear = -1.0f, float zFar = 1.0f);
+		void PixelPerfectOrtho(glm::ivec2 size, glm::vec2 depthRange, bool isTopLeft = true);
+
+		void ApplyMatrix(const glm::mat4 &theMatrix);
+		FixedMatrixStack &operator*=(const glm::mat4 &theMatrix) {ApplyMatrix(theMatrix); return *this;}
+
+		void SetMatrix(const glm::mat4 &theMatrix);
+		void SetIdentity();
+
+	protected:
+		FixedMatrixStack(glm::mat4 *pStorage, size_t capacity, const glm::mat4 &initialMatrix);
+
+	private:
+		glm::mat4 m_currMatrix;
+		glm::mat4 *m_pStorage;
+		size_t m_capacity;
+		size_t m_depth;
+		bool m_bAffine;			//The bottom row of the current matrix is (0, 0, 0, 1).
+
+		//The storage belongs to the derived object, so a copy would share it.
+		FixedMatrixStack(const FixedMatrixStack &);
+		FixedMatrixStack &operator=(const FixedMatrixStack &);
+	};
+
+	//A FixedMatrixStack that can preserve up to maxDepth matrices, stored in the object itself.
+	template<size_t maxDepth>
+	class InlineMatrixStack : public FixedMatrixStack
+	{
+	public:
+		InlineMatrixStack()
+			: FixedMatrixStack(m_storage, maxDepth, glm::mat4(1.0f))
+		{}
+
+		explicit InlineMatrixStack(const glm::mat4 &initialMatrix)
+			: FixedMatrixStack(m_storage, maxDepth, initialMatrix)
+		{}
+
+	private:
+		glm::mat4 m_storage[maxDepth];
+	};
+
+	//Pushes the stack in the constructor and pops it in the destructor, like glutil::PushStack.
+	class PushStack
+	{
+	public:
+		explicit PushStack(FixedMatrixStack &stack)
+			: m_stack(stack)
+		{
+			m_stack.Push();
+		}
+
+		~PushStack()
+		{
+			m_stack.Pop();
+		}
+
+		//Resets the current matrix to the one pushed in the constructor.
+		void ResetStack()
+		{
+			m_stack.Reset();
+		}
+
+	private:
+		FixedMatrixStack &m_stack;
+
+		PushStack(const PushStack &);
+		PushStack &operator=(const PushStack &);
+	};
+}
+
+
+#endif //FRAMEWORK_FIXED_MATRIX_STACK_H
@@ -0,0 +1,380 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <glload/gl_3_3.h>
+#include "GLStateCache.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		const GLuint g_unknownName = 0xFFFFFFFF;
+
+		//Units past this are passed on without being cached.
+		const GLuint g_numTrackedUnits = 32;
+
+		struct BindingTarget
+		{
+			GLenum eTarget;
+			GLenum eQuery;
+			const char *strQueryName;
+		};
+
+		//The element array buffer must be first; see ElementArrayBinding.
+		const BindingTarget g_bufferTargets[] =
+		{
+			{GL_ELEMENT_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER_BINDING, "GL_ELEMENT_ARRAY_BUFFER_BINDING"},
+			{GL_ARRAY_BUFFER, GL_ARRAY_BUFFER_BINDING, "GL_ARRAY_BUFFER_BINDING"},
+			{GL_COPY_READ_BUFFER, GL_COPY_READ_BUFFER, "GL_COPY_READ_BUFFER"},
+			{GL_COPY_WRITE_BUFFER, GL_COPY_WRITE_BUFFER, "GL_COPY_WRITE_BUFFER"},
+			{GL_PIXEL_PACK_BUFFER, GL_PIXEL_PACK_BUFFER_BINDING, "GL_PIXEL_PACK_BUFFER_BINDING"},
+			{GL_PIXEL_UNPACK_BUFFER, GL_PIXEL_UNPACK_BUFFER_BINDING, "GL_PIXEL_UNPACK_BUFFER_BINDING"},
+			{GL_TEXTURE_BUFFER, GL_TEXTURE_BUFFER, "GL_TEXTURE_BUFFER"},
+			{GL_TRANSFORM_FEEDBACK_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER_BINDING,
+				"GL_TRANSFORM_FEEDBACK_BUFFER_BINDING"},
+			{GL_UNIFORM_BUFFER, GL_UNIFORM_BUFFER_BINDING, "GL_UNIFORM_BUFFER_BINDING"},
+		};
+
+		const BindingTarget g_textureTargets[] =
+		{
+			{GL_TEXTURE_1D, GL_TEXTURE_BINDING_1D, "GL_TEXTURE_BINDING_1D"},
+			{GL_TEXTURE_2D, GL_TEXTURE_BINDING_2D, "GL_TEXTURE_BINDING_2D"},
+			{GL_TEXTURE_3D, GL_TEXTURE_BINDING_3D, "GL_TEXTURE_BINDING_3D"},
+			{GL_TEXTURE_1D_ARRAY, GL_TEXTURE_BINDING_1D_ARRAY, "GL_TEXTURE_BINDING_1D_ARRAY"},
+			{GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BINDING_2D_ARRAY, "GL_TEXTURE_BINDING_2D_ARRAY"},
+			{GL_TEXTURE_RECTANGLE, GL_TEXTURE_BINDING_RECTANGLE, "GL_TEXTURE_BINDING_RECTANGLE"},
+			{GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BINDING_CUBE_MAP, "GL_TEXTURE_BINDING_CUBE_MAP"},
+			{GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_BINDING_2D_MULTISAMPLE, "GL_TEXTURE_BINDING_2D_MULTISAMPLE"},
+			{GL_TEXTURE_BUFFER, GL_TEXTURE_BINDING_BUFFER, "GL_TEXTURE_BINDING_BUFFER"},
+		};
+
+		const size_t g_numBufferTargets = sizeof(g_bufferTargets) / sizeof(g_bufferTargets[0]);
+		const size_t g_numTextureTargets = sizeof(g_textureTargets) / sizeof(g_textureTargets[0]);
+
+		//Returns the number of targets if it is not in the table.
+		size_t FindTarget(const BindingTarget *pTargets, size_t numTargets, GLenum eTarget)
+		{
+			size_t iTarget = 0;
+			while(iTarget < numTargets && pTargets[iTarget].eTarget != eTarget)
+				iTarget++;
+			return iTarget;
+		}
+
+		GLuint &ElementArrayBinding(std::vector<GLuint> &buffers)
+		{
+			return buffers[0];
+		}
+
+		void ThrowMismatch(const char *strQueryName, GLuint actual, GLuint cached)
+		{
+			char strMessage[256];
+			sprintf(strMessage, "The GL state cache is out of date: %s is %u, but the cache has %u.",
+				strQueryName, actual, cached);
+			throw std::runtime_error(strMessage);
+		}
+
+		void CheckCapability(GLenum eCap, int iCachedState)
+		{
+			if(iCachedState == -1)
+				return;
+
+			bool bEnabled = glIsEnabled(eCap) == GL_TRUE;
+			if(bEnabled == (iCachedState == 1))
+				return;
+
+			char strMessage[128];
+			sprintf(strMessage, "The GL state cache is out of date: capability 0x%04X is %s.", eCap,
+				bEnabled ? "enabled" : "disabled");
+			throw std::runtime_error(strMessage);
+		}
+
+		void CheckBinding(GLenum eQuery, const char *strQueryName, GLuint cached)
+		{
+			if(cached == g_unknownName)
+				return;
+
+			GLint actual = 0;
+			glGetIntegerv(eQuery, &actual);
+			if((GLuint)actual != cached)
+				ThrowMismatch(strQueryName, (GLuint)actual, cached);
+		}
+	}
+
+	GLStateCache::GLStateCache()
+		: m_bVerify(false)
+	{
+		Invalidate();
+	}
+
+	bool GLStateCache::Update(GLuint &cached, GLuint value)
+	{
+		if(cached == value)
+		{
+			m_stats.iNumElided++;
+			return false;
+		}
+
+		cached = value;
+		m_stats.iNumCalls++;
+		return true;
+	}
+
+	void GLStateCache::UseProgram(GLuint program)
+	{
+		if(Update(m_program, program))
+			glUseProgram(program);
+
+		if(m_bVerify)
+			CheckBinding(GL_CURRENT_PROGRAM, "GL_CURRENT_PROGRAM", m_program);
+	}
+
+	void GLStateCache::BindVertexArray(GLuint vao)
+	{
+		if(Update(m_vao, vao))
+		{
+			glBindVertexArray(vao);
+			ElementArrayBinding(m_buffers) = g_unknownName;
+		}
+
+		if(m_bVerify)
+			CheckBinding(GL_VERTEX_ARRAY_BINDING, "GL_VERTEX_ARRAY_BINDING", m_vao);
+	}
+
+	void GLStateCache::BindBuffer(GLenum eTarget, GLuint buffer)
+	{
+		size_t iTarget = FindTarget(g_bufferTargets, g_numBufferTargets, eTarget);
+		if(iTarget == g_numBufferTargets)
+		{
+			m_stats.iNumCalls++;
+			glBindBuffer(eTarget, buffer);
+			return;
+		}
+
+		if(Update(m_buffers[iTarget], buffer))
+			glBindBuffer(eTarget, buffer);
+
+		if(m_bVerify)
+			CheckBinding(g_bufferTargets[iTarget].eQuery, g_bufferTargets[iTarget].strQueryName, m_buffers[iTarget]);
+	}
+
+	void GLStateCache::BindBufferRange(GLenum eTarget, GLuint index, GLuint buffer, GLintptr offset,
+		GLsizeiptr size)
+	{
+		//Indexed bindings are not tracked, so this is always made.
+		m_stats.iNumCalls++;
+		glBindBufferRange(eTarget, index, buffer, offset, size);
+
+		size_t iTarget = FindTarget(g_bufferTargets, g_numBufferTargets, eTarget);
+		if(iTarget != g_numBufferTargets)
+			m_buffers[iTarget] = buffer;
+	}
+
+	void GLStateCache::ActiveTexture(GLenum eTextureUnit)
+	{
+		if(Update(m_eActiveTexture, eTextureUnit))
+			glActiveTexture(eTextureUnit);
+
+		if(m_bVerify)
+			CheckBinding(GL_ACTIVE_TEXTURE, "GL_ACTIVE_TEXTURE", m_eActiveTexture);
+	}
+
+	GLuint *GLStateCache::FindTextureBinding(GLenum eTarget)
+	{
+		if(m_eActiveTexture == g_unknownName)
+			return NULL;
+
+		GLuint iUnit = m_eActiveTexture - GL_TEXTURE0;
+		size_t iTarget = FindTarget(g_textureTargets, g_numTextureTargets, eTarget);
+		if(iUnit >= g_numTrackedUnits || iTarget == g_numTextureTargets)
+			return NULL;
+
+		return &m_textures[iUnit * g_numTextureTargets + iTarget];
+	}
+
+	void GLStateCache::BindTexture(GLenum eTarget, GLuint texture)
+	{
+		GLuint *pBinding = FindTextureBinding(eTarget);
+		if(!pBinding)
+		{
+			m_stats.iNumCalls++;
+			glBindTexture(eTarget, texture);
+			return;
+		}
+
+		if(Update(*pBinding, texture))
+			glBindTexture(eTarget, texture);
+
+		if(m_bVerify)
+			VerifyTextureUnit(m_eActiveTexture - GL_TEXTURE0);
+	}
+
+	GLStateCache::Capability &GLStateCache::FindCapability(GLenum eCap)
+	{
+		for(size_t iCap = 0; iCap < m_caps.size(); iCap++)
+		{
+			if(m_caps[iCap].eCap == eCap)
+				return m_caps[iCap];
+		}
+
+		Capability cap;
+		cap.eCap = eCap;
+		cap.iState = -1;
+		m_caps.push_back(cap);
+		return m_caps.back();
+	}
+
+	void GLStateCache::SetEnabled(GLenum eCap, bool bEnable)
+	{
+		Capability &cap = FindCapability(eCap);
+		if(cap.iState == (bEnable ? 1 : 0))
+			m_stats.iNumElided++;
+		else
+		{
+			if(bEnable)
+				glEnable(eCap);
+			else
+				glDisable(eCap);
+
+			cap.iState = bEnable ? 1 : 0;
+			m_stats.iNumCalls++;
+		}
+
+		if(m_bVerify)
+			CheckCapability(eCap, cap.iState);
+	}
+
+	void GLStateCache::PrimitiveRestartIndex(GLuint index)
+	{
+		if(m_bHasRestartIndex && m_restartIndex == index)
+			m_stats.iNumElided++;
+		else
+		{
+			glPrimitiveRestartIndex(index);
+			m_restartIndex = index;
+			m_bHasRestartIndex = true;
+			m_stats.iNumCalls++;
+		}
+
+		if(m_bVerify)
+			VerifyRestartIndex();
+	}
+
+	void GLStateCache::Enable(GLenum eCap)
+	{
+		SetEnabled(eCap, true);
+	}
+
+	void GLStateCache::Disable(GLenum eCap)
+	{
+		SetEnabled(eCap, false);
+	}
+
+	void GLStateCache::DeleteVertexArray(GLuint vao)
+	{
+		glDeleteVertexArrays(1, &vao);
+		if(vao && m_vao == vao)
+		{
+			m_vao = 0;
+			ElementArrayBinding(m_buffers) = g_unknownName;
+		}
+	}
+
+	void GLStateCache::DeleteBuffer(GLuint buffer)
+	{
+		glDeleteBuffers(1, &buffer);
+		for(size_t iTarget = 0; iTarget < m_buffers.size(); iTarget++)
+		{
+			if(buffer && m_buffers[iTarget] == buffer)
+				m_buffers[iTarget] = 0;
+		}
+	}
+
+	void GLStateCache::DeleteTexture(GLuint texture)
+	{
+		glDeleteTextures(1, &texture);
+		for(size_t iBinding = 0; iBinding < m_textures.size(); iBinding++)
+		{
+			if(texture && m_textures[iBinding] == texture)
+				m_textures[iBinding] = 0;
+		}
+	}
+
+	void GLStateCache::Invalidate()
+	{
+		m_program = g_unknownName;
+		m_vao = g_unknownName;
+		m_eActiveTexture = g_unknownName;
+		m_buffers.assign(g_numBufferTargets, g_unknownName);
+		m_textures.assign(g_numTrackedUnits * g_numTextureTargets, g_unknownName);
+		m_caps.clear();
+		m_restartIndex = 0;
+		m_bHasRestartIndex = false;
+	}
+
+	//The unit must be the active one.
+	void GLStateCache::VerifyTextureUnit(GLuint iUnit)
+	{
+		for(size_t iTarget = 0; iTarget < g_numTextureTargets; iTarget++)
+		{
+			CheckBinding(g_textureTargets[iTarget].eQuery, g_textureTargets[iTarget].strQueryName,
+				m_textures[iUnit * g_numTextureTargets + iTarget]);
+		}
+	}
+
+	void GLStateCache::VerifyRestartIndex()
+	{
+		if(!m_bHasRestartIndex)
+			return;
+
+		GLint actual = 0;
+		glGetIntegerv(GL_PRIMITIVE_RESTART_INDEX, &actual);
+		if((GLuint)actual != m_restartIndex)
+			ThrowMismatch("GL_PRIMITIVE_RESTART_INDEX", (GLuint)actual, m_restartIndex);
+	}
+
+	void GLStateCache::Verify()
+	{
+		CheckBinding(GL_CURRENT_PROGRAM, "GL_CURRENT_PROGRAM", m_program);
+		CheckBinding(GL_VERTEX_ARRAY_BINDING, "GL_VERTEX_ARRAY_BINDING", m_vao);
+		CheckBinding(GL_ACTIVE_TEXTURE, "GL_ACTIVE_TEXTURE", m_eActiveTexture);
+
+		for(size_t iTarget = 0; iTarget < g_numBufferTargets; iTarget++)
+			CheckBinding(g_bufferTargets[iTarget].eQuery, g_bufferTargets[iTarget].strQueryName, m_buffers[iTarget]);
+
+		for(size_t iCap = 0; iCap < m_caps.size(); iCap++)
+			CheckCapability(m_caps[iCap].eCap, m_caps[iCap].iState);
+
+		VerifyRestartIndex();
+
+		//Texture bindings can only be read from the active unit.
+		GLint activeTexture = GL_TEXTURE0;
+		glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+		for(GLuint iUnit = 0; iUnit < g_numTrackedUnits; iUnit++)
+		{
+			glActiveTexture(GL_TEXTURE0 + iUnit);
+			try
+			{
+				VerifyTextureUnit(iUnit);
+			}
+			catch(...)
+			{
+				glActiveTexture(activeTexture);
+				throw;
+			}
+		}
+
+		glActiveTexture(activeTexture);
+	}
+
+	GLStateCache &GetGLStateCache()
+	{
+		static GLStateCache stateCache;
+		return stateCache;
+	}
+}
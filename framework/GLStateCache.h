@@ -0,0 +1,105 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_GL_STATE_CACHE_H
+#define FRAMEWORK_GL_STATE_CACHE_H
+
+#include <vector>
+
+namespace Framework
+{
+	struct GLStateStats
+	{
+		GLStateStats() : iNumCalls(0), iNumElided(0) {}
+
+		int iNumCalls;			//Binds, enables, disables and restart indices passed on to OpenGL.
+		int iNumElided;			//Calls left out because OpenGL already had that state.
+	};
+
+	//Remembers the program, VAO, buffer and texture bindings, enable bits and primitive restart
+	//index that were last set, and only calls OpenGL when they change. Nothing is known at first, so the first call for each
+	//piece of state is always made.
+	//
+	//The cache is only right if every change to that state goes through it. Code that changes the
+	//state directly must call Invalidate afterwards. VAOs, buffers and textures that may be bound
+	//must be deleted through the cache, since deleting them unbinds them.
+	//
+	//With verification on, every call checks the cached state against glGet and throws
+	//std::runtime_error if they differ. It is slow; it is for finding code that goes around the
+	//cache.
+	class GLStateCache
+	{
+	public:
+		GLStateCache();
+
+		void UseProgram(GLuint program);
+
+		//The GL_ELEMENT_ARRAY_BUFFER binding belongs to the VAO, so it is forgotten whenever the VAO
+		//changes.
+		void BindVertexArray(GLuint vao);
+
+		//Targets the cache does not know are always passed on. Binding a range also sets the
+		//target's general binding, so it is tracked too.
+		void BindBuffer(GLenum eTarget, GLuint buffer);
+		void BindBufferRange(GLenum eTarget, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+		//eTextureUnit is GL_TEXTURE0 + n. Bindings are tracked for each unit.
+		void ActiveTexture(GLenum eTextureUnit);
+		void BindTexture(GLenum eTarget, GLuint texture);
+
+		void Enable(GLenum eCap);
+		void Disable(GLenum eCap);
+		void SetEnabled(GLenum eCap, bool bEnable);
+
+		//Only sets the index; GL_PRIMITIVE_RESTART is enabled separately.
+		void PrimitiveRestartIndex(GLuint index);
+
+		void DeleteVertexArray(GLuint vao);
+		void DeleteBuffer(GLuint buffer);
+		void DeleteTexture(GLuint texture);
+
+		//Forgets everything, so the next call for each piece of state is made.
+		void Invalidate();
+
+		void SetVerify(bool bVerify) {m_bVerify = bVerify;}
+		bool IsVerifying() const {return m_bVerify;}
+
+		//Checks all of the known state against glGet. Throws std::runtime_error on a difference.
+		void Verify();
+
+		const GLStateStats &GetStats() const {return m_stats;}
+		void ResetStats() {m_stats = GLStateStats();}
+
+	private:
+		struct Capability
+		{
+			GLenum eCap;
+			int iState;			//-1 if unknown.
+		};
+
+		GLuint m_program;
+		GLuint m_vao;
+		GLenum m_eActiveTexture;
+		std::vector<GLuint> m_buffers;			//One for each target in the cache's table.
+		std::vector<GLuint> m_textures;			//Units * targets, unit major.
+		std::vector<Capability> m_caps;
+		GLuint m_restartIndex;
+		bool m_bHasRestartIndex;				//Any value is a valid index, so unknown is kept apart.
+		bool m_bVerify;
+		GLStateStats m_stats;
+
+		//Returns true if the call must be made, and counts it.
+		bool Update(GLuint &cached, GLuint value);
+		GLuint *FindTextureBinding(GLenum eTarget);
+		Capability &FindCapability(GLenum eCap);
+		void VerifyTextureUnit(GLuint iUnit);
+		void VerifyRestartIndex();
+	};
+
+	//The cache for the current context. The framework only makes one context, so there is only one.
+	GLStateCache &GetGLStateCache();
+}
+
+
+#endif //FRAMEWORK_GL_STATE_CACHE_H
@@ -0,0 +1,488 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <glload/gl_3_3.h>
+#include <glm/gtc/matrix_inverse.hpp>
+#include "Mesh.h"
+#include "MeshGeometry.h"
+#include "MeshIndices.h"
+#include "MeshBounds.h"
+#include "MeshArena.h"
+#include "MeshClusters.h"
+#include "MeshSimplify.h"
+#include "MeshWeld.h"
+#include "GLStateCache.h"
+
+
+namespace Framework
+{
+	struct NamedVao
+	{
+		std::string strName;
+		GLuint oVAO;
+		MeshBounds bounds;
+	};
+
+	struct MeshData
+	{
+		MeshData()
+			: oAttribArraysBuffer(0), oIndexBuffer(0), oVAO(0), eIndexType(GL_UNSIGNED_INT)
+			, iClusterCmd(-1), pArena(NULL), arenaMeshId(0)
+		{}
+
+		GLuint oAttribArraysBuffer;
+		GLuint oIndexBuffer;
+		GLuint oVAO;
+		GLenum eIndexType;
+
+		std::vector<NamedVao> namedVaos;
+		std::vector<MeshRenderCmd> primitives;
+
+		std::vector<MeshCluster> clusters;
+		int iClusterCmd;
+		//Reused by every RenderCulled call, to avoid allocating each frame.
+		std::vector<MeshIndexRange> visibleRanges;
+		std::vector<GLsizei> rangeCounts;
+		std::vector<const GLvoid *> rangeOffsets;
+
+		std::vector<MeshLod> lods;
+
+		MeshArena *pArena;
+		MeshArena::MeshId arenaMeshId;
+	};
+
+	namespace
+	{
+		void RenderCmd(const MeshRenderCmd &cmd, GLenum eIndexType)
+		{
+			if(cmd.bIsIndexedCmd)
+			{
+				//Left as it is after the draw, so runs of commands that use it do not toggle it.
+				GLStateCache &stateCache = GetGLStateCache();
+				stateCache.SetEnabled(GL_PRIMITIVE_RESTART, cmd.bPrimRestart);
+				if(cmd.bPrimRestart)
+					stateCache.PrimitiveRestartIndex(cmd.primRestart);
+
+				glDrawElements(cmd.ePrimType, (GLsizei)cmd.elemCount, eIndexType,
+					(void*)(cmd.start * IndexTypeBytes(eIndexType)));
+			}
+			else
+				glDrawArrays(cmd.ePrimType, cmd.start, cmd.elemCount);
+		}
+
+		void SetupAttributeArray(const MeshAttribute &attrib, size_t offset)
+		{
+			glEnableVertexAttribArray(attrib.iAttribIx);
+			if(attrib.bIsIntegral)
+				glVertexAttribIPointer(attrib.iAttribIx, attrib.iSize, attrib.eType, 0, (void*)offset);
+			else
+				glVertexAttribPointer(attrib.iAttribIx, attrib.iSize, attrib.eType,
+					attrib.bNormalized ? GL_TRUE : GL_FALSE, 0, (void*)offset);
+		}
+
+		template<typename T>
+		void WriteIndices(const std::vector<GLuint> &indices, std::vector<GLubyte> &buffer)
+		{
+			buffer.resize(indices.size() * sizeof(T));
+			T *pOut = reinterpret_cast<T*>(&buffer[0]);
+			for(size_t iLoop = 0; iLoop < indices.size(); iLoop++)
+				pOut[iLoop] = (T)indices[iLoop];
+		}
+
+		void CreateObjects(const MeshGeometry &geom, MeshData &data)
+		{
+			//Each attribute array is stored back-to-back in one buffer, aligned to 16 bytes.
+			std::vector<size_t> attribStartLocs(geom.attribs.size());
+			size_t iAttribBufferSize = 0;
+			for(size_t iLoop = 0; iLoop < geom.attribs.size(); iLoop++)
+			{
+				iAttribBufferSize = iAttribBufferSize % 16 ?
+					(iAttribBufferSize + (16 - iAttribBufferSize % 16)) : iAttribBufferSize;
+
+				attribStartLocs[iLoop] = iAttribBufferSize;
+				iAttribBufferSize += geom.attribs[iLoop].data.size();
+			}
+
+			GLStateCache &stateCache = GetGLStateCache();
+			glGenBuffers(1, &data.oAttribArraysBuffer);
+			stateCache.BindBuffer(GL_ARRAY_BUFFER, data.oAttribArraysBuffer);
+			glBufferData(GL_ARRAY_BUFFER, iAttribBufferSize, NULL, GL_STATIC_DRAW);
+
+			for(size_t iLoop = 0; iLoop < geom.attribs.size(); iLoop++)
+			{
+				const MeshAttribute &attrib = geom.attribs[iLoop];
+				glBufferSubData(GL_ARRAY_BUFFER, attribStartLocs[iLoop], attrib.data.size(), &attrib.data[0]);
+			}
+
+			if(!geom.indices.empty())
+			{
+				std::vector<GLubyte> indexBuffer;
+				switch(geom.eIndexType)
+				{
+				case GL_UNSIGNED_BYTE: WriteIndices<GLubyte>(geom.indices, indexBuffer); break;
+				case GL_UNSIGNED_SHORT: WriteIndices<GLushort>(geom.indices, indexBuffer); break;
+				default: WriteIndices<GLuint>(geom.indices, indexBuffer); break;
+				}
+
+				//The index binding belongs to the VAO, and rendering leaves meshes' VAOs bound.
+				glGenBuffers(1, &data.oIndexBuffer);
+				stateCache.BindVertexArray(0);
+				stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.oIndexBuffer);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBuffer.size(), &indexBuffer[0], GL_STATIC_DRAW);
+				stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+			}
+
+			//Fill in the main VAO, which uses every attribute.
+			glGenVertexArrays(1, &data.oVAO);
+			stateCache.BindVertexArray(data.oVAO);
+			for(size_t iLoop = 0; iLoop < geom.attribs.size(); iLoop++)
+				SetupAttributeArray(geom.attribs[iLoop], attribStartLocs[iLoop]);
+			if(data.oIndexBuffer)
+				stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.oIndexBuffer);
+
+			//Fill in the named VAOs.
+			for(size_t iVao = 0; iVao < geom.namedVaos.size(); iVao++)
+			{
+				const MeshNamedVao &namedVao = geom.namedVaos[iVao];
+
+				//Added before the VAO is made, so that DeleteObjects finds it if anything throws.
+				NamedVao vao;
+				vao.strName = namedVao.strName;
+				vao.oVAO = 0;
+				vao.bounds = namedVao.bounds;
+				data.namedVaos.push_back(vao);
+				glGenVertexArrays(1, &data.namedVaos.back().oVAO);
+				stateCache.BindVertexArray(data.namedVaos.back().oVAO);
+
+				for(size_t iSource = 0; iSource < namedVao.sourceAttribs.size(); iSource++)
+				{
+					for(size_t iLoop = 0; iLoop < geom.attribs.size(); iLoop++)
+					{
+						if(geom.attribs[iLoop].iAttribIx == namedVao.sourceAttribs[iSource])
+							SetupAttributeArray(geom.attribs[iLoop], attribStartLocs[iLoop]);
+					}
+				}
+
+				if(data.oIndexBuffer)
+					stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.oIndexBuffer);
+			}
+
+			stateCache.BindVertexArray(0);
+			stateCache.BindBuffer(GL_ARRAY_BUFFER, 0);
+
+			data.eIndexType = geom.eIndexType;
+			data.primitives = geom.cmds;
+			data.clusters = geom.clusters;
+			data.iClusterCmd = geom.iClusterCmd;
+			data.lods = geom.lods;
+		}
+	}
+
+	void PrepareMeshGeometry(const std::string &strFilename, unsigned int loadFlags, MeshGeometry &geom)
+	{
+		LoadMeshGeometry(strFilename, geom);
+		ProcessMeshGeometry(strFilename, loadFlags, geom);
+	}
+
+	void ProcessMeshGeometry(const std::string &strName, unsigned int loadFlags, MeshGeometry &geom)
+	{
+		MeshIndexStats oldStats = CalcIndexStats(geom);
+		size_t oldNumVertices = geom.NumVertices();
+
+		if(loadFlags & MESH_WELD_VERTICES)
+			WeldMeshVertices(geom);
+		if((loadFlags & MESH_GENERATE_STRIPS) && !(loadFlags & MESH_BUILD_CLUSTERS))
+			StripifyTriangleLists(geom);
+		NarrowIndexType(geom);
+		MergeRenderCmds(geom);
+		if(loadFlags & MESH_BUILD_CLUSTERS)
+			BuildMeshClusters(geom);
+		if(loadFlags & MESH_BUILD_LODS)
+		{
+			const float lodRatios[] = {0.5f, 0.25f, 0.125f};
+			BuildMeshLods(geom, std::vector<float>(lodRatios, lodRatios + 3));
+		}
+		CalcMeshBounds(geom);
+
+		if(loadFlags & MESH_REPORT_STATS)
+		{
+			MeshIndexStats newStats = CalcIndexStats(geom);
+			printf("%s: %d index bytes (was %d), %d draw commands (was %d)\n", strName.c_str(),
+				(int)newStats.iIndexBytes, (int)oldStats.iIndexBytes,
+				(int)newStats.iNumDrawCmds, (int)oldStats.iNumDrawCmds);
+			if(geom.NumVertices() != oldNumVertices)
+			{
+				printf("%s: %d vertices (was %d)\n", strName.c_str(), (int)geom.NumVertices(),
+					(int)oldNumVertices);
+			}
+			if(!geom.clusters.empty())
+				printf("%s: %d triangle clusters\n", strName.c_str(), (int)geom.clusters.size());
+			for(size_t iLod = 0; iLod < geom.lods.size(); iLod++)
+			{
+				printf("%s: LOD %d has %d triangles, error %f\n", strName.c_str(), (int)iLod + 1,
+					(int)geom.lods[iLod].numIndices / 3, geom.lods[iLod].geometricError);
+			}
+		}
+	}
+
+	Mesh::Mesh(const std::string &strFilename, unsigned int loadFlags)
+		: m_pData(NULL)
+	{
+		//The file is read before anything is allocated, since reading it is what usually throws.
+		MeshGeometry geom;
+		PrepareMeshGeometry(strFilename, loadFlags, geom);
+		m_bounds = geom.bounds;
+
+		m_pData = new MeshData();
+		try
+		{
+			CreateObjects(geom, *m_pData);
+		}
+		catch(...)
+		{
+			DeleteObjects();
+			delete m_pData;
+			throw;
+		}
+	}
+
+	Mesh::Mesh(const MeshGeometry &geom)
+		: m_pData(new MeshData())
+		, m_bounds(geom.bounds)
+	{
+		//The destructor will not run if this throws, so the objects made so far are deleted here.
+		try
+		{
+			CreateObjects(geom, *m_pData);
+		}
+		catch(...)
+		{
+			DeleteObjects();
+			delete m_pData;
+			throw;
+		}
+	}
+
+	Mesh::Mesh(const MeshGeometry &geom, MeshArena &arena)
+		: m_pData(NULL)
+		, m_bounds(geom.bounds)
+	{
+		//AddMesh is what usually throws, so it is called before anything is allocated.
+		MeshArena::MeshId arenaMeshId = arena.AddMesh(geom);
+		try
+		{
+			m_pData = new MeshData();
+			m_pData->arenaMeshId = arenaMeshId;
+			m_pData->pArena = &arena;
+
+			//The arena has a single VAO, so named VAOs only keep their names and bounds.
+			for(size_t iVao = 0; iVao < geom.namedVaos.size(); iVao++)
+			{
+				NamedVao vao;
+				vao.strName = geom.namedVaos[iVao].strName;
+				vao.oVAO = 0;
+				vao.bounds = geom.namedVaos[iVao].bounds;
+				m_pData->namedVaos.push_back(vao);
+			}
+		}
+		catch(...)
+		{
+			arena.RemoveMesh(arenaMeshId);
+			delete m_pData;
+			throw;
+		}
+	}
+
+	Mesh::~Mesh()
+	{
+		DeleteObjects();
+		delete m_pData;
+	}
+
+	void Mesh::DeleteObjects()
+	{
+		if(m_pData->pArena)
+		{
+			m_pData->pArena->RemoveMesh(m_pData->arenaMeshId);
+			m_pData->pArena = NULL;
+		}
+
+		GLStateCache &stateCache = GetGLStateCache();
+		stateCache.DeleteBuffer(m_pData->oAttribArraysBuffer);
+		m_pData->oAttribArraysBuffer = 0;
+		stateCache.DeleteBuffer(m_pData->oIndexBuffer);
+		m_pData->oIndexBuffer = 0;
+		stateCache.DeleteVertexArray(m_pData->oVAO);
+		m_pData->oVAO = 0;
+
+		//Handles stay valid; they just render nothing from now on.
+		for(size_t iVao = 0; iVao < m_pData->namedVaos.size(); iVao++)
+		{
+			stateCache.DeleteVertexArray(m_pData->namedVaos[iVao].oVAO);
+			m_pData->namedVaos[iVao].oVAO = 0;
+		}
+	}
+
+	Mesh::VaoHandle Mesh::GetVaoHandle(const std::string &strMeshName) const
+	{
+		for(size_t iVao = 0; iVao < m_pData->namedVaos.size(); iVao++)
+		{
+			if(m_pData->namedVaos[iVao].strName == strMeshName)
+				return VaoHandle((int)iVao);
+		}
+
+		return VaoHandle();
+	}
+
+	bool Mesh::IsInRange(VaoHandle hVao) const
+	{
+		return hVao.IsValid() && (size_t)hVao.m_iIndex < m_pData->namedVaos.size();
+	}
+
+	const MeshBounds &Mesh::GetBounds(VaoHandle hVao) const
+	{
+		static const MeshBounds emptyBounds;
+
+		if(!IsInRange(hVao))
+			return emptyBounds;
+		return m_pData->namedVaos[hVao.m_iIndex].bounds;
+	}
+
+	void Mesh::Render() const
+	{
+		if(m_pData->pArena)
+		{
+			m_pData->pArena->Render(m_pData->arenaMeshId);
+			return;
+		}
+
+		if(!m_pData->oVAO)
+			return;
+
+		GetGLStateCache().BindVertexArray(m_pData->oVAO);
+		for(size_t iCmd = 0; iCmd < m_pData->primitives.size(); iCmd++)
+			RenderCmd(m_pData->primitives[iCmd], m_pData->eIndexType);
+	}
+
+	void Mesh::Render(VaoHandle hVao) const
+	{
+		if(!IsInRange(hVao))
+			return;
+
+		if(m_pData->pArena)
+		{
+			m_pData->pArena->Render(m_pData->arenaMeshId);
+			return;
+		}
+
+		GLuint vao = m_pData->namedVaos[hVao.m_iIndex].oVAO;
+		if(!vao)
+			return;
+
+		GetGLStateCache().BindVertexArray(vao);
+		for(size_t iCmd = 0; iCmd < m_pData->primitives.size(); iCmd++)
+			RenderCmd(m_pData->primitives[iCmd], m_pData->eIndexType);
+	}
+
+	void Mesh::RenderCulled(const glm::mat4 &modelToCamera, const glm::mat4 &cameraToClip,
+		bool bFrontFaceCW, ClusterCullStats *pStats) const
+	{
+		if(m_pData->pArena || m_pData->iClusterCmd < 0)
+		{
+			Render();
+			return;
+		}
+
+		if(!m_pData->oVAO)
+			return;
+
+		glm::vec3 modelCameraPos(glm::affineInverse(modelToCamera)[3]);
+		ClusterCullStats stats;
+		m_pData->visibleRanges.clear();
+		CullMeshClusters(m_pData->clusters, cameraToClip * modelToCamera, modelCameraPos, bFrontFaceCW,
+			m_pData->visibleRanges, stats);
+
+		if(pStats)
+		{
+			pStats->iClustersDrawn += stats.iClustersDrawn;
+			pStats->iClustersCulled += stats.iClustersCulled;
+			pStats->iTrianglesDrawn += stats.iTrianglesDrawn;
+			pStats->iTrianglesCulled += stats.iTrianglesCulled;
+		}
+
+		GetGLStateCache().BindVertexArray(m_pData->oVAO);
+		for(size_t iCmd = 0; iCmd < m_pData->primitives.size(); iCmd++)
+		{
+			if((int)iCmd != m_pData->iClusterCmd)
+				RenderCmd(m_pData->primitives[iCmd], m_pData->eIndexType);
+		}
+
+		const std::vector<MeshIndexRange> &ranges = m_pData->visibleRanges;
+		if(!ranges.empty())
+		{
+			size_t indexBytes = IndexTypeBytes(m_pData->eIndexType);
+			m_pData->rangeCounts.resize(ranges.size());
+			m_pData->rangeOffsets.resize(ranges.size());
+			for(size_t iRange = 0; iRange < ranges.size(); iRange++)
+			{
+				m_pData->rangeCounts[iRange] = (GLsizei)ranges[iRange].numIndices;
+				m_pData->rangeOffsets[iRange] = (const GLvoid *)(ranges[iRange].firstIndex * indexBytes);
+			}
+
+			GetGLStateCache().Disable(GL_PRIMITIVE_RESTART);
+			glMultiDrawElements(GL_TRIANGLES, &m_pData->rangeCounts[0], m_pData->eIndexType,
+				&m_pData->rangeOffsets[0], (GLsizei)ranges.size());
+		}
+	}
+
+	size_t Mesh::GetNumLods() const
+	{
+		return m_pData->lods.size() + 1;
+	}
+
+	float Mesh::GetLodError(size_t iLod) const
+	{
+		if(iLod == 0 || m_pData->lods.empty())
+			return 0.0f;
+		return m_pData->lods[std::min(iLod, m_pData->lods.size()) - 1].geometricError;
+	}
+
+	size_t Mesh::SelectLod(float errorScale, float maxError) const
+	{
+		size_t iLod = 0;
+		while(iLod < m_pData->lods.size() && m_pData->lods[iLod].geometricError * errorScale <= maxError)
+			iLod++;
+		return iLod;
+	}
+
+	void Mesh::RenderLod(size_t iLod) const
+	{
+		if(m_pData->pArena || iLod == 0 || m_pData->lods.empty())
+		{
+			Render();
+			return;
+		}
+
+		if(!m_pData->oVAO)
+			return;
+
+		GetGLStateCache().BindVertexArray(m_pData->oVAO);
+		for(size_t iCmd = 0; iCmd < m_pData->primitives.size(); iCmd++)
+		{
+			const MeshRenderCmd &cmd = m_pData->primitives[iCmd];
+			if(!IsTriangleCmd(cmd))
+				RenderCmd(cmd, m_pData->eIndexType);
+		}
+
+		const MeshLod &lod = m_pData->lods[std::min(iLod, m_pData->lods.size()) - 1];
+		GetGLStateCache().Disable(GL_PRIMITIVE_RESTART);
+		glDrawElements(GL_TRIANGLES, (GLsizei)lod.numIndices, m_pData->eIndexType,
+			(void*)(lod.firstIndex * IndexTypeBytes(m_pData->eIndexType)));
+	}
+}
@@ -5,23 +5,102 @@
 #ifndef FRAMEWORK_MESH_H
 #define FRAMEWORK_MESH_H
 
+#include "MeshBounds.h"
 
 namespace Framework
 {
 	struct MeshData;
+	struct MeshGeometry;
+	class MeshArena;
+	struct ClusterCullStats;
+
+	//Optional processing done when a mesh is loaded.
+	enum MeshLoadFlags
+	{
+		MESH_GENERATE_STRIPS	= 0x0001,	//Turn triangle lists into strips joined by primitive restart.
+		MESH_REPORT_STATS		= 0x0002,	//Print index memory and draw command counts to stdout.
+		MESH_BUILD_CLUSTERS		= 0x0004,	//Group triangles into clusters for RenderCulled. Overrides MESH_GENERATE_STRIPS.
+		MESH_BUILD_LODS			= 0x0008,	//Simplify to 1/2, 1/4 and 1/8 of the triangles for RenderLod.
+		MESH_WELD_VERTICES		= 0x0010,	//Merge exactly identical vertices. See MeshWeld.h for welding within an epsilon.
+	};
+
+	//Reads a mesh file and does all of the load-time processing given by loadFlags.
+	//This does not use OpenGL, so it can be called from any thread.
+	//Index data is always stored in the smallest usable type, adjacent draw commands are merged,
+	//and the bounds are computed.
+	void PrepareMeshGeometry(const std::string &strFilename, unsigned int loadFlags, MeshGeometry &geom);
+
+	//Does the processing of PrepareMeshGeometry on geometry that was made some other way, such as by
+	//one of the generators in MeshGenerators.h. strName is only used when reporting stats.
+	void ProcessMeshGeometry(const std::string &strName, unsigned int loadFlags, MeshGeometry &geom);
 
 	class Mesh
 	{
 	public:
-		Mesh(const std::string &strFilename);
+		Mesh(const std::string &strFilename, unsigned int loadFlags = 0);
+		//Creates the GL objects for geometry that has already been prepared.
+		explicit Mesh(const MeshGeometry &geom);
+		//Suballocates the mesh from the arena instead of creating its own buffers and VAOs. Named VAOs
+		//all render with the arena's vertex format. The arena must outlive the mesh.
+		Mesh(const MeshGeometry &geom, MeshArena &arena);
 		~Mesh();
 
+		//Refers to one of the mesh's named VAOs. A default-constructed handle refers to nothing.
+		//A handle is only valid for the mesh that returned it. Passing it to another mesh is an error,
+		//though handles out of range for that mesh are safely ignored.
+		class VaoHandle
+		{
+		public:
+			VaoHandle() : m_iIndex(-1) {}
+
+			bool IsValid() const {return m_iIndex >= 0;}
+
+		private:
+			friend class Mesh;
+			explicit VaoHandle(int iIndex) : m_iIndex(iIndex) {}
+
+			int m_iIndex;
+		};
+
+		//Looks up a named VAO once, so that it can be rendered without any string handling.
+		//Returns an invalid handle if there is no VAO with that name.
+		VaoHandle GetVaoHandle(const std::string &strMeshName) const;
+
+		//Rendering goes through the GL state cache, and leaves the VAO bound and GL_PRIMITIVE_RESTART
+		//as the last command needed.
 		void Render() const;
-		void Render(const std::string &strMeshName) const;
+		//Does nothing if the handle is invalid, or out of range for this mesh.
+		void Render(VaoHandle hVao) const;
+		void Render(const std::string &strMeshName) const {Render(GetVaoHandle(strMeshName));}
+		//Draws only the triangle clusters that may be visible. Meshes loaded without
+		//MESH_BUILD_CLUSTERS, and arena meshes, are drawn whole. bFrontFaceCW must match glFrontFace.
+		//modelToCamera must be affine; the projection goes in cameraToClip.
+		//The culling results are added to pStats, if it is not NULL.
+		void RenderCulled(const glm::mat4 &modelToCamera, const glm::mat4 &cameraToClip,
+			bool bFrontFaceCW, ClusterCullStats *pStats = NULL) const;
+		//Level 0 is the full mesh. Higher levels have fewer triangles and a larger error.
+		size_t GetNumLods() const;
+		//Model-space geometric error of the level; 0 for level 0.
+		float GetLodError(size_t iLod) const;
+		//Returns the coarsest level whose error, multiplied by errorScale, is no more than maxError.
+		//With an errorScale from CalcLodErrorScale, maxError is in pixels.
+		size_t SelectLod(float errorScale, float maxError) const;
+		//Levels past the last one draw the last one. Commands that are not triangles are drawn as they
+		//are. Arena meshes are always drawn whole.
+		void RenderLod(size_t iLod) const;
+
 		void DeleteObjects();
 
+		const MeshBounds &GetBounds() const {return m_bounds;}
+		//Returns empty bounds if the handle is invalid, or out of range for this mesh.
+		const MeshBounds &GetBounds(VaoHandle hVao) const;
+		const MeshBounds &GetBounds(const std::string &strMeshName) const {return GetBounds(GetVaoHandle(strMeshName));}
+
 	private:
 		MeshData *m_pData;
+		MeshBounds m_bounds;
+
+		bool IsInRange(VaoHandle hVao) const;
 	};
 }
 
@@ -0,0 +1,403 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <string.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <glload/gl_3_3.h>
+#include "MeshGeometry.h"
+#include "MeshArena.h"
+#include "GLStateCache.h"
+
+
+namespace Framework
+{
+	RangeAllocator::RangeAllocator(GLuint capacity)
+		: m_capacity(capacity)
+		, m_freeSpace(capacity)
+	{
+		if(capacity)
+			m_freeBlocks[0] = capacity;
+	}
+
+	bool RangeAllocator::Allocate(GLuint size, GLuint &offset)
+	{
+		std::map<GLuint, GLuint>::iterator theIt = m_freeBlocks.begin();
+		for(; theIt != m_freeBlocks.end(); ++theIt)
+		{
+			if(theIt->second < size)
+				continue;
+
+			offset = theIt->first;
+			GLuint remaining = theIt->second - size;
+			m_freeBlocks.erase(theIt);
+			if(remaining)
+				m_freeBlocks[offset + size] = remaining;
+
+			m_freeSpace -= size;
+			return true;
+		}
+
+		return false;
+	}
+
+	void RangeAllocator::Free(GLuint offset, GLuint size)
+	{
+		if(!size)
+			return;
+
+		m_freeSpace += size;
+
+		std::map<GLuint, GLuint>::iterator nextIt = m_freeBlocks.lower_bound(offset);
+		if(nextIt != m_freeBlocks.end() && offset + size == nextIt->first)
+		{
+			size += nextIt->second;
+			m_freeBlocks.erase(nextIt++);
+		}
+
+		if(nextIt != m_freeBlocks.begin())
+		{
+			std::map<GLuint, GLuint>::iterator prevIt = nextIt;
+			--prevIt;
+			if(prevIt->first + prevIt->second == offset)
+			{
+				prevIt->second += size;
+				return;
+			}
+		}
+
+		m_freeBlocks[offset] = size;
+	}
+
+	namespace
+	{
+		bool SameAttribFormat(const MeshAttribute &lhs, const MeshAttribute &rhs)
+		{
+			return lhs.eType == rhs.eType && lhs.iSize == rhs.iSize &&
+				lhs.bNormalized == rhs.bNormalized && lhs.bIsIntegral == rhs.bIsIntegral;
+		}
+
+		template<typename T>
+		void WriteIndices(const std::vector<GLuint> &indices, std::vector<GLubyte> &buffer)
+		{
+			buffer.resize(indices.size() * sizeof(T));
+			T *pOut = reinterpret_cast<T*>(&buffer[0]);
+			for(size_t iLoop = 0; iLoop < indices.size(); iLoop++)
+				pOut[iLoop] = (T)indices[iLoop];
+		}
+
+		bool CompareFirst(const std::pair<GLuint, size_t> &lhs, const std::pair<GLuint, size_t> &rhs)
+		{
+			return lhs.first < rhs.first;
+		}
+	}
+
+	MeshArena::MeshArena(const std::vector<MeshAttribute> &format, GLuint vertexCapacity,
+		GLuint indexCapacity, GLenum eIndexType)
+		: m_format(format)
+		, m_vertexStride(0)
+		, m_eIndexType(eIndexType)
+		, m_vertexBuffer(0)
+		, m_indexBuffer(0)
+		, m_vao(0)
+		, m_bIsBound(false)
+	{
+		//Interleaved, with each attribute 4-byte aligned.
+		for(size_t iAttrib = 0; iAttrib < m_format.size(); iAttrib++)
+		{
+			m_format[iAttrib].data.clear();
+			m_attribOffsets.push_back(m_vertexStride);
+			m_vertexStride += (m_format[iAttrib].VertexBytes() + 3) & ~size_t(3);
+		}
+
+		if(!m_vertexStride)
+			throw std::runtime_error("A mesh arena needs at least one attribute.");
+
+		glGenVertexArrays(1, &m_vao);
+		Repack(vertexCapacity, indexCapacity);
+	}
+
+	MeshArena::~MeshArena()
+	{
+		GLStateCache &stateCache = GetGLStateCache();
+		stateCache.DeleteBuffer(m_vertexBuffer);
+		stateCache.DeleteBuffer(m_indexBuffer);
+		stateCache.DeleteVertexArray(m_vao);
+	}
+
+	MeshArena::MeshId MeshArena::AddMesh(const MeshGeometry &geom)
+	{
+		if(geom.NumVertices() == 0)
+			throw std::runtime_error("The mesh has no vertices to add to the arena.");
+
+		std::vector<const MeshAttribute *> sources(m_format.size());
+		for(size_t iAttrib = 0; iAttrib < m_format.size(); iAttrib++)
+		{
+			sources[iAttrib] = geom.FindAttrib(m_format[iAttrib].iAttribIx);
+			if(!sources[iAttrib] || !SameAttribFormat(*sources[iAttrib], m_format[iAttrib]))
+				throw std::runtime_error("The mesh's attributes do not match the arena's vertex format.");
+		}
+
+		GLuint restartIndex = MaxIndexValue(m_eIndexType);
+		if(!geom.indices.empty() && geom.NumVertices() > restartIndex)
+			throw std::runtime_error("The mesh has too many vertices for the arena's index type.");
+
+		ArenaMesh mesh;
+		mesh.bInUse = true;
+		mesh.numVertices = (GLuint)geom.NumVertices();
+		mesh.numIndices = (GLuint)geom.indices.size();
+		mesh.cmds = geom.cmds;
+
+		if(!AllocateRanges(mesh))
+		{
+			Defragment();
+			if(!AllocateRanges(mesh))
+			{
+				//After defragmenting, the free space is contiguous; grow whichever buffer lacks room.
+				GLuint vertexCapacity = m_vertexAlloc.GetCapacity();
+				GLuint indexCapacity = m_indexAlloc.GetCapacity();
+				if(m_vertexAlloc.GetFreeSpace() < mesh.numVertices)
+					vertexCapacity = std::max(vertexCapacity * 2, vertexCapacity + mesh.numVertices);
+				if(m_indexAlloc.GetFreeSpace() < mesh.numIndices)
+					indexCapacity = std::max(indexCapacity * 2, indexCapacity + mesh.numIndices);
+
+				Repack(vertexCapacity, indexCapacity);
+				AllocateRanges(mesh);
+			}
+		}
+
+		std::vector<GLubyte> vertexData(mesh.numVertices * m_vertexStride);
+		for(size_t iAttrib = 0; iAttrib < m_format.size(); iAttrib++)
+		{
+			const MeshAttribute &source = *sources[iAttrib];
+			size_t vertexBytes = source.VertexBytes();
+			for(GLuint iVertex = 0; iVertex < mesh.numVertices; iVertex++)
+			{
+				memcpy(&vertexData[iVertex * m_vertexStride + m_attribOffsets[iAttrib]],
+					&source.data[iVertex * vertexBytes], vertexBytes);
+			}
+		}
+
+		GLStateCache &stateCache = GetGLStateCache();
+		stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, mesh.baseVertex * m_vertexStride, vertexData.size(), &vertexData[0]);
+
+		if(mesh.numIndices)
+		{
+			//The arena has a single restart index, the largest value of its index type.
+			std::vector<GLuint> indices = geom.indices;
+			for(size_t iCmd = 0; iCmd < mesh.cmds.size(); iCmd++)
+			{
+				MeshRenderCmd &cmd = mesh.cmds[iCmd];
+				if(!cmd.bIsIndexedCmd || !cmd.bPrimRestart || cmd.primRestart == restartIndex)
+					continue;
+
+				std::vector<GLuint>::iterator startIt = indices.begin() + cmd.start;
+				std::replace(startIt, startIt + cmd.elemCount, cmd.primRestart, restartIndex);
+				cmd.primRestart = restartIndex;
+			}
+
+			std::vector<GLubyte> indexData;
+			switch(m_eIndexType)
+			{
+			case GL_UNSIGNED_BYTE: WriteIndices<GLubyte>(indices, indexData); break;
+			case GL_UNSIGNED_SHORT: WriteIndices<GLushort>(indices, indexData); break;
+			default: WriteIndices<GLuint>(indices, indexData); break;
+			}
+
+			stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, mesh.firstIndex * IndexTypeBytes(m_eIndexType),
+				indexData.size(), &indexData[0]);
+		}
+
+		stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		MeshId meshId;
+		if(m_freeIds.empty())
+		{
+			meshId = (MeshId)m_meshes.size();
+			m_meshes.push_back(mesh);
+		}
+		else
+		{
+			meshId = m_freeIds.back();
+			m_freeIds.pop_back();
+			m_meshes[meshId] = mesh;
+		}
+
+		return meshId;
+	}
+
+	void MeshArena::RemoveMesh(MeshId meshId)
+	{
+		ArenaMesh &mesh = m_meshes[meshId];
+		if(!mesh.bInUse)
+			return;
+
+		m_vertexAlloc.Free(mesh.baseVertex, mesh.numVertices);
+		m_indexAlloc.Free(mesh.firstIndex, mesh.numIndices);
+		mesh.bInUse = false;
+		mesh.cmds.clear();
+		m_freeIds.push_back(meshId);
+	}
+
+	void MeshArena::Bind()
+	{
+		GetGLStateCache().BindVertexArray(m_vao);
+		m_bIsBound = true;
+	}
+
+	void MeshArena::Unbind()
+	{
+		GetGLStateCache().BindVertexArray(0);
+		m_bIsBound = false;
+	}
+
+	void MeshArena::Render(MeshId meshId) const
+	{
+		const ArenaMesh &mesh = m_meshes[meshId];
+		if(!mesh.bInUse)
+			return;
+
+		//Elided when the arena is bound, or was the last VAO drawn with.
+		GLStateCache &stateCache = GetGLStateCache();
+		stateCache.BindVertexArray(m_vao);
+
+		size_t indexBytes = IndexTypeBytes(m_eIndexType);
+		for(size_t iCmd = 0; iCmd < mesh.cmds.size(); iCmd++)
+		{
+			const MeshRenderCmd &cmd = mesh.cmds[iCmd];
+			if(!cmd.bIsIndexedCmd)
+			{
+				glDrawArrays(cmd.ePrimType, mesh.baseVertex + cmd.start, cmd.elemCount);
+				continue;
+			}
+
+			stateCache.SetEnabled(GL_PRIMITIVE_RESTART, cmd.bPrimRestart);
+			if(cmd.bPrimRestart)
+				stateCache.PrimitiveRestartIndex(cmd.primRestart);
+
+			glDrawElementsBaseVertex(cmd.ePrimType, (GLsizei)cmd.elemCount, m_eIndexType,
+				(void*)((mesh.firstIndex + cmd.start) * indexBytes), (GLint)mesh.baseVertex);
+		}
+	}
+
+	void MeshArena::Defragment()
+	{
+		if(m_vertexAlloc.GetNumFreeBlocks() <= 1 && m_indexAlloc.GetNumFreeBlocks() <= 1)
+			return;
+
+		Repack(m_vertexAlloc.GetCapacity(), m_indexAlloc.GetCapacity());
+	}
+
+	bool MeshArena::AllocateRanges(ArenaMesh &mesh)
+	{
+		mesh.baseVertex = 0;
+		mesh.firstIndex = 0;
+
+		if(mesh.numVertices && !m_vertexAlloc.Allocate(mesh.numVertices, mesh.baseVertex))
+			return false;
+
+		if(mesh.numIndices && !m_indexAlloc.Allocate(mesh.numIndices, mesh.firstIndex))
+		{
+			m_vertexAlloc.Free(mesh.baseVertex, mesh.numVertices);
+			return false;
+		}
+
+		return true;
+	}
+
+	//Copies every live mesh, in its current order, to the front of newly created buffers.
+	//Buffer-to-buffer copies cannot overlap, so compaction always goes through new buffers.
+	void MeshArena::Repack(GLuint vertexCapacity, GLuint indexCapacity)
+	{
+		GLuint newBuffers[2] = {0, 0};
+		glGenBuffers(2, newBuffers);
+
+		GLStateCache &stateCache = GetGLStateCache();
+		stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, newBuffers[0]);
+		glBufferData(GL_COPY_WRITE_BUFFER, vertexCapacity * m_vertexStride, NULL, GL_STATIC_DRAW);
+		stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, newBuffers[1]);
+		glBufferData(GL_COPY_WRITE_BUFFER, indexCapacity * IndexTypeBytes(m_eIndexType), NULL, GL_STATIC_DRAW);
+
+		RangeAllocator vertexAlloc(vertexCapacity);
+		RangeAllocator indexAlloc(indexCapacity);
+
+		std::vector<std::pair<GLuint, size_t> > order;
+		for(size_t iMesh = 0; iMesh < m_meshes.size(); iMesh++)
+		{
+			if(m_meshes[iMesh].bInUse)
+				order.push_back(std::make_pair(m_meshes[iMesh].baseVertex, iMesh));
+		}
+
+		std::sort(order.begin(), order.end(), CompareFirst);
+		stateCache.BindBuffer(GL_COPY_READ_BUFFER, m_vertexBuffer);
+		stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, newBuffers[0]);
+		for(size_t iLoop = 0; iLoop < order.size(); iLoop++)
+		{
+			ArenaMesh &mesh = m_meshes[order[iLoop].second];
+			GLuint newOffset = 0;
+			vertexAlloc.Allocate(mesh.numVertices, newOffset);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, mesh.baseVertex * m_vertexStride,
+				newOffset * m_vertexStride, mesh.numVertices * m_vertexStride);
+			mesh.baseVertex = newOffset;
+		}
+
+		for(size_t iLoop = 0; iLoop < order.size(); iLoop++)
+			order[iLoop].first = m_meshes[order[iLoop].second].firstIndex;
+
+		std::sort(order.begin(), order.end(), CompareFirst);
+		size_t indexBytes = IndexTypeBytes(m_eIndexType);
+		stateCache.BindBuffer(GL_COPY_READ_BUFFER, m_indexBuffer);
+		stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, newBuffers[1]);
+		for(size_t iLoop = 0; iLoop < order.size(); iLoop++)
+		{
+			ArenaMesh &mesh = m_meshes[order[iLoop].second];
+			if(!mesh.numIndices)
+				continue;
+
+			GLuint newOffset = 0;
+			indexAlloc.Allocate(mesh.numIndices, newOffset);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, mesh.firstIndex * indexBytes,
+				newOffset * indexBytes, mesh.numIndices * indexBytes);
+			mesh.firstIndex = newOffset;
+		}
+
+		stateCache.BindBuffer(GL_COPY_READ_BUFFER, 0);
+		stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		stateCache.DeleteBuffer(m_vertexBuffer);
+		stateCache.DeleteBuffer(m_indexBuffer);
+		m_vertexBuffer = newBuffers[0];
+		m_indexBuffer = newBuffers[1];
+		m_vertexAlloc = vertexAlloc;
+		m_indexAlloc = indexAlloc;
+
+		SetupVao();
+	}
+
+	void MeshArena::SetupVao()
+	{
+		GLStateCache &stateCache = GetGLStateCache();
+		stateCache.BindVertexArray(m_vao);
+		stateCache.BindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+		for(size_t iAttrib = 0; iAttrib < m_format.size(); iAttrib++)
+		{
+			const MeshAttribute &attrib = m_format[iAttrib];
+			glEnableVertexAttribArray(attrib.iAttribIx);
+			if(attrib.bIsIntegral)
+				glVertexAttribIPointer(attrib.iAttribIx, attrib.iSize, attrib.eType,
+					(GLsizei)m_vertexStride, (void*)m_attribOffsets[iAttrib]);
+			else
+				glVertexAttribPointer(attrib.iAttribIx, attrib.iSize, attrib.eType,
+					attrib.bNormalized ? GL_TRUE : GL_FALSE, (GLsizei)m_vertexStride, (void*)m_attribOffsets[iAttrib]);
+		}
+
+		stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+		stateCache.BindVertexArray(m_bIsBound ? m_vao : 0);
+		stateCache.BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
@@ -0,0 +1,110 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_ARENA_H
+#define FRAMEWORK_MESH_ARENA_H
+
+#include <vector>
+#include <map>
+#include "MeshGeometry.h"
+
+namespace Framework
+{
+	//Hands out ranges of a fixed-size space, first-fit. Freed ranges are merged with their neighbors.
+	class RangeAllocator
+	{
+	public:
+		explicit RangeAllocator(GLuint capacity = 0);
+
+		//Returns false if there is no free range large enough.
+		bool Allocate(GLuint size, GLuint &offset);
+		void Free(GLuint offset, GLuint size);
+
+		GLuint GetCapacity() const {return m_capacity;}
+		GLuint GetFreeSpace() const {return m_freeSpace;}
+		size_t GetNumFreeBlocks() const {return m_freeBlocks.size();}
+
+	private:
+		std::map<GLuint, GLuint> m_freeBlocks;		//Offset to size.
+		GLuint m_capacity;
+		GLuint m_freeSpace;
+	};
+
+	/**
+	Vertex and index buffers shared by many meshes, with a single VAO. Every mesh in the arena uses
+	the same interleaved vertex format, and is drawn with glDrawElementsBaseVertex, so drawing a
+	sequence of arena meshes needs only one VAO bind.
+
+	Meshes are added from prepared MeshGeometry. When there is no room left, the arena is first
+	defragmented; if that is not enough, the buffers are grown. Both move the data on the GPU, so
+	mesh IDs stay valid.
+	**/
+	class MeshArena
+	{
+	public:
+		typedef unsigned int MeshId;
+
+		//The vertex format is taken from the given attributes; their data is not used.
+		//Index data is stored per mesh, relative to its base vertex, so GL_UNSIGNED_SHORT works as long
+		//as no single mesh has 65535 or more vertices.
+		MeshArena(const std::vector<MeshAttribute> &format, GLuint vertexCapacity, GLuint indexCapacity,
+			GLenum eIndexType = GL_UNSIGNED_SHORT);
+		~MeshArena();
+
+		//Throws std::runtime_error if the geometry has no vertices, lacks one of the arena's attributes,
+		//or has one with a different type or size. Attributes not in the arena's format are dropped.
+		MeshId AddMesh(const MeshGeometry &geom);
+		void RemoveMesh(MeshId meshId);
+
+		//Render binds the VAO through the GL state cache, so repeated binds are already elided. Between
+		//Bind and Unbind, no other VAO may be bound.
+		void Bind();
+		void Unbind();
+		bool IsBound() const {return m_bIsBound;}
+
+		void Render(MeshId meshId) const;
+
+		//Moves every mesh to the front of the buffers, leaving a single free block in each.
+		void Defragment();
+
+		const RangeAllocator &GetVertexAllocator() const {return m_vertexAlloc;}
+		const RangeAllocator &GetIndexAllocator() const {return m_indexAlloc;}
+
+	private:
+		struct ArenaMesh
+		{
+			bool bInUse;
+			GLuint baseVertex;
+			GLuint numVertices;
+			GLuint firstIndex;
+			GLuint numIndices;
+			std::vector<MeshRenderCmd> cmds;
+		};
+
+		std::vector<MeshAttribute> m_format;
+		std::vector<size_t> m_attribOffsets;
+		size_t m_vertexStride;
+		GLenum m_eIndexType;
+
+		GLuint m_vertexBuffer;
+		GLuint m_indexBuffer;
+		GLuint m_vao;
+		bool m_bIsBound;
+
+		RangeAllocator m_vertexAlloc;
+		RangeAllocator m_indexAlloc;
+		std::vector<ArenaMesh> m_meshes;
+		std::vector<MeshId> m_freeIds;
+
+		bool AllocateRanges(ArenaMesh &mesh);
+		void Repack(GLuint vertexCapacity, GLuint indexCapacity);
+		void SetupVao();
+
+		MeshArena(const MeshArena &);
+		MeshArena &operator=(const MeshArena &);
+	};
+}
+
+
+#endif //FRAMEWORK_MESH_ARENA_H
@@ -0,0 +1,148 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <vector>
+#include <string>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include "MeshGeometry.h"
+#include "MeshBounds.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		//Returns the vertices used by the rendering commands, without duplicates.
+		void GetReferencedVertices(const MeshGeometry &geom, std::vector<GLuint> &vertices)
+		{
+			std::vector<bool> isReferenced(geom.NumVertices(), false);
+			for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+			{
+				const MeshRenderCmd &cmd = geom.cmds[iCmd];
+				for(GLuint iElem = cmd.start; iElem < cmd.start + cmd.elemCount; iElem++)
+				{
+					if(!cmd.bIsIndexedCmd)
+					{
+						isReferenced[iElem] = true;
+						continue;
+					}
+
+					GLuint index = geom.indices[iElem];
+					if(!(cmd.bPrimRestart && index == cmd.primRestart))
+						isReferenced[index] = true;
+				}
+			}
+
+			vertices.clear();
+			for(GLuint iVertex = 0; iVertex < isReferenced.size(); iVertex++)
+			{
+				if(isReferenced[iVertex])
+					vertices.push_back(iVertex);
+			}
+		}
+
+		glm::vec3 GetPosition(const MeshAttribute &positions, GLuint iVertex)
+		{
+			glm::vec3 position(0.0f);
+			for(int iComp = 0; iComp < positions.iSize && iComp < 3; iComp++)
+				position[iComp] = positions.GetComponent(iVertex, iComp);
+			return position;
+		}
+
+		size_t FindFarthest(const std::vector<glm::vec3> &points, const glm::vec3 &from)
+		{
+			size_t iFarthest = 0;
+			float maxDistSqr = -1.0f;
+			for(size_t iPoint = 0; iPoint < points.size(); iPoint++)
+			{
+				glm::vec3 diff = points[iPoint] - from;
+				float distSqr = glm::dot(diff, diff);
+				if(distSqr > maxDistSqr)
+				{
+					maxDistSqr = distSqr;
+					iFarthest = iPoint;
+				}
+			}
+
+			return iFarthest;
+		}
+	}
+
+	MeshBounds CalcBounds(const std::vector<glm::vec3> &points)
+	{
+		MeshBounds bounds;
+		if(points.empty())
+			return bounds;
+
+		bounds.boxMin = points[0];
+		bounds.boxMax = points[0];
+		for(size_t iPoint = 1; iPoint < points.size(); iPoint++)
+		{
+			bounds.boxMin = glm::min(bounds.boxMin, points[iPoint]);
+			bounds.boxMax = glm::max(bounds.boxMax, points[iPoint]);
+		}
+
+		//Ritter's sphere: start from two far-apart points, then grow to contain any outliers.
+		glm::vec3 pointA = points[FindFarthest(points, points[0])];
+		glm::vec3 pointB = points[FindFarthest(points, pointA)];
+		glm::vec3 center = (pointA + pointB) * 0.5f;
+		float radius = glm::length(pointB - pointA) * 0.5f;
+
+		for(size_t iPoint = 0; iPoint < points.size(); iPoint++)
+		{
+			float dist = glm::length(points[iPoint] - center);
+			if(dist > radius)
+			{
+				float newRadius = (radius + dist) * 0.5f;
+				center += (points[iPoint] - center) * ((newRadius - radius) / dist);
+				radius = newRadius;
+			}
+		}
+
+		//For box-like shapes, the sphere around the box center can be tighter.
+		glm::vec3 boxCenter = bounds.BoxCenter();
+		float boxRadius = glm::length(points[FindFarthest(points, boxCenter)] - boxCenter);
+		if(boxRadius < radius)
+		{
+			center = boxCenter;
+			radius = boxRadius;
+		}
+
+		bounds.sphereCenter = center;
+		bounds.sphereRadius = radius;
+		return bounds;
+	}
+
+	void CalcMeshBounds(MeshGeometry &geom)
+	{
+		geom.bounds = MeshBounds();
+
+		const MeshAttribute *pPositions = geom.FindAttrib(0);
+		if(pPositions)
+		{
+			std::vector<GLuint> vertices;
+			GetReferencedVertices(geom, vertices);
+
+			std::vector<glm::vec3> points(vertices.size());
+			for(size_t iLoop = 0; iLoop < vertices.size(); iLoop++)
+				points[iLoop] = GetPosition(*pPositions, vertices[iLoop]);
+
+			geom.bounds = CalcBounds(points);
+		}
+
+		//Named VAOs share the mesh's commands, so they only differ in whether they have positions.
+		for(size_t iVao = 0; iVao < geom.namedVaos.size(); iVao++)
+		{
+			MeshNamedVao &namedVao = geom.namedVaos[iVao];
+			namedVao.bounds = MeshBounds();
+
+			for(size_t iSource = 0; iSource < namedVao.sourceAttribs.size(); iSource++)
+			{
+				if(namedVao.sourceAttribs[iSource] == 0)
+					namedVao.bounds = geom.bounds;
+			}
+		}
+	}
+}
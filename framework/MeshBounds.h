@@ -0,0 +1,44 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_BOUNDS_H
+#define FRAMEWORK_MESH_BOUNDS_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Framework
+{
+	struct MeshGeometry;
+
+	//Model-space bounding volumes of a mesh's positions (attribute 0).
+	struct MeshBounds
+	{
+		//Creates empty bounds.
+		MeshBounds()
+			: boxMin(1.0f), boxMax(-1.0f), sphereCenter(0.0f), sphereRadius(-1.0f)
+		{}
+
+		glm::vec3 boxMin;
+		glm::vec3 boxMax;
+		glm::vec3 sphereCenter;
+		float sphereRadius;
+
+		//True if there are no positions, as for a named VAO without attribute 0.
+		bool IsEmpty() const {return sphereRadius < 0.0f;}
+
+		glm::vec3 BoxCenter() const {return (boxMin + boxMax) * 0.5f;}
+		glm::vec3 BoxHalfExtents() const {return (boxMax - boxMin) * 0.5f;}
+	};
+
+	//Computes the box and sphere around the given points.
+	MeshBounds CalcBounds(const std::vector<glm::vec3> &points);
+
+	//Fills in the bounds of the geometry and of each of its named VAOs. Only vertices that are
+	//referenced by a rendering command count.
+	void CalcMeshBounds(MeshGeometry &geom);
+}
+
+
+#endif //FRAMEWORK_MESH_BOUNDS_H
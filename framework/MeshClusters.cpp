@@ -0,0 +1,352 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <math.h>
+#include <vector>
+#include <limits>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include "MeshGeometry.h"
+#include "MeshIndices.h"
+#include "MeshBounds.h"
+#include "MeshClusters.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		glm::vec3 GetPosition(const MeshAttribute &positions, GLuint iVertex)
+		{
+			glm::vec3 position(0.0f);
+			for(int iComp = 0; iComp < positions.iSize && iComp < 3; iComp++)
+				position[iComp] = positions.GetComponent(iVertex, iComp);
+			return position;
+		}
+
+		//Greedily grows clusters over triangles that share vertices. Each step takes the candidate
+		//with the most vertices already in the cluster, then the one nearest the cluster's centroid.
+		class ClusterBuilder
+		{
+		public:
+			ClusterBuilder(const std::vector<GLuint> &triangles, const std::vector<glm::vec3> &positions)
+				: m_triangles(triangles)
+				, m_positions(positions)
+				, m_isAssigned(triangles.size() / 3, false)
+				, m_vertexCluster(positions.size(), std::numeric_limits<size_t>::max())
+				, m_centroidSum(0.0f)
+				, m_numInCluster(0)
+			{
+				//Triangles using each vertex, as ranges of one array.
+				m_vertexTriStart.assign(positions.size() + 1, 0);
+				for(size_t iLoop = 0; iLoop < triangles.size(); iLoop++)
+					m_vertexTriStart[triangles[iLoop] + 1]++;
+				for(size_t iVertex = 0; iVertex < positions.size(); iVertex++)
+					m_vertexTriStart[iVertex + 1] += m_vertexTriStart[iVertex];
+
+				m_vertexTris.resize(triangles.size());
+				std::vector<GLuint> fill(m_vertexTriStart.begin(), m_vertexTriStart.end() - 1);
+				for(size_t iLoop = 0; iLoop < triangles.size(); iLoop++)
+					m_vertexTris[fill[triangles[iLoop]]++] = (GLuint)(iLoop / 3);
+			}
+
+			//Appends the clustered triangles to indices.
+			void Build(size_t maxTriangles, std::vector<GLuint> &indices, std::vector<MeshCluster> &clusters)
+			{
+				size_t iNextSeed = 0;
+				size_t numTriangles = m_triangles.size() / 3;
+
+				for(;;)
+				{
+					//Start next to the previous cluster if possible, so neighboring clusters
+					//are close in the index buffer too.
+					size_t iSeed = numTriangles;
+					for(size_t iCand = 0; iCand < m_candidates.size(); iCand++)
+					{
+						if(!m_isAssigned[m_candidates[iCand]])
+						{
+							iSeed = m_candidates[iCand];
+							break;
+						}
+					}
+
+					if(iSeed == numTriangles)
+					{
+						while(iNextSeed < numTriangles && m_isAssigned[iNextSeed])
+							iNextSeed++;
+						if(iNextSeed == numTriangles)
+							return;
+						iSeed = iNextSeed;
+					}
+
+					MeshCluster cluster;
+					cluster.firstIndex = (GLuint)indices.size();
+					cluster.numTriangles = 0;
+					m_candidates.clear();
+					m_centroidSum = glm::vec3(0.0f);
+					m_numInCluster = 0;
+
+					size_t iClusterNum = clusters.size();
+					for(size_t iTri = iSeed; iTri != numTriangles; iTri = PickNext(iClusterNum))
+					{
+						AddToCluster(iTri, iClusterNum, indices);
+						cluster.numTriangles++;
+						if(cluster.numTriangles == maxTriangles)
+							break;
+					}
+
+					CalcClusterVolumes(indices, cluster);
+					clusters.push_back(cluster);
+				}
+			}
+
+		private:
+			const std::vector<GLuint> &m_triangles;
+			const std::vector<glm::vec3> &m_positions;
+
+			std::vector<GLuint> m_vertexTriStart;
+			std::vector<GLuint> m_vertexTris;
+
+			std::vector<bool> m_isAssigned;
+			std::vector<size_t> m_vertexCluster;
+			std::vector<GLuint> m_candidates;
+			glm::vec3 m_centroidSum;
+			size_t m_numInCluster;
+
+			glm::vec3 TriangleCentroid(size_t iTri) const
+			{
+				return (m_positions[m_triangles[iTri * 3]] + m_positions[m_triangles[iTri * 3 + 1]] +
+					m_positions[m_triangles[iTri * 3 + 2]]) / 3.0f;
+			}
+
+			void AddToCluster(size_t iTri, size_t iClusterNum, std::vector<GLuint> &indices)
+			{
+				m_isAssigned[iTri] = true;
+				m_centroidSum += TriangleCentroid(iTri);
+				m_numInCluster++;
+
+				for(int iCorner = 0; iCorner < 3; iCorner++)
+				{
+					GLuint iVertex = m_triangles[iTri * 3 + iCorner];
+					indices.push_back(iVertex);
+					if(m_vertexCluster[iVertex] == iClusterNum)
+						continue;
+
+					m_vertexCluster[iVertex] = iClusterNum;
+					for(GLuint iAdj = m_vertexTriStart[iVertex]; iAdj < m_vertexTriStart[iVertex + 1]; iAdj++)
+					{
+						if(!m_isAssigned[m_vertexTris[iAdj]])
+							m_candidates.push_back(m_vertexTris[iAdj]);
+					}
+				}
+			}
+
+			size_t PickNext(size_t iClusterNum)
+			{
+				size_t iBest = m_triangles.size() / 3;
+				int bestShared = 0;
+				float bestDistSqr = 0.0f;
+				glm::vec3 centroid = m_centroidSum / (float)m_numInCluster;
+
+				for(size_t iCand = 0; iCand < m_candidates.size(); )
+				{
+					GLuint iTri = m_candidates[iCand];
+					if(m_isAssigned[iTri])
+					{
+						m_candidates[iCand] = m_candidates.back();
+						m_candidates.pop_back();
+						continue;
+					}
+
+					int numShared = 0;
+					for(int iCorner = 0; iCorner < 3; iCorner++)
+					{
+						if(m_vertexCluster[m_triangles[iTri * 3 + iCorner]] == iClusterNum)
+							numShared++;
+					}
+
+					glm::vec3 diff = TriangleCentroid(iTri) - centroid;
+					float distSqr = glm::dot(diff, diff);
+					if(numShared > bestShared || (numShared == bestShared && distSqr < bestDistSqr))
+					{
+						iBest = iTri;
+						bestShared = numShared;
+						bestDistSqr = distSqr;
+					}
+
+					iCand++;
+				}
+
+				return iBest;
+			}
+
+			void CalcClusterVolumes(const std::vector<GLuint> &indices, MeshCluster &cluster) const
+			{
+				const GLuint *pIndices = &indices[cluster.firstIndex];
+				GLuint numIndices = cluster.numTriangles * 3;
+
+				std::vector<glm::vec3> points;
+				points.reserve(numIndices);
+				for(GLuint iLoop = 0; iLoop < numIndices; iLoop++)
+					points.push_back(m_positions[pIndices[iLoop]]);
+
+				MeshBounds bounds = CalcBounds(points);
+				cluster.sphereCenter = bounds.sphereCenter;
+				cluster.sphereRadius = bounds.sphereRadius;
+
+				std::vector<glm::vec3> normals;
+				glm::vec3 normalSum(0.0f);
+				for(GLuint iLoop = 0; iLoop < numIndices; iLoop += 3)
+				{
+					glm::vec3 normal = glm::cross(points[iLoop + 1] - points[iLoop],
+						points[iLoop + 2] - points[iLoop]);
+					float length = glm::length(normal);
+					if(length == 0.0f)
+						continue;
+
+					normals.push_back(normal / length);
+					normalSum += normals.back();
+				}
+
+				cluster.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+				cluster.coneCutoff = 2.0f;
+
+				float sumLength = glm::length(normalSum);
+				if(normals.empty() || sumLength == 0.0f)
+					return;
+
+				glm::vec3 axis = normalSum / sumLength;
+				float minDot = 1.0f;
+				for(size_t iNormal = 0; iNormal < normals.size(); iNormal++)
+					minDot = glm::min(minDot, glm::dot(axis, normals[iNormal]));
+
+				//Past 90 degrees, some view directions see both sides.
+				if(minDot <= 0.0f)
+					return;
+
+				cluster.coneAxis = axis;
+				cluster.coneCutoff = sqrtf(1.0f - minDot * minDot);
+			}
+		};
+	}
+
+	void BuildMeshClusters(MeshGeometry &geom, size_t maxTriangles)
+	{
+		geom.clusters.clear();
+		geom.iClusterCmd = -1;
+
+		const MeshAttribute *pPositions = geom.FindAttrib(0);
+		if(!pPositions || maxTriangles == 0)
+			return;
+
+		std::vector<GLuint> triangles;
+		std::vector<GLuint> newIndices;
+		std::vector<MeshRenderCmd> newCmds;
+		for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+		{
+			const MeshRenderCmd &cmd = geom.cmds[iCmd];
+			if(IsTriangleCmd(cmd))
+			{
+				AppendCmdTriangles(geom, cmd, triangles);
+				continue;
+			}
+
+			MeshRenderCmd newCmd = cmd;
+			if(cmd.bIsIndexedCmd)
+			{
+				newCmd.start = (GLuint)newIndices.size();
+				newIndices.insert(newIndices.end(), geom.indices.begin() + cmd.start,
+					geom.indices.begin() + cmd.start + cmd.elemCount);
+			}
+			newCmds.push_back(newCmd);
+		}
+
+		if(triangles.empty())
+			return;
+
+		std::vector<glm::vec3> positions(geom.NumVertices());
+		for(size_t iVertex = 0; iVertex < positions.size(); iVertex++)
+			positions[iVertex] = GetPosition(*pPositions, (GLuint)iVertex);
+
+		MeshRenderCmd clusterCmd;
+		clusterCmd.bIsIndexedCmd = true;
+		clusterCmd.ePrimType = GL_TRIANGLES;
+		clusterCmd.start = (GLuint)newIndices.size();
+		clusterCmd.elemCount = (GLuint)triangles.size();
+
+		ClusterBuilder builder(triangles, positions);
+		builder.Build(maxTriangles, newIndices, geom.clusters);
+
+		geom.iClusterCmd = (int)newCmds.size();
+		newCmds.push_back(clusterCmd);
+		geom.cmds.swap(newCmds);
+		geom.indices.swap(newIndices);
+	}
+
+	void CullMeshClusters(const std::vector<MeshCluster> &clusters, const glm::mat4 &modelToClip,
+		const glm::vec3 &modelCameraPos, bool bFrontFaceCW,
+		std::vector<MeshIndexRange> &ranges, ClusterCullStats &stats)
+	{
+		//The left, right, bottom and top planes, in model space.
+		glm::vec4 planes[4];
+		glm::vec4 rowW(modelToClip[0][3], modelToClip[1][3], modelToClip[2][3], modelToClip[3][3]);
+		for(int iAxis = 0; iAxis < 2; iAxis++)
+		{
+			glm::vec4 row(modelToClip[0][iAxis], modelToClip[1][iAxis], modelToClip[2][iAxis],
+				modelToClip[3][iAxis]);
+			planes[iAxis * 2] = rowW + row;
+			planes[iAxis * 2 + 1] = rowW - row;
+		}
+
+		float planeScales[4];
+		for(int iPlane = 0; iPlane < 4; iPlane++)
+			planeScales[iPlane] = glm::length(glm::vec3(planes[iPlane]));
+
+		for(size_t iCluster = 0; iCluster < clusters.size(); iCluster++)
+		{
+			const MeshCluster &cluster = clusters[iCluster];
+			bool bIsVisible = true;
+
+			for(int iPlane = 0; iPlane < 4 && bIsVisible; iPlane++)
+			{
+				float dist = glm::dot(glm::vec3(planes[iPlane]), cluster.sphereCenter) + planes[iPlane].w;
+				if(dist < -cluster.sphereRadius * planeScales[iPlane])
+					bIsVisible = false;
+			}
+
+			//Every point in the sphere has to be seen from behind by every normal in the cone.
+			if(bIsVisible && cluster.coneCutoff <= 1.0f)
+			{
+				glm::vec3 axis = bFrontFaceCW ? -cluster.coneAxis : cluster.coneAxis;
+				glm::vec3 toCenter = cluster.sphereCenter - modelCameraPos;
+				if(glm::dot(toCenter, axis) >= cluster.coneCutoff * glm::length(toCenter) +
+					cluster.sphereRadius * (1.0f + cluster.coneCutoff))
+				{
+					bIsVisible = false;
+				}
+			}
+
+			if(!bIsVisible)
+			{
+				stats.iClustersCulled++;
+				stats.iTrianglesCulled += cluster.numTriangles;
+				continue;
+			}
+
+			stats.iClustersDrawn++;
+			stats.iTrianglesDrawn += cluster.numTriangles;
+
+			GLuint numIndices = cluster.numTriangles * 3;
+			if(!ranges.empty() && ranges.back().firstIndex + ranges.back().numIndices == cluster.firstIndex)
+				ranges.back().numIndices += numIndices;
+			else
+			{
+				MeshIndexRange range;
+				range.firstIndex = cluster.firstIndex;
+				range.numIndices = numIndices;
+				ranges.push_back(range);
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_CLUSTERS_H
+#define FRAMEWORK_MESH_CLUSTERS_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Framework
+{
+	struct MeshGeometry;
+
+	//A small group of neighboring triangles that is culled as a unit. Its triangles are stored
+	//contiguously in MeshGeometry::indices, as part of a GL_TRIANGLES command.
+	struct MeshCluster
+	{
+		GLuint firstIndex;
+		GLuint numTriangles;
+
+		glm::vec3 sphereCenter;
+		float sphereRadius;
+
+		//Every triangle's normal is within the cone around coneAxis. Normals are taken with
+		//counter-clockwise front faces. coneCutoff is the sine of the cone's half-angle, or greater
+		//than 1 if the normals spread too far for the cluster to ever be backface culled.
+		glm::vec3 coneAxis;
+		float coneCutoff;
+	};
+
+	struct MeshIndexRange
+	{
+		GLuint firstIndex;
+		GLuint numIndices;
+	};
+
+	struct ClusterCullStats
+	{
+		ClusterCullStats()
+			: iClustersDrawn(0), iClustersCulled(0), iTrianglesDrawn(0), iTrianglesCulled(0)
+		{}
+
+		size_t iClustersDrawn;
+		size_t iClustersCulled;
+		size_t iTrianglesDrawn;
+		size_t iTrianglesCulled;
+	};
+
+	//Replaces every triangle list, strip and fan command with a single GL_TRIANGLES command at the
+	//end of the command list, whose triangles are grouped into clusters of at most maxTriangles.
+	//Other commands are kept as they are. Does nothing if the mesh has no triangles or no
+	//positions (attribute 0). This should be the last pass that moves index data around.
+	void BuildMeshClusters(MeshGeometry &geom, size_t maxTriangles = 64);
+
+	//Appends the index ranges of the clusters that may be visible, adding runs of neighboring
+	//clusters together as a single range. Clusters are tested against the side planes of the view
+	//frustum; the near and far planes are not used, since the tutorials draw with depth clamping.
+	//Backfacing clusters are rejected using modelCameraPos, the camera position in model space.
+	//The results are added to stats.
+	void CullMeshClusters(const std::vector<MeshCluster> &clusters, const glm::mat4 &modelToClip,
+		const glm::vec3 &modelCameraPos, bool bFrontFaceCW,
+		std::vector<MeshIndexRange> &ranges, ClusterCullStats &stats);
+}
+
+
+#endif //FRAMEWORK_MESH_CLUSTERS_H
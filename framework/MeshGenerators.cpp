@@ -0,0 +1,316 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include "MeshGeometry.h"
+#include "MeshGenerators.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		const float fPi = 3.14159265f;
+
+		//A grey shade that makes the shape read as 3D without lighting.
+		glm::vec4 TintColor(const glm::vec3 &normal)
+		{
+			const glm::vec3 lightDir = glm::normalize(glm::vec3(0.3f, 1.0f, 0.5f));
+			float shade = glm::clamp(0.65f + 0.35f * glm::dot(glm::normalize(normal), lightDir), 0.0f, 1.0f);
+			return glm::vec4(shade, shade, shade, 1.0f);
+		}
+
+		glm::vec3 CirclePoint(int iSegment, int numSegments)
+		{
+			float angle = 2.0f * fPi * iSegment / numSegments;
+			return glm::vec3(cosf(angle), 0.0f, sinf(angle));
+		}
+
+		template<typename T>
+		void AddFloatAttrib(GLuint iAttribIx, const std::vector<T> &values, MeshGeometry &geom)
+		{
+			MeshAttribute attrib;
+			attrib.iAttribIx = iAttribIx;
+			attrib.eType = GL_FLOAT;
+			attrib.iSize = sizeof(T) / sizeof(float);
+			attrib.data.resize(values.size() * sizeof(T));
+			if(!values.empty())
+				memcpy(&attrib.data[0], &values[0], attrib.data.size());
+			geom.attribs.push_back(attrib);
+		}
+
+		class GeometryBuilder
+		{
+		public:
+			GLuint AddVertex(const glm::vec3 &position, const glm::vec4 &color)
+			{
+				m_positions.push_back(position);
+				m_colors.push_back(color);
+				return (GLuint)m_positions.size() - 1;
+			}
+
+			GLuint AddVertex(const glm::vec3 &position, const glm::vec2 &texCoord)
+			{
+				m_positions.push_back(position);
+				m_texCoords.push_back(texCoord);
+				return (GLuint)m_positions.size() - 1;
+			}
+
+			//The vertices are given clockwise, as seen from the front.
+			void AddTriangle(GLuint iA, GLuint iB, GLuint iC)
+			{
+				m_indices.push_back(iA);
+				m_indices.push_back(iB);
+				m_indices.push_back(iC);
+			}
+
+			void AddQuad(GLuint iA, GLuint iB, GLuint iC, GLuint iD)
+			{
+				AddTriangle(iA, iB, iC);
+				AddTriangle(iA, iC, iD);
+			}
+
+			void Finish(MeshGeometry &geom)
+			{
+				geom = MeshGeometry();
+				AddFloatAttrib(0, m_positions, geom);
+				if(!m_colors.empty())
+					AddFloatAttrib(1, m_colors, geom);
+				if(!m_texCoords.empty())
+					AddFloatAttrib(5, m_texCoords, geom);
+
+				geom.indices.swap(m_indices);
+				geom.eIndexType = GL_UNSIGNED_INT;
+
+				MeshRenderCmd cmd;
+				cmd.bIsIndexedCmd = true;
+				cmd.ePrimType = GL_TRIANGLES;
+				cmd.start = 0;
+				cmd.elemCount = (GLuint)geom.indices.size();
+				geom.cmds.push_back(cmd);
+			}
+
+		private:
+			std::vector<glm::vec3> m_positions;
+			std::vector<glm::vec4> m_colors;
+			std::vector<glm::vec2> m_texCoords;
+			std::vector<GLuint> m_indices;
+		};
+
+		//A flat disc at the given height; the front faces up if bFacesUp is true.
+		void AddDisc(float height, bool bFacesUp, int numSegments, GeometryBuilder &builder)
+		{
+			glm::vec4 color = TintColor(glm::vec3(0.0f, bFacesUp ? 1.0f : -1.0f, 0.0f));
+			GLuint iCenter = builder.AddVertex(glm::vec3(0.0f, height, 0.0f), color);
+			GLuint iFirst = iCenter + 1;
+			for(int iSegment = 0; iSegment < numSegments; iSegment++)
+				builder.AddVertex(CirclePoint(iSegment, numSegments) * 0.5f + glm::vec3(0.0f, height, 0.0f), color);
+
+			for(int iSegment = 0; iSegment < numSegments; iSegment++)
+			{
+				GLuint iCurr = iFirst + iSegment;
+				GLuint iNext = iFirst + (iSegment + 1) % numSegments;
+				if(bFacesUp)
+					builder.AddTriangle(iCenter, iCurr, iNext);
+				else
+					builder.AddTriangle(iCenter, iNext, iCurr);
+			}
+		}
+	}
+
+	void GenerateCone(int numSegments, MeshGeometry &geom)
+	{
+		numSegments = std::max(numSegments, 3);
+		GeometryBuilder builder;
+
+		GLuint iApex = builder.AddVertex(glm::vec3(0.0f, 1.0f, 0.0f), TintColor(glm::vec3(0.0f, 1.0f, 0.0f)));
+		GLuint iFirst = iApex + 1;
+		for(int iSegment = 0; iSegment < numSegments; iSegment++)
+		{
+			//The slope of the side is 2:1, so its normal rises at half the rate it goes out.
+			glm::vec3 dir = CirclePoint(iSegment, numSegments);
+			builder.AddVertex(dir * 0.5f, TintColor(dir + glm::vec3(0.0f, 0.5f, 0.0f)));
+		}
+
+		for(int iSegment = 0; iSegment < numSegments; iSegment++)
+			builder.AddTriangle(iApex, iFirst + iSegment, iFirst + (iSegment + 1) % numSegments);
+
+		AddDisc(0.0f, false, numSegments, builder);
+		builder.Finish(geom);
+	}
+
+	void GenerateCylinder(int numSegments, MeshGeometry &geom)
+	{
+		numSegments = std::max(numSegments, 3);
+		GeometryBuilder builder;
+
+		//The side vertices come first, as top/bottom pairs.
+		for(int iSegment = 0; iSegment < numSegments; iSegment++)
+		{
+			glm::vec3 dir = CirclePoint(iSegment, numSegments);
+			builder.AddVertex(dir * 0.5f + glm::vec3(0.0f, 0.5f, 0.0f), TintColor(dir));
+			builder.AddVertex(dir * 0.5f - glm::vec3(0.0f, 0.5f, 0.0f), TintColor(dir));
+		}
+
+		for(int iSegment = 0; iSegment < numSegments; iSegment++)
+		{
+			GLuint iTop = iSegment * 2;
+			GLuint iNextTop = ((iSegment + 1) % numSegments) * 2;
+			builder.AddQuad(iTop, iTop + 1, iNextTop + 1, iNextTop);
+		}
+
+		AddDisc(0.5f, true, numSegments, builder);
+		AddDisc(-0.5f, false, numSegments, builder);
+		builder.Finish(geom);
+	}
+
+	void GenerateSphere(int numRings, int numSegments, MeshGeometry &geom)
+	{
+		numRings = std::max(numRings, 2);
+		numSegments = std::max(numSegments, 3);
+		GeometryBuilder builder;
+
+		GLuint iTopPole = builder.AddVertex(glm::vec3(0.0f, 0.5f, 0.0f), TintColor(glm::vec3(0.0f, 1.0f, 0.0f)));
+		for(int iRing = 1; iRing < numRings; iRing++)
+		{
+			float theta = fPi * iRing / numRings;
+			for(int iSegment = 0; iSegment < numSegments; iSegment++)
+			{
+				glm::vec3 normal = CirclePoint(iSegment, numSegments) * sinf(theta);
+				normal.y = cosf(theta);
+				builder.AddVertex(normal * 0.5f, TintColor(normal));
+			}
+		}
+		GLuint iBottomPole = builder.AddVertex(glm::vec3(0.0f, -0.5f, 0.0f), TintColor(glm::vec3(0.0f, -1.0f, 0.0f)));
+
+		for(int iSegment = 0; iSegment < numSegments; iSegment++)
+		{
+			GLuint iCurr = 1 + iSegment;
+			GLuint iNext = 1 + (iSegment + 1) % numSegments;
+			builder.AddTriangle(iTopPole, iCurr, iNext);
+		}
+
+		for(int iRing = 1; iRing < numRings - 1; iRing++)
+		{
+			GLuint iUpper = 1 + (iRing - 1) * numSegments;
+			GLuint iLower = iUpper + numSegments;
+			for(int iSegment = 0; iSegment < numSegments; iSegment++)
+			{
+				GLuint iNextSeg = (iSegment + 1) % numSegments;
+				builder.AddQuad(iUpper + iSegment, iLower + iSegment, iLower + iNextSeg, iUpper + iNextSeg);
+			}
+		}
+
+		GLuint iLastRing = 1 + (numRings - 2) * numSegments;
+		for(int iSegment = 0; iSegment < numSegments; iSegment++)
+		{
+			GLuint iCurr = iLastRing + iSegment;
+			GLuint iNext = iLastRing + (iSegment + 1) % numSegments;
+			builder.AddTriangle(iBottomPole, iNext, iCurr);
+		}
+
+		builder.Finish(geom);
+	}
+
+	void GenerateCube(int numDivisions, bool bFaceColors, MeshGeometry &geom)
+	{
+		numDivisions = std::max(numDivisions, 1);
+		GeometryBuilder builder;
+
+		//Each face is spanned by two axes whose cross product is its normal.
+		static const float faces[6][3][3] =
+		{
+			{{ 1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
+			{{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},
+			{{ 0, 1, 0}, {0, 0, 1}, {1, 0, 0}},
+			{{ 0,-1, 0}, {1, 0, 0}, {0, 0, 1}},
+			{{ 0, 0, 1}, {1, 0, 0}, {0, 1, 0}},
+			{{ 0, 0,-1}, {0, 1, 0}, {1, 0, 0}},
+		};
+
+		static const float faceColors[6][4] =
+		{
+			{1.0f, 0.0f, 0.0f, 1.0f},
+			{0.0f, 1.0f, 1.0f, 1.0f},
+			{0.0f, 1.0f, 0.0f, 1.0f},
+			{1.0f, 0.0f, 1.0f, 1.0f},
+			{0.0f, 0.0f, 1.0f, 1.0f},
+			{1.0f, 1.0f, 0.0f, 1.0f},
+		};
+
+		for(int iFace = 0; iFace < 6; iFace++)
+		{
+			glm::vec3 normal(faces[iFace][0][0], faces[iFace][0][1], faces[iFace][0][2]);
+			glm::vec3 axisU(faces[iFace][1][0], faces[iFace][1][1], faces[iFace][1][2]);
+			glm::vec3 axisV(faces[iFace][2][0], faces[iFace][2][1], faces[iFace][2][2]);
+			glm::vec4 color = bFaceColors ? glm::vec4(faceColors[iFace][0], faceColors[iFace][1],
+				faceColors[iFace][2], faceColors[iFace][3]) : TintColor(normal);
+
+			glm::vec3 corner = (normal - axisU - axisV) * 0.5f;
+			GLuint iFirst = 0;
+			for(int iV = 0; iV <= numDivisions; iV++)
+			{
+				for(int iU = 0; iU <= numDivisions; iU++)
+				{
+					glm::vec3 position = corner + axisU * ((float)iU / numDivisions) +
+						axisV * ((float)iV / numDivisions);
+					GLuint iVertex = builder.AddVertex(position, color);
+					if(iU == 0 && iV == 0)
+						iFirst = iVertex;
+				}
+			}
+
+			GLuint rowSize = numDivisions + 1;
+			for(int iV = 0; iV < numDivisions; iV++)
+			{
+				for(int iU = 0; iU < numDivisions; iU++)
+				{
+					GLuint iCorner = iFirst + iV * rowSize + iU;
+					builder.AddQuad(iCorner, iCorner + rowSize, iCorner + rowSize + 1, iCorner + 1);
+				}
+			}
+		}
+
+		builder.Finish(geom);
+	}
+
+	void GeneratePlane(int numDivisions, float texRepeat, MeshGeometry &geom)
+	{
+		numDivisions = std::max(numDivisions, 1);
+		GeometryBuilder builder;
+
+		for(int iZ = 0; iZ <= numDivisions; iZ++)
+		{
+			for(int iX = 0; iX <= numDivisions; iX++)
+			{
+				glm::vec3 position((float)iX / numDivisions - 0.5f, 0.0f, (float)iZ / numDivisions - 0.5f);
+				builder.AddVertex(position, glm::vec2(position.x, position.z) * texRepeat);
+			}
+		}
+
+		GLuint rowSize = numDivisions + 1;
+		for(int iZ = 0; iZ < numDivisions; iZ++)
+		{
+			for(int iX = 0; iX < numDivisions; iX++)
+			{
+				GLuint iCorner = iZ * rowSize + iX;
+				builder.AddQuad(iCorner, iCorner + 1, iCorner + rowSize + 1, iCorner + rowSize);
+				builder.AddQuad(iCorner, iCorner + rowSize, iCorner + rowSize + 1, iCorner + 1);
+			}
+		}
+
+		builder.Finish(geom);
+
+		MeshNamedVao texVao;
+		texVao.strName = "tex";
+		texVao.sourceAttribs.push_back(0);
+		texVao.sourceAttribs.push_back(5);
+		geom.namedVaos.push_back(texVao);
+	}
+}
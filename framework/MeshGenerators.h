@@ -0,0 +1,41 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_GENERATORS_H
+#define FRAMEWORK_MESH_GENERATORS_H
+
+
+namespace Framework
+{
+	struct MeshGeometry;
+
+	//These build the unit meshes used by the tutorials in code, with the same layout as the mesh
+	//files: float positions in attribute 0 and, except for the plane, float RGBA colors in
+	//attribute 1. Triangles are clockwise when seen from the front. The "Tint" meshes have grey
+	//colors, meant to be multiplied by a uniform color. The results are unprocessed; pass them
+	//to ProcessMeshGeometry before creating a Mesh.
+	//
+	//Tessellation parameters are clamped to the smallest value that still gives the shape.
+
+	//UnitConeTint: base of radius 0.5 at Y=0, apex at Y=1.
+	void GenerateCone(int numSegments, MeshGeometry &geom);
+
+	//UnitCylinderTint: radius 0.5, from Y=-0.5 to Y=0.5.
+	void GenerateCylinder(int numSegments, MeshGeometry &geom);
+
+	//UnitSphere: radius 0.5, centered on the origin. numRings counts the bands from pole to pole.
+	void GenerateSphere(int numRings, int numSegments, MeshGeometry &geom);
+
+	//UnitCubeTint, or UnitCubeColor with bFaceColors: from -0.5 to 0.5 on each axis, with each face
+	//split into numDivisions x numDivisions squares.
+	void GenerateCube(int numDivisions, bool bFaceColors, MeshGeometry &geom);
+
+	//UnitPlane: from -0.5 to 0.5 in X and Z at Y=0, visible from both sides, split into
+	//numDivisions x numDivisions squares. Texture coordinates are in attribute 5, repeating
+	//texRepeat times across the plane, and the "tex" VAO uses only them and the positions.
+	void GeneratePlane(int numDivisions, float texRepeat, MeshGeometry &geom);
+}
+
+
+#endif //FRAMEWORK_MESH_GENERATORS_H
@@ -0,0 +1,692 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/half_float.hpp>
+#include "framework.h"
+#include "MeshGeometry.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		struct XmlElement
+		{
+			std::string strName;
+			std::map<std::string, std::string> attribs;
+			std::string strText;
+			std::vector<XmlElement> children;
+
+			const std::string *FindAttrib(const char *strAttribName) const
+			{
+				std::map<std::string, std::string>::const_iterator theIt = attribs.find(strAttribName);
+				if(theIt == attribs.end())
+					return NULL;
+				return &theIt->second;
+			}
+
+			const std::string &GetAttrib(const char *strAttribName) const
+			{
+				const std::string *pValue = FindAttrib(strAttribName);
+				if(!pValue)
+					throw std::runtime_error("The '" + strName + "' element must have a '" +
+						strAttribName + "' attribute.");
+				return *pValue;
+			}
+		};
+
+		//Just enough XML to read mesh files: elements, attributes, text, comments and
+		//processing instructions. No DTDs or CDATA.
+		class XmlReader
+		{
+		public:
+			XmlReader(const std::string &strText, const std::string &strFilename)
+				: m_strText(strText)
+				, m_strFilename(strFilename)
+				, m_pos(0)
+			{}
+
+			void ParseDocument(XmlElement &root)
+			{
+				SkipMisc();
+				if(!Match('<'))
+					Throw("Expected a root element.");
+				ParseElement(root);
+				SkipMisc();
+				if(m_pos != m_strText.size())
+					Throw("Unexpected data after the root element.");
+			}
+
+		private:
+			const std::string &m_strText;
+			const std::string &m_strFilename;
+			size_t m_pos;
+
+			void Throw(const std::string &strMessage)
+			{
+				std::ostringstream theStream;
+				theStream << m_strFilename << ": " << strMessage << " (at character " << m_pos << ")";
+				throw std::runtime_error(theStream.str());
+			}
+
+			bool AtEnd() const {return m_pos >= m_strText.size();}
+			char Peek() const {return AtEnd() ? '\0' : m_strText[m_pos];}
+
+			bool Match(char c)
+			{
+				if(Peek() != c)
+					return false;
+				++m_pos;
+				return true;
+			}
+
+			bool StartsWith(const char *strPrefix) const
+			{
+				return m_strText.compare(m_pos, strlen(strPrefix), strPrefix) == 0;
+			}
+
+			void SkipWhitespace()
+			{
+				while(!AtEnd() && isspace((unsigned char)m_strText[m_pos]))
+					++m_pos;
+			}
+
+			void SkipPast(const char *strTerminator)
+			{
+				size_t endPos = m_strText.find(strTerminator, m_pos);
+				if(endPos == std::string::npos)
+					Throw(std::string("Missing '") + strTerminator + "'.");
+				m_pos = endPos + strlen(strTerminator);
+			}
+
+			//Skips whitespace, comments, processing instructions and doctype declarations.
+			void SkipMisc()
+			{
+				for(;;)
+				{
+					SkipWhitespace();
+					if(StartsWith("<?"))
+						SkipPast("?>");
+					else if(StartsWith("<!--"))
+						SkipPast("-->");
+					else if(StartsWith("<!"))
+						SkipPast(">");
+					else
+						return;
+				}
+			}
+
+			std::string ParseName()
+			{
+				size_t startPos = m_pos;
+				while(!AtEnd())
+				{
+					char c = m_strText[m_pos];
+					if(isspace((unsigned char)c) || c == '=' || c == '>' || c == '/' || c == '<')
+						break;
+					++m_pos;
+				}
+
+				if(startPos == m_pos)
+					Throw("Expected a name.");
+
+				//Namespace prefixes are ignored; mesh files only use the default namespace.
+				std::string strName = m_strText.substr(startPos, m_pos - startPos);
+				size_t colonPos = strName.find(':');
+				if(colonPos != std::string::npos && strName.compare(0, colonPos, "xmlns") != 0)
+					strName.erase(0, colonPos + 1);
+				return strName;
+			}
+
+			void AppendDecoded(std::string &strOut, size_t startPos, size_t endPos)
+			{
+				while(startPos < endPos)
+				{
+					size_t ampPos = m_strText.find('&', startPos);
+					if(ampPos == std::string::npos || ampPos >= endPos)
+					{
+						strOut.append(m_strText, startPos, endPos - startPos);
+						return;
+					}
+
+					strOut.append(m_strText, startPos, ampPos - startPos);
+					size_t semiPos = m_strText.find(';', ampPos);
+					if(semiPos == std::string::npos || semiPos >= endPos)
+						Throw("Unterminated entity reference.");
+
+					std::string strEntity = m_strText.substr(ampPos + 1, semiPos - ampPos - 1);
+					if(strEntity == "lt") strOut += '<';
+					else if(strEntity == "gt") strOut += '>';
+					else if(strEntity == "amp") strOut += '&';
+					else if(strEntity == "quot") strOut += '"';
+					else if(strEntity == "apos") strOut += '\'';
+					else
+						Throw("Unknown entity '&" + strEntity + ";'.");
+
+					startPos = semiPos + 1;
+				}
+			}
+
+			//The opening '<' has already been consumed.
+			void ParseElement(XmlElement &elem)
+			{
+				elem.strName = ParseName();
+
+				for(;;)
+				{
+					SkipWhitespace();
+					if(Match('>'))
+						break;
+					if(StartsWith("/>"))
+					{
+						m_pos += 2;
+						return;
+					}
+
+					std::string strAttribName = ParseName();
+					SkipWhitespace();
+					if(!Match('='))
+						Throw("Expected '=' after attribute '" + strAttribName + "'.");
+					SkipWhitespace();
+
+					char quote = Peek();
+					if(quote != '"' && quote != '\'')
+						Throw("Expected a quoted value for attribute '" + strAttribName + "'.");
+					++m_pos;
+
+					size_t endPos = m_strText.find(quote, m_pos);
+					if(endPos == std::string::npos)
+						Throw("Unterminated value for attribute '" + strAttribName + "'.");
+
+					std::string &strValue = elem.attribs[strAttribName];
+					AppendDecoded(strValue, m_pos, endPos);
+					m_pos = endPos + 1;
+				}
+
+				//Element content.
+				for(;;)
+				{
+					size_t ltPos = m_strText.find('<', m_pos);
+					if(ltPos == std::string::npos)
+						Throw("Missing closing tag for '" + elem.strName + "'.");
+
+					AppendDecoded(elem.strText, m_pos, ltPos);
+					m_pos = ltPos;
+
+					if(StartsWith("<!--"))
+						SkipPast("-->");
+					else if(StartsWith("<?"))
+						SkipPast("?>");
+					else if(StartsWith("</"))
+					{
+						m_pos += 2;
+						if(ParseName() != elem.strName)
+							Throw("Mismatched closing tag for '" + elem.strName + "'.");
+						SkipWhitespace();
+						if(!Match('>'))
+							Throw("Expected '>'.");
+						return;
+					}
+					else
+					{
+						++m_pos;
+						elem.children.push_back(XmlElement());
+						ParseElement(elem.children.back());
+					}
+				}
+			}
+		};
+
+		struct AttribType
+		{
+			const char *strNameFromFile;
+			bool bNormalized;
+			GLenum eGLType;
+		};
+
+		const AttribType g_allAttributeTypes[] =
+		{
+			{"float",		false,	GL_FLOAT},
+			{"half",		false,	GL_HALF_FLOAT},
+			{"int",			false,	GL_INT},
+			{"uint",		false,	GL_UNSIGNED_INT},
+			{"norm-int",	true,	GL_INT},
+			{"norm-uint",	true,	GL_UNSIGNED_INT},
+			{"short",		false,	GL_SHORT},
+			{"ushort",		false,	GL_UNSIGNED_SHORT},
+			{"norm-short",	true,	GL_SHORT},
+			{"norm-ushort",	true,	GL_UNSIGNED_SHORT},
+			{"byte",		false,	GL_BYTE},
+			{"ubyte",		false,	GL_UNSIGNED_BYTE},
+			{"norm-byte",	true,	GL_BYTE},
+			{"norm-ubyte",	true,	GL_UNSIGNED_BYTE},
+		};
+
+		const AttribType *GetAttribType(const std::string &strType)
+		{
+			for(size_t iLoop = 0; iLoop < ARRAY_COUNT(g_allAttributeTypes); iLoop++)
+			{
+				if(strType == g_allAttributeTypes[iLoop].strNameFromFile)
+					return &g_allAttributeTypes[iLoop];
+			}
+
+			throw std::runtime_error("Unknown 'type' field '" + strType + "'.");
+		}
+
+		struct PrimitiveType
+		{
+			const char *strPrimitiveName;
+			GLenum eGLPrimType;
+		};
+
+		const PrimitiveType g_allPrimitiveTypes[] =
+		{
+			{"triangles",	GL_TRIANGLES},
+			{"tri-strip",	GL_TRIANGLE_STRIP},
+			{"tri-fan",		GL_TRIANGLE_FAN},
+			{"lines",		GL_LINES},
+			{"line-strip",	GL_LINE_STRIP},
+			{"line-loop",	GL_LINE_LOOP},
+			{"points",		GL_POINTS},
+		};
+
+		GLenum GetPrimitiveType(const std::string &strCmd)
+		{
+			for(size_t iLoop = 0; iLoop < ARRAY_COUNT(g_allPrimitiveTypes); iLoop++)
+			{
+				if(strCmd == g_allPrimitiveTypes[iLoop].strPrimitiveName)
+					return g_allPrimitiveTypes[iLoop].eGLPrimType;
+			}
+
+			throw std::runtime_error("Unknown 'cmd' field '" + strCmd + "'.");
+		}
+
+		GLenum GetIndexType(const std::string &strType)
+		{
+			if(strType == "uint")
+				return GL_UNSIGNED_INT;
+			if(strType == "ushort")
+				return GL_UNSIGNED_SHORT;
+			if(strType == "ubyte")
+				return GL_UNSIGNED_BYTE;
+
+			throw std::runtime_error("Improper 'type' attribute value on 'indices' element.");
+		}
+
+		template<typename T>
+		void AppendValue(std::vector<GLubyte> &data, T value)
+		{
+			size_t offset = data.size();
+			data.resize(offset + sizeof(T));
+			memcpy(&data[offset], &value, sizeof(T));
+		}
+
+		template<typename T>
+		T ReadValue(const std::vector<GLubyte> &data, size_t offset)
+		{
+			T value;
+			memcpy(&value, &data[offset], sizeof(T));
+			return value;
+		}
+
+		template<typename T>
+		T ClampToType(double fValue, const std::string &strType)
+		{
+			if(fValue < (double)std::numeric_limits<T>::min() || fValue > (double)std::numeric_limits<T>::max())
+				throw std::runtime_error("Value out of range for attribute type '" + strType + "'.");
+			return (T)fValue;
+		}
+
+		//Calls func(value) for each whitespace-separated number in the text.
+		template<typename Func>
+		void ForEachNumber(const std::string &strText, Func &func)
+		{
+			const char *pCurr = strText.c_str();
+			for(;;)
+			{
+				while(*pCurr && isspace((unsigned char)*pCurr))
+					++pCurr;
+				if(!*pCurr)
+					return;
+
+				char *pEnd = NULL;
+				double fValue = strtod(pCurr, &pEnd);
+				if(pEnd == pCurr)
+					throw std::runtime_error("Could not parse a number in '" + strText.substr(pCurr - strText.c_str(), 16) + "'.");
+				func(fValue);
+				pCurr = pEnd;
+			}
+		}
+
+		struct AttribValueWriter
+		{
+			AttribValueWriter(MeshAttribute &attrib, const std::string &strType)
+				: m_attrib(attrib), m_strType(strType) {}
+
+			void operator()(double fValue)
+			{
+				std::vector<GLubyte> &data = m_attrib.data;
+				switch(m_attrib.eType)
+				{
+				case GL_FLOAT: AppendValue(data, (GLfloat)fValue); break;
+				case GL_HALF_FLOAT: AppendValue(data, glm::detail::toFloat16((float)fValue)); break;
+				case GL_INT: AppendValue(data, ClampToType<GLint>(fValue, m_strType)); break;
+				case GL_UNSIGNED_INT: AppendValue(data, ClampToType<GLuint>(fValue, m_strType)); break;
+				case GL_SHORT: AppendValue(data, ClampToType<GLshort>(fValue, m_strType)); break;
+				case GL_UNSIGNED_SHORT: AppendValue(data, ClampToType<GLushort>(fValue, m_strType)); break;
+				case GL_BYTE: AppendValue(data, ClampToType<GLbyte>(fValue, m_strType)); break;
+				case GL_UNSIGNED_BYTE: AppendValue(data, ClampToType<GLubyte>(fValue, m_strType)); break;
+				}
+			}
+
+			MeshAttribute &m_attrib;
+			const std::string &m_strType;
+		};
+
+		struct IndexValueWriter
+		{
+			IndexValueWriter(std::vector<GLuint> &indices, GLuint maxValue)
+				: m_indices(indices), m_maxValue(maxValue) {}
+
+			void operator()(double fValue)
+			{
+				if(fValue < 0.0 || fValue > (double)m_maxValue || fValue != floor(fValue))
+					throw std::runtime_error("Index value out of range for the 'indices' type.");
+				m_indices.push_back((GLuint)fValue);
+			}
+
+			std::vector<GLuint> &m_indices;
+			GLuint m_maxValue;
+		};
+
+		GLuint ParseUInt(const std::string &strValue, const char *strWhat)
+		{
+			char *pEnd = NULL;
+			unsigned long value = strtoul(strValue.c_str(), &pEnd, 10);
+			if(pEnd == strValue.c_str() || *pEnd != '\0')
+				throw std::runtime_error(std::string("Could not parse the '") + strWhat + "' attribute.");
+			return (GLuint)value;
+		}
+
+		void ReadAttribute(const XmlElement &elem, MeshAttribute &attrib)
+		{
+			attrib.iAttribIx = ParseUInt(elem.GetAttrib("index"), "index");
+			if(attrib.iAttribIx >= 16)
+				throw std::runtime_error("Attribute index must be between 0 and 16.");
+
+			attrib.iSize = (int)ParseUInt(elem.GetAttrib("size"), "size");
+			if(attrib.iSize < 1 || attrib.iSize > 4)
+				throw std::runtime_error("Attribute size must be between 1 and 4.");
+
+			const std::string &strType = elem.GetAttrib("type");
+			const AttribType *pType = GetAttribType(strType);
+			attrib.eType = pType->eGLType;
+			attrib.bNormalized = pType->bNormalized;
+
+			if(const std::string *pIntegral = elem.FindAttrib("integral"))
+			{
+				if(*pIntegral == "true")
+					attrib.bIsIntegral = true;
+				else if(*pIntegral != "false")
+					throw std::runtime_error("Incorrect 'integral' value for the 'attribute'.");
+
+				if(attrib.bIsIntegral && (attrib.bNormalized || attrib.eType == GL_FLOAT || attrib.eType == GL_HALF_FLOAT))
+					throw std::runtime_error("Integral attributes must use a non-normalized integer type.");
+			}
+
+			AttribValueWriter writer(attrib, strType);
+			ForEachNumber(elem.strText, writer);
+
+			if(attrib.data.empty())
+				throw std::runtime_error("The attribute must have an array of values.");
+			if(attrib.data.size() % attrib.VertexBytes() != 0)
+				throw std::runtime_error("The attribute's data must be a multiple of its size in elements.");
+		}
+
+		//Returns the type of the index data in the file.
+		GLenum ReadIndices(const XmlElement &elem, MeshGeometry &geom)
+		{
+			MeshRenderCmd cmd;
+			cmd.bIsIndexedCmd = true;
+			cmd.ePrimType = GetPrimitiveType(elem.GetAttrib("cmd"));
+
+			GLenum eFileType = GetIndexType(elem.GetAttrib("type"));
+			if(const std::string *pRestart = elem.FindAttrib("prim-restart"))
+			{
+				cmd.bPrimRestart = true;
+				cmd.primRestart = ParseUInt(*pRestart, "prim-restart");
+			}
+
+			cmd.start = (GLuint)geom.indices.size();
+			IndexValueWriter writer(geom.indices, MaxIndexValue(eFileType));
+			ForEachNumber(elem.strText, writer);
+			cmd.elemCount = (GLuint)(geom.indices.size() - cmd.start);
+
+			if(cmd.elemCount == 0)
+				throw std::runtime_error("The index element must have an array of values.");
+
+			geom.cmds.push_back(cmd);
+			return eFileType;
+		}
+
+		void ReadArrays(const XmlElement &elem, MeshGeometry &geom)
+		{
+			MeshRenderCmd cmd;
+			cmd.bIsIndexedCmd = false;
+			cmd.ePrimType = GetPrimitiveType(elem.GetAttrib("cmd"));
+			cmd.start = ParseUInt(elem.GetAttrib("start"), "start");
+			cmd.elemCount = ParseUInt(elem.GetAttrib("count"), "count");
+			if(cmd.elemCount == 0)
+				throw std::runtime_error("`array` 'count' attribute must be greater than 0.");
+
+			geom.cmds.push_back(cmd);
+		}
+
+		void ReadVao(const XmlElement &elem, MeshNamedVao &vao)
+		{
+			vao.strName = elem.GetAttrib("name");
+			for(size_t iChild = 0; iChild < elem.children.size(); iChild++)
+			{
+				const XmlElement &source = elem.children[iChild];
+				if(source.strName != "source")
+					continue;
+				vao.sourceAttribs.push_back(ParseUInt(source.GetAttrib("attrib"), "attrib"));
+			}
+		}
+
+		void Validate(const MeshGeometry &geom)
+		{
+			if(geom.attribs.empty())
+				throw std::runtime_error("`mesh` node must have at least one `attribute` child.");
+
+			size_t numVertices = geom.NumVertices();
+			for(size_t iLoop = 0; iLoop < geom.attribs.size(); iLoop++)
+			{
+				if(geom.attribs[iLoop].NumVertices() != numVertices)
+					throw std::runtime_error("Attribute arrays must all be the same length.");
+
+				for(size_t iOther = 0; iOther < iLoop; iOther++)
+				{
+					if(geom.attribs[iOther].iAttribIx == geom.attribs[iLoop].iAttribIx)
+						throw std::runtime_error("Attribute index used more than once.");
+				}
+			}
+
+			for(size_t iVao = 0; iVao < geom.namedVaos.size(); iVao++)
+			{
+				const MeshNamedVao &vao = geom.namedVaos[iVao];
+				for(size_t iSource = 0; iSource < vao.sourceAttribs.size(); iSource++)
+				{
+					if(!geom.FindAttrib(vao.sourceAttribs[iSource]))
+						throw std::runtime_error("The 'attrib' in the vao '" + vao.strName + "' does not exist.");
+				}
+			}
+
+			for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+			{
+				const MeshRenderCmd &cmd = geom.cmds[iCmd];
+				if(!cmd.bIsIndexedCmd)
+				{
+					if((size_t)cmd.start + cmd.elemCount > numVertices)
+						throw std::runtime_error("`array` range goes past the end of the attribute arrays.");
+					continue;
+				}
+
+				for(GLuint iIndex = cmd.start; iIndex < cmd.start + cmd.elemCount; iIndex++)
+				{
+					GLuint index = geom.indices[iIndex];
+					if(index >= numVertices && !(cmd.bPrimRestart && index == cmd.primRestart))
+						throw std::runtime_error("Index value is larger than the number of vertices.");
+				}
+			}
+		}
+	}
+
+	size_t MeshAttribute::ComponentBytes() const
+	{
+		switch(eType)
+		{
+		case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: return 4;
+		case GL_HALF_FLOAT: case GL_SHORT: case GL_UNSIGNED_SHORT: return 2;
+		case GL_BYTE: case GL_UNSIGNED_BYTE: return 1;
+		}
+
+		return 0;
+	}
+
+	float MeshAttribute::GetComponent(size_t iVertex, int iComponent) const
+	{
+		size_t offset = (iVertex * iSize + iComponent) * ComponentBytes();
+		switch(eType)
+		{
+		case GL_FLOAT:
+			return ReadValue<GLfloat>(data, offset);
+		case GL_HALF_FLOAT:
+			return glm::detail::toFloat32(ReadValue<glm::detail::hdata>(data, offset));
+		case GL_INT:
+			return bNormalized ? glm::max(ReadValue<GLint>(data, offset) / 2147483647.0f, -1.0f) :
+				(float)ReadValue<GLint>(data, offset);
+		case GL_UNSIGNED_INT:
+			return bNormalized ? ReadValue<GLuint>(data, offset) / 4294967295.0f :
+				(float)ReadValue<GLuint>(data, offset);
+		case GL_SHORT:
+			return bNormalized ? glm::max(ReadValue<GLshort>(data, offset) / 32767.0f, -1.0f) :
+				(float)ReadValue<GLshort>(data, offset);
+		case GL_UNSIGNED_SHORT:
+			return bNormalized ? ReadValue<GLushort>(data, offset) / 65535.0f :
+				(float)ReadValue<GLushort>(data, offset);
+		case GL_BYTE:
+			return bNormalized ? glm::max(ReadValue<GLbyte>(data, offset) / 127.0f, -1.0f) :
+				(float)ReadValue<GLbyte>(data, offset);
+		case GL_UNSIGNED_BYTE:
+			return bNormalized ? ReadValue<GLubyte>(data, offset) / 255.0f :
+				(float)ReadValue<GLubyte>(data, offset);
+		}
+
+		return 0.0f;
+	}
+
+	const MeshAttribute *MeshGeometry::FindAttrib(GLuint iAttribIx) const
+	{
+		for(size_t iLoop = 0; iLoop < attribs.size(); iLoop++)
+		{
+			if(attribs[iLoop].iAttribIx == iAttribIx)
+				return &attribs[iLoop];
+		}
+
+		return NULL;
+	}
+
+	size_t IndexTypeBytes(GLenum eIndexType)
+	{
+		switch(eIndexType)
+		{
+		case GL_UNSIGNED_BYTE: return 1;
+		case GL_UNSIGNED_SHORT: return 2;
+		default: return 4;
+		}
+	}
+
+	GLuint MaxIndexValue(GLenum eIndexType)
+	{
+		switch(eIndexType)
+		{
+		case GL_UNSIGNED_BYTE: return 0xFF;
+		case GL_UNSIGNED_SHORT: return 0xFFFF;
+		default: return 0xFFFFFFFF;
+		}
+	}
+
+	void LoadMeshGeometry(const std::string &strFilename, MeshGeometry &geom)
+	{
+		LoadMeshGeometryFromPath(FindFileOrThrow(strFilename), geom);
+	}
+
+	void LoadMeshGeometryFromPath(const std::string &strDataFilename, MeshGeometry &geom)
+	{
+		std::ifstream fileStream(strDataFilename.c_str(), std::ios::in | std::ios::binary);
+		if(!fileStream.is_open())
+			throw std::runtime_error("Could not open the mesh file: " + strDataFilename);
+
+		std::ostringstream fileData;
+		fileData << fileStream.rdbuf();
+		std::string strFileData = fileData.str();
+
+		XmlElement meshElem;
+		XmlReader(strFileData, strDataFilename).ParseDocument(meshElem);
+		if(meshElem.strName != "mesh")
+			throw std::runtime_error("`mesh` node not found in mesh file: " + strDataFilename);
+
+		geom = MeshGeometry();
+
+		//The buffer keeps the widest index type of any <indices> element in the file.
+		geom.eIndexType = GL_UNSIGNED_BYTE;
+		try
+		{
+			for(size_t iChild = 0; iChild < meshElem.children.size(); iChild++)
+			{
+				const XmlElement &elem = meshElem.children[iChild];
+				if(elem.strName == "attribute")
+				{
+					geom.attribs.push_back(MeshAttribute());
+					ReadAttribute(elem, geom.attribs.back());
+				}
+				else if(elem.strName == "vao")
+				{
+					geom.namedVaos.push_back(MeshNamedVao());
+					ReadVao(elem, geom.namedVaos.back());
+				}
+				else if(elem.strName == "indices")
+				{
+					GLenum eFileType = ReadIndices(elem, geom);
+					if(IndexTypeBytes(eFileType) > IndexTypeBytes(geom.eIndexType))
+						geom.eIndexType = eFileType;
+				}
+				else if(elem.strName == "arrays")
+				{
+					ReadArrays(elem, geom);
+				}
+			}
+
+			Validate(geom);
+		}
+		catch(std::runtime_error &e)
+		{
+			throw std::runtime_error(strDataFilename + ": " + e.what());
+		}
+	}
+}
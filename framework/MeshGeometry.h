@@ -0,0 +1,92 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_GEOMETRY_H
+#define FRAMEWORK_MESH_GEOMETRY_H
+
+#include <vector>
+#include <string>
+#include "MeshBounds.h"
+#include "MeshClusters.h"
+#include "MeshSimplify.h"
+
+namespace Framework
+{
+	//A single vertex attribute array, stored exactly as it will be uploaded to the GPU.
+	struct MeshAttribute
+	{
+		MeshAttribute()
+			: iAttribIx(0xFFFFFFFF), eType(0), iSize(0), bNormalized(false), bIsIntegral(false)
+		{}
+
+		GLuint iAttribIx;
+		GLenum eType;			//GL_FLOAT, GL_HALF_FLOAT, GL_UNSIGNED_BYTE, etc.
+		int iSize;				//Number of components per vertex.
+		bool bNormalized;
+		bool bIsIntegral;		//If true, use glVertexAttribIPointer.
+		std::vector<GLubyte> data;
+
+		size_t ComponentBytes() const;
+		size_t VertexBytes() const {return ComponentBytes() * iSize;}
+		size_t NumVertices() const {return data.size() / VertexBytes();}
+
+		//Returns the given component of the given vertex as a float, applying normalization.
+		float GetComponent(size_t iVertex, int iComponent) const;
+	};
+
+	//A single draw call. Indexed commands reference a range of MeshGeometry::indices.
+	struct MeshRenderCmd
+	{
+		MeshRenderCmd()
+			: bIsIndexedCmd(false), ePrimType(0), start(0), elemCount(0), bPrimRestart(false), primRestart(0)
+		{}
+
+		bool bIsIndexedCmd;
+		GLenum ePrimType;
+		GLuint start;			//First index for indexed commands, first vertex otherwise.
+		GLuint elemCount;
+		bool bPrimRestart;		//Only if bIsIndexedCmd is true.
+		GLuint primRestart;		//Only if bPrimRestart is true.
+	};
+
+	struct MeshNamedVao
+	{
+		std::string strName;
+		std::vector<GLuint> sourceAttribs;
+		MeshBounds bounds;
+	};
+
+	//CPU-side form of a mesh, as read from a mesh file and before any GL objects are created.
+	//Load-time processing passes operate on this.
+	struct MeshGeometry
+	{
+		MeshGeometry() : eIndexType(GL_UNSIGNED_INT), iClusterCmd(-1) {}
+
+		std::vector<MeshAttribute> attribs;
+		std::vector<GLuint> indices;		//All <indices> blocks, concatenated in file order.
+		GLenum eIndexType;					//The type the indices are stored as in the buffer object.
+		std::vector<MeshRenderCmd> cmds;
+		std::vector<MeshNamedVao> namedVaos;
+		MeshBounds bounds;					//Filled in by CalcMeshBounds.
+		std::vector<MeshCluster> clusters;	//Filled in by BuildMeshClusters.
+		int iClusterCmd;					//The command the clusters belong to, or -1.
+		std::vector<MeshLod> lods;			//Filled in by BuildMeshLods. The full mesh is not one of them.
+
+		size_t NumVertices() const {return attribs.empty() ? 0 : attribs[0].NumVertices();}
+
+		//Returns NULL if there is no attribute with that index.
+		const MeshAttribute *FindAttrib(GLuint iAttribIx) const;
+	};
+
+	size_t IndexTypeBytes(GLenum eIndexType);
+	GLuint MaxIndexValue(GLenum eIndexType);
+
+	//Reads the given XML mesh file. Throws std::runtime_error if the file is not found or is malformed.
+	void LoadMeshGeometry(const std::string &strFilename, MeshGeometry &geom);
+	//As LoadMeshGeometry, but the path is used as it is, without searching the data directories.
+	void LoadMeshGeometryFromPath(const std::string &strPath, MeshGeometry &geom);
+}
+
+
+#endif //FRAMEWORK_MESH_GEOMETRY_H
@@ -0,0 +1,394 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <glload/gl_3_3.h>
+#include "MeshGeometry.h"
+#include "MeshIndices.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		bool IsListType(GLenum ePrimType)
+		{
+			return ePrimType == GL_TRIANGLES || ePrimType == GL_LINES || ePrimType == GL_POINTS;
+		}
+
+		GLuint PrimitiveSize(GLenum ePrimType)
+		{
+			switch(ePrimType)
+			{
+			case GL_TRIANGLES: return 3;
+			case GL_LINES: return 2;
+			default: return 1;
+			}
+		}
+
+		//The restart index is the largest value of the mesh's index type. It can only be used if
+		//no vertex needs that index.
+		bool GetRestartIndex(const MeshGeometry &geom, GLuint &restartIndex)
+		{
+			restartIndex = MaxIndexValue(geom.eIndexType);
+			return geom.NumVertices() <= restartIndex;
+		}
+
+		struct DirectedEdge
+		{
+			GLuint from;
+			GLuint to;
+			GLuint iTriangle;
+
+			bool operator<(const DirectedEdge &other) const
+			{
+				if(from != other.from)
+					return from < other.from;
+				return to < other.to;
+			}
+		};
+
+		class Stripifier
+		{
+		public:
+			Stripifier(const GLuint *pTriList, GLuint numIndices)
+			{
+				for(GLuint iIndex = 0; iIndex + 2 < numIndices; iIndex += 3)
+				{
+					GLuint a = pTriList[iIndex], b = pTriList[iIndex + 1], c = pTriList[iIndex + 2];
+					if(a == b || b == c || a == c)
+						continue;
+
+					m_triangles.push_back(a);
+					m_triangles.push_back(b);
+					m_triangles.push_back(c);
+				}
+
+				GLuint numTriangles = (GLuint)(m_triangles.size() / 3);
+				m_edges.reserve(m_triangles.size());
+				for(GLuint iTri = 0; iTri < numTriangles; iTri++)
+				{
+					for(int iVert = 0; iVert < 3; iVert++)
+					{
+						DirectedEdge edge;
+						edge.from = m_triangles[iTri * 3 + iVert];
+						edge.to = m_triangles[iTri * 3 + (iVert + 1) % 3];
+						edge.iTriangle = iTri;
+						m_edges.push_back(edge);
+					}
+				}
+
+				std::sort(m_edges.begin(), m_edges.end());
+				m_used.resize(numTriangles, false);
+			}
+
+			//Strips are started in the triangles' original order, which keeps the vertex cache
+			//behavior of the input. Each strip starts from whichever rotation of its first
+			//triangle gives the longest strip.
+			void BuildStrips(GLuint restartIndex, std::vector<GLuint> &outIndices)
+			{
+				std::vector<GLuint> currStrip, bestStrip;
+				std::vector<GLuint> currTris, bestTris;
+
+				for(GLuint iTri = 0; iTri < m_used.size(); iTri++)
+				{
+					if(m_used[iTri])
+						continue;
+
+					bestTris.clear();
+					for(int iRotation = 0; iRotation < 3; iRotation++)
+					{
+						GrowStrip(iTri, iRotation, currStrip, currTris);
+						if(currTris.size() > bestTris.size())
+						{
+							currStrip.swap(bestStrip);
+							currTris.swap(bestTris);
+						}
+					}
+
+					for(size_t iLoop = 0; iLoop < bestTris.size(); iLoop++)
+						m_used[bestTris[iLoop]] = true;
+
+					if(!outIndices.empty())
+						outIndices.push_back(restartIndex);
+					outIndices.insert(outIndices.end(), bestStrip.begin(), bestStrip.end());
+				}
+			}
+
+		private:
+			std::vector<GLuint> m_triangles;
+			std::vector<DirectedEdge> m_edges;
+			std::vector<bool> m_used;
+
+			//Returns an unused triangle containing the edge from->to, or -1.
+			int FindUnusedTriangle(GLuint from, GLuint to) const
+			{
+				DirectedEdge key;
+				key.from = from;
+				key.to = to;
+
+				std::vector<DirectedEdge>::const_iterator theIt =
+					std::lower_bound(m_edges.begin(), m_edges.end(), key);
+				for(; theIt != m_edges.end() && theIt->from == from && theIt->to == to; ++theIt)
+				{
+					if(!m_used[theIt->iTriangle])
+						return (int)theIt->iTriangle;
+				}
+
+				return -1;
+			}
+
+			//Grows a strip greedily, without committing the triangles it uses.
+			void GrowStrip(GLuint iStartTri, int iRotation, std::vector<GLuint> &strip, std::vector<GLuint> &tris)
+			{
+				strip.clear();
+				tris.clear();
+
+				for(int iVert = 0; iVert < 3; iVert++)
+					strip.push_back(m_triangles[iStartTri * 3 + (iRotation + iVert) % 3]);
+				tris.push_back(iStartTri);
+				m_used[iStartTri] = true;
+
+				for(;;)
+				{
+					//Odd triangles in a strip are wound (v[k+1], v[k], v[k+2]), so the edge the next
+					//triangle must contain alternates direction.
+					size_t iNextTri = strip.size() - 2;
+					GLuint x = strip[strip.size() - 2];
+					GLuint y = strip[strip.size() - 1];
+					int iFound = (iNextTri % 2 == 0) ? FindUnusedTriangle(x, y) : FindUnusedTriangle(y, x);
+					if(iFound < 0)
+						break;
+
+					const GLuint *pTri = &m_triangles[iFound * 3];
+					for(int iVert = 0; iVert < 3; iVert++)
+					{
+						if(pTri[iVert] != x && pTri[iVert] != y)
+						{
+							strip.push_back(pTri[iVert]);
+							break;
+						}
+					}
+
+					tris.push_back((GLuint)iFound);
+					m_used[iFound] = true;
+				}
+
+				for(size_t iLoop = 0; iLoop < tris.size(); iLoop++)
+					m_used[tris[iLoop]] = false;
+			}
+		};
+
+		bool CanMergeCmds(const MeshRenderCmd &prev, const MeshRenderCmd &next,
+			bool bCanRestart, GLuint restartIndex)
+		{
+			if(prev.bIsIndexedCmd != next.bIsIndexedCmd || prev.ePrimType != next.ePrimType)
+				return false;
+
+			if(IsListType(prev.ePrimType))
+			{
+				if(prev.elemCount % PrimitiveSize(prev.ePrimType) != 0)
+					return false;
+
+				if(!prev.bIsIndexedCmd)
+					return prev.start + prev.elemCount == next.start;
+
+				if(prev.bPrimRestart != next.bPrimRestart)
+					return false;
+				return !prev.bPrimRestart || prev.primRestart == next.primRestart;
+			}
+
+			//Connected primitives can only be joined with a restart index.
+			if(!prev.bIsIndexedCmd || !bCanRestart)
+				return false;
+			if(prev.bPrimRestart && prev.primRestart != restartIndex)
+				return false;
+			if(next.bPrimRestart && next.primRestart != restartIndex)
+				return false;
+			return true;
+		}
+
+		void AddTriangle(GLuint a, GLuint b, GLuint c, bool bKeepDegenerate, std::vector<GLuint> &triangles)
+		{
+			if(!bKeepDegenerate && (a == b || b == c || c == a))
+				return;
+
+			triangles.push_back(a);
+			triangles.push_back(b);
+			triangles.push_back(c);
+		}
+	}
+
+	MeshIndexStats CalcIndexStats(const MeshGeometry &geom)
+	{
+		MeshIndexStats stats;
+		stats.iIndexBytes = geom.indices.size() * IndexTypeBytes(geom.eIndexType);
+		stats.iNumDrawCmds = geom.cmds.size();
+		return stats;
+	}
+
+	bool IsTriangleCmd(const MeshRenderCmd &cmd)
+	{
+		return cmd.ePrimType == GL_TRIANGLES || cmd.ePrimType == GL_TRIANGLE_STRIP ||
+			cmd.ePrimType == GL_TRIANGLE_FAN;
+	}
+
+	void AppendCmdTriangles(const MeshGeometry &geom, const MeshRenderCmd &cmd,
+		std::vector<GLuint> &triangles, bool bKeepDegenerate)
+	{
+		std::vector<GLuint> elements(cmd.elemCount);
+		for(GLuint iElem = 0; iElem < cmd.elemCount; iElem++)
+			elements[iElem] = cmd.bIsIndexedCmd ? geom.indices[cmd.start + iElem] : cmd.start + iElem;
+
+		size_t iFirst = 0;
+		while(iFirst < elements.size())
+		{
+			size_t iEnd = iFirst;
+			while(iEnd < elements.size() && !(cmd.bPrimRestart && elements[iEnd] == cmd.primRestart))
+				iEnd++;
+
+			for(size_t iElem = iFirst; iElem + 2 < iEnd; )
+			{
+				switch(cmd.ePrimType)
+				{
+				case GL_TRIANGLES:
+					AddTriangle(elements[iElem], elements[iElem + 1], elements[iElem + 2],
+						bKeepDegenerate, triangles);
+					iElem += 3;
+					break;
+				case GL_TRIANGLE_STRIP:
+					if((iElem - iFirst) % 2)
+						AddTriangle(elements[iElem + 1], elements[iElem], elements[iElem + 2],
+							bKeepDegenerate, triangles);
+					else
+						AddTriangle(elements[iElem], elements[iElem + 1], elements[iElem + 2],
+							bKeepDegenerate, triangles);
+					iElem++;
+					break;
+				default:
+					AddTriangle(elements[iFirst], elements[iElem + 1], elements[iElem + 2],
+						bKeepDegenerate, triangles);
+					iElem++;
+					break;
+				}
+			}
+
+			iFirst = iEnd + 1;
+		}
+	}
+
+	void NarrowIndexType(MeshGeometry &geom)
+	{
+		GLenum eNewType = geom.NumVertices() <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		GLuint newRestart = MaxIndexValue(eNewType);
+
+		for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+		{
+			MeshRenderCmd &cmd = geom.cmds[iCmd];
+			if(!cmd.bIsIndexedCmd || !cmd.bPrimRestart)
+				continue;
+
+			if(cmd.primRestart != newRestart)
+			{
+				std::vector<GLuint>::iterator startIt = geom.indices.begin() + cmd.start;
+				std::replace(startIt, startIt + cmd.elemCount, cmd.primRestart, newRestart);
+				cmd.primRestart = newRestart;
+			}
+		}
+
+		geom.eIndexType = eNewType;
+	}
+
+	void StripifyTriangleLists(MeshGeometry &geom)
+	{
+		GLuint restartIndex = 0;
+		if(!GetRestartIndex(geom, restartIndex))
+			return;
+
+		std::vector<GLuint> newIndices;
+		newIndices.reserve(geom.indices.size());
+		std::vector<GLuint> strips;
+
+		for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+		{
+			MeshRenderCmd &cmd = geom.cmds[iCmd];
+			if(!cmd.bIsIndexedCmd)
+				continue;
+
+			const GLuint *pCmdIndices = &geom.indices[cmd.start];
+			GLuint newStart = (GLuint)newIndices.size();
+
+			if(cmd.ePrimType == GL_TRIANGLES && !cmd.bPrimRestart)
+			{
+				strips.clear();
+				Stripifier(pCmdIndices, cmd.elemCount).BuildStrips(restartIndex, strips);
+
+				if(!strips.empty() && strips.size() < cmd.elemCount)
+				{
+					newIndices.insert(newIndices.end(), strips.begin(), strips.end());
+					cmd.ePrimType = GL_TRIANGLE_STRIP;
+					cmd.bPrimRestart = std::find(strips.begin(), strips.end(), restartIndex) != strips.end();
+					cmd.primRestart = cmd.bPrimRestart ? restartIndex : 0;
+					cmd.start = newStart;
+					cmd.elemCount = (GLuint)strips.size();
+					continue;
+				}
+			}
+
+			newIndices.insert(newIndices.end(), pCmdIndices, pCmdIndices + cmd.elemCount);
+			cmd.start = newStart;
+		}
+
+		geom.indices.swap(newIndices);
+	}
+
+	void MergeRenderCmds(MeshGeometry &geom)
+	{
+		GLuint restartIndex = 0;
+		bool bCanRestart = GetRestartIndex(geom, restartIndex);
+
+		std::vector<GLuint> newIndices;
+		newIndices.reserve(geom.indices.size());
+		std::vector<MeshRenderCmd> newCmds;
+		newCmds.reserve(geom.cmds.size());
+
+		for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+		{
+			const MeshRenderCmd &cmd = geom.cmds[iCmd];
+			const GLuint *pCmdIndices = cmd.bIsIndexedCmd ? &geom.indices[cmd.start] : NULL;
+
+			if(!newCmds.empty() && CanMergeCmds(newCmds.back(), cmd, bCanRestart, restartIndex))
+			{
+				MeshRenderCmd &prev = newCmds.back();
+				if(cmd.bIsIndexedCmd)
+				{
+					if(!IsListType(cmd.ePrimType))
+					{
+						newIndices.push_back(restartIndex);
+						prev.elemCount++;
+						prev.bPrimRestart = true;
+						prev.primRestart = restartIndex;
+					}
+
+					newIndices.insert(newIndices.end(), pCmdIndices, pCmdIndices + cmd.elemCount);
+				}
+
+				prev.elemCount += cmd.elemCount;
+				continue;
+			}
+
+			newCmds.push_back(cmd);
+			if(cmd.bIsIndexedCmd)
+			{
+				newCmds.back().start = (GLuint)newIndices.size();
+				newIndices.insert(newIndices.end(), pCmdIndices, pCmdIndices + cmd.elemCount);
+			}
+		}
+
+		geom.indices.swap(newIndices);
+		geom.cmds.swap(newCmds);
+	}
+}
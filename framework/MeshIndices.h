@@ -0,0 +1,46 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_INDICES_H
+#define FRAMEWORK_MESH_INDICES_H
+
+#include <vector>
+
+namespace Framework
+{
+	struct MeshGeometry;
+	struct MeshRenderCmd;
+
+	struct MeshIndexStats
+	{
+		size_t iIndexBytes;
+		size_t iNumDrawCmds;
+	};
+
+	MeshIndexStats CalcIndexStats(const MeshGeometry &geom);
+
+	//True for GL_TRIANGLES, GL_TRIANGLE_STRIP and GL_TRIANGLE_FAN commands.
+	bool IsTriangleCmd(const MeshRenderCmd &cmd);
+
+	//Appends the command's triangles as a list, keeping their winding. Triangles that repeat an index
+	//are dropped unless bKeepDegenerate is true.
+	void AppendCmdTriangles(const MeshGeometry &geom, const MeshRenderCmd &cmd, std::vector<GLuint> &triangles,
+		bool bKeepDegenerate = false);
+
+	//Picks the smallest index type that can address every vertex of the mesh, while keeping the
+	//largest value of that type free for primitive restart. All primitive restart commands are
+	//moved to that value. GL_UNSIGNED_BYTE is never chosen; most hardware does not support it natively.
+	void NarrowIndexType(MeshGeometry &geom);
+
+	//Replaces each indexed GL_TRIANGLES command with triangle strips, joined by primitive restart,
+	//if that takes fewer indices. Winding order is preserved. Degenerate triangles are dropped.
+	void StripifyTriangleLists(MeshGeometry &geom);
+
+	//Combines adjacent commands that can be issued as a single draw. Strip, fan and loop commands
+	//are joined with primitive restart, so this should be called after NarrowIndexType.
+	void MergeRenderCmds(MeshGeometry &geom);
+}
+
+
+#endif //FRAMEWORK_MESH_INDICES_H
@@ -0,0 +1,164 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <glload/gl_3_3.h>
+#include "Mesh.h"
+#include "MeshGeometry.h"
+#include "MeshLoader.h"
+#include "ParallelFor.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		struct LoadJob
+		{
+			LoadJob() : bDone(false) {}
+
+			MeshGeometry geom;
+			std::exception_ptr error;
+			bool bDone;
+		};
+
+		class LoadQueue
+		{
+		public:
+			LoadQueue(const std::vector<std::string> &filenames, const std::vector<unsigned int> &loadFlags)
+				: m_filenames(filenames)
+				, m_loadFlags(loadFlags)
+				, m_jobs(filenames.size())
+				, m_nextJob(0)
+			{}
+
+			void WorkerLoop()
+			{
+				for(;;)
+				{
+					size_t iJob = m_nextJob++;
+					if(iJob >= m_jobs.size())
+						return;
+
+					LoadJob &job = m_jobs[iJob];
+					try
+					{
+						PrepareMeshGeometry(m_filenames[iJob], m_loadFlags[iJob], job.geom);
+					}
+					catch(...)
+					{
+						job.error = std::current_exception();
+					}
+
+					std::lock_guard<std::mutex> lock(m_doneMutex);
+					job.bDone = true;
+					m_doneCond.notify_all();
+				}
+			}
+
+			//Blocks until the given job has been processed by a worker.
+			LoadJob &WaitForJob(size_t iJob)
+			{
+				LoadJob &job = m_jobs[iJob];
+				std::unique_lock<std::mutex> lock(m_doneMutex);
+				while(!job.bDone)
+					m_doneCond.wait(lock);
+				return job;
+			}
+
+			//Workers will not start any more jobs.
+			void Cancel() {m_nextJob = m_jobs.size();}
+
+		private:
+			const std::vector<std::string> &m_filenames;
+			const std::vector<unsigned int> &m_loadFlags;
+			std::vector<LoadJob> m_jobs;
+			std::atomic<size_t> m_nextJob;
+			std::mutex m_doneMutex;
+			std::condition_variable m_doneCond;
+		};
+	}
+
+	std::vector<Mesh *> LoadMeshes(const std::vector<std::string> &filenames,
+		unsigned int loadFlags, unsigned int numThreads)
+	{
+		return LoadMeshes(filenames, std::vector<unsigned int>(filenames.size(), loadFlags), numThreads);
+	}
+
+	std::vector<Mesh *> LoadMeshes(const std::vector<std::string> &filenames,
+		const std::vector<unsigned int> &loadFlags, unsigned int numThreads)
+	{
+		if(loadFlags.size() != filenames.size())
+			throw std::runtime_error("There must be one set of load flags per mesh file.");
+
+		std::vector<Mesh *> meshes;
+		if(filenames.empty())
+			return meshes;
+
+		if(numThreads == 0)
+			numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+		numThreads = std::min(numThreads, (unsigned int)filenames.size());
+
+		LoadQueue queue(filenames, loadFlags);
+
+		//Declared after the queue, so that the workers are joined before it goes away. If starting
+		//one of them throws, the ones already running stop after their current job.
+		ThreadGroup workers;
+		try
+		{
+			for(unsigned int iThread = 0; iThread < numThreads; iThread++)
+				workers.Start(&LoadQueue::WorkerLoop, &queue);
+		}
+		catch(...)
+		{
+			queue.Cancel();
+			throw;
+		}
+
+		std::exception_ptr firstError;
+		for(size_t iJob = 0; iJob < filenames.size() && !firstError; iJob++)
+		{
+			LoadJob &job = queue.WaitForJob(iJob);
+			if(job.error)
+			{
+				firstError = job.error;
+				break;
+			}
+
+			try
+			{
+				meshes.push_back(new Mesh(job.geom));
+			}
+			catch(...)
+			{
+				firstError = std::current_exception();
+			}
+
+			//The CPU copy is no longer needed once the buffers exist.
+			job.geom = MeshGeometry();
+		}
+
+		if(firstError)
+			queue.Cancel();
+
+		workers.Join();
+
+		if(firstError)
+		{
+			for(size_t iMesh = 0; iMesh < meshes.size(); iMesh++)
+				delete meshes[iMesh];
+			std::rethrow_exception(firstError);
+		}
+
+		return meshes;
+	}
+}
@@ -0,0 +1,31 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_LOADER_H
+#define FRAMEWORK_MESH_LOADER_H
+
+#include <vector>
+#include <string>
+
+namespace Framework
+{
+	class Mesh;
+
+	//Reads, parses and processes the given mesh files on worker threads. Only the creation of the
+	//GL objects happens on the calling thread, which must have the GL context current. Meshes are
+	//created as soon as their files are ready, so uploading overlaps with the remaining decoding.
+	//
+	//The returned meshes are in the same order as the filenames, and the caller owns them.
+	//If any file fails to load, every mesh created so far is deleted and the first error is rethrown.
+	//If numThreads is 0, one thread per hardware core is used.
+	std::vector<Mesh *> LoadMeshes(const std::vector<std::string> &filenames,
+		unsigned int loadFlags = 0, unsigned int numThreads = 0);
+
+	//As above, with separate load flags for each file. Throws std::runtime_error if the sizes differ.
+	std::vector<Mesh *> LoadMeshes(const std::vector<std::string> &filenames,
+		const std::vector<unsigned int> &loadFlags, unsigned int numThreads = 0);
+}
+
+
+#endif //FRAMEWORK_MESH_LOADER_H
@@ -0,0 +1,543 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <iterator>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include "framework.h"
+#include "MeshGeometry.h"
+#include "MeshIndices.h"
+#include "MeshSimplify.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		//The weighted sum of squared distances to a set of planes, as a symmetric 4x4 matrix.
+		struct Quadric
+		{
+			Quadric() : weight(0.0) {memset(m, 0, sizeof(m));}
+
+			double m[10];
+			double weight;
+
+			void AddPlane(const glm::vec3 &normal, float dist, double planeWeight)
+			{
+				double a = normal.x, b = normal.y, c = normal.z, d = dist;
+				m[0] += planeWeight * a * a; m[1] += planeWeight * a * b;
+				m[2] += planeWeight * a * c; m[3] += planeWeight * a * d;
+				m[4] += planeWeight * b * b; m[5] += planeWeight * b * c; m[6] += planeWeight * b * d;
+				m[7] += planeWeight * c * c; m[8] += planeWeight * c * d;
+				m[9] += planeWeight * d * d;
+				weight += planeWeight;
+			}
+
+			Quadric &operator+=(const Quadric &other)
+			{
+				for(int iLoop = 0; iLoop < 10; iLoop++)
+					m[iLoop] += other.m[iLoop];
+				weight += other.weight;
+				return *this;
+			}
+
+			//The weighted mean of the squared distances, so that the error does not grow just
+			//because more planes have been merged in.
+			double Evaluate(const glm::vec3 &pos) const
+			{
+				if(weight == 0.0)
+					return 0.0;
+
+				double x = pos.x, y = pos.y, z = pos.z;
+				double error = m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x +
+					m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+					m[7] * z * z + 2.0 * m[8] * z + m[9];
+				return error > 0.0 ? error / weight : 0.0;
+			}
+		};
+
+		struct Collapse
+		{
+			double cost;
+			GLuint from;
+			GLuint to;
+			unsigned int fromVersion;
+			unsigned int toVersion;
+
+			//Lowest cost first, for std::priority_queue.
+			bool operator<(const Collapse &other) const {return cost > other.cost;}
+		};
+
+		class Simplifier
+		{
+		public:
+			Simplifier(const std::vector<GLuint> &triangles, const std::vector<glm::vec3> &positions,
+				const std::vector<bool> &isLocked)
+				: m_positions(positions)
+				, m_triangles(triangles)
+				, m_isTriAlive(triangles.size() / 3, true)
+				, m_vertexTris(positions.size())
+				, m_quadrics(positions.size())
+				, m_isLocked(isLocked)
+				, m_isRemoved(positions.size(), false)
+				, m_versions(positions.size(), 0)
+				, m_numTriangles(triangles.size() / 3)
+				, m_maxError(0.0)
+			{
+				for(size_t iTri = 0; iTri < m_numTriangles; iTri++)
+				{
+					for(int iCorner = 0; iCorner < 3; iCorner++)
+						m_vertexTris[m_triangles[iTri * 3 + iCorner]].push_back((GLuint)iTri);
+				}
+
+				for(size_t iTri = 0; iTri < m_numTriangles; iTri++)
+				{
+					glm::vec3 normal = TriangleNormal(iTri);
+					m_startNormals.push_back(normal);
+					float length = glm::length(normal);
+					if(length == 0.0f)
+						continue;
+
+					//Planes are weighted by area, so small triangles don't dominate the error.
+					double area = length * 0.5;
+					normal /= length;
+					for(int iCorner = 0; iCorner < 3; iCorner++)
+					{
+						GLuint iVertex = m_triangles[iTri * 3 + iCorner];
+						m_quadrics[iVertex].AddPlane(normal, -glm::dot(normal, m_positions[iVertex]), area);
+					}
+
+					//Keep border vertices near their border with a plane at right angles to the triangle.
+					for(int iCorner = 0; iCorner < 3; iCorner++)
+					{
+						GLuint iStart = m_triangles[iTri * 3 + iCorner];
+						GLuint iEnd = m_triangles[iTri * 3 + (iCorner + 1) % 3];
+						if(CountEdgeTriangles(iStart, iEnd) != 1)
+							continue;
+
+						glm::vec3 edgeNormal = glm::cross(m_positions[iEnd] - m_positions[iStart], normal);
+						float edgeLength = glm::length(edgeNormal);
+						if(edgeLength == 0.0f)
+							continue;
+
+						edgeNormal /= edgeLength;
+						float dist = -glm::dot(edgeNormal, m_positions[iStart]);
+						m_quadrics[iStart].AddPlane(edgeNormal, dist, edgeLength * edgeLength);
+						m_quadrics[iEnd].AddPlane(edgeNormal, dist, edgeLength * edgeLength);
+					}
+				}
+
+				for(GLuint iVertex = 0; iVertex < m_vertexTris.size(); iVertex++)
+					PushCollapses(iVertex);
+			}
+
+			//Collapses edges until no more than targetTriangles are left, or until nothing more
+			//can be collapsed.
+			void Simplify(size_t targetTriangles)
+			{
+				while(m_numTriangles > targetTriangles && !m_queue.empty())
+				{
+					Collapse collapse = m_queue.top();
+					m_queue.pop();
+
+					if(m_isRemoved[collapse.from] || m_isRemoved[collapse.to])
+						continue;
+					if(m_versions[collapse.from] != collapse.fromVersion ||
+						m_versions[collapse.to] != collapse.toVersion)
+						continue;
+					if(!CanCollapse(collapse.from, collapse.to))
+						continue;
+
+					DoCollapse(collapse.from, collapse.to);
+					m_maxError = std::max(m_maxError, collapse.cost);
+				}
+			}
+
+			size_t GetNumTriangles() const {return m_numTriangles;}
+			float GetError() const {return (float)sqrt(m_maxError);}
+
+			void AppendTriangles(std::vector<GLuint> &indices) const
+			{
+				for(size_t iTri = 0; iTri < m_isTriAlive.size(); iTri++)
+				{
+					if(m_isTriAlive[iTri])
+						indices.insert(indices.end(), &m_triangles[iTri * 3], &m_triangles[iTri * 3] + 3);
+				}
+			}
+
+		private:
+			const std::vector<glm::vec3> &m_positions;
+			std::vector<GLuint> m_triangles;
+			std::vector<bool> m_isTriAlive;
+			std::vector<std::vector<GLuint> > m_vertexTris;
+			std::vector<glm::vec3> m_startNormals;
+			std::vector<Quadric> m_quadrics;
+			std::vector<bool> m_isLocked;
+			std::vector<bool> m_isRemoved;
+			std::vector<unsigned int> m_versions;
+			std::priority_queue<Collapse> m_queue;
+			size_t m_numTriangles;
+			double m_maxError;
+
+			glm::vec3 TriangleNormal(size_t iTri) const
+			{
+				const glm::vec3 &pos0 = m_positions[m_triangles[iTri * 3]];
+				return glm::cross(m_positions[m_triangles[iTri * 3 + 1]] - pos0,
+					m_positions[m_triangles[iTri * 3 + 2]] - pos0);
+			}
+
+			bool TriangleHasVertex(GLuint iTri, GLuint iVertex) const
+			{
+				return m_triangles[iTri * 3] == iVertex || m_triangles[iTri * 3 + 1] == iVertex ||
+					m_triangles[iTri * 3 + 2] == iVertex;
+			}
+
+			size_t CountEdgeTriangles(GLuint iStart, GLuint iEnd) const
+			{
+				size_t count = 0;
+				const std::vector<GLuint> &tris = m_vertexTris[iStart];
+				for(size_t iLoop = 0; iLoop < tris.size(); iLoop++)
+				{
+					if(m_isTriAlive[tris[iLoop]] && TriangleHasVertex(tris[iLoop], iEnd))
+						count++;
+				}
+				return count;
+			}
+
+			void GetNeighbors(GLuint iVertex, std::vector<GLuint> &neighbors) const
+			{
+				neighbors.clear();
+				const std::vector<GLuint> &tris = m_vertexTris[iVertex];
+				for(size_t iLoop = 0; iLoop < tris.size(); iLoop++)
+				{
+					if(!m_isTriAlive[tris[iLoop]])
+						continue;
+
+					for(int iCorner = 0; iCorner < 3; iCorner++)
+					{
+						GLuint iOther = m_triangles[tris[iLoop] * 3 + iCorner];
+						if(iOther != iVertex)
+							neighbors.push_back(iOther);
+					}
+				}
+
+				std::sort(neighbors.begin(), neighbors.end());
+				neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+			}
+
+			bool IsBorderVertex(GLuint iVertex, const std::vector<GLuint> &neighbors) const
+			{
+				for(size_t iLoop = 0; iLoop < neighbors.size(); iLoop++)
+				{
+					if(CountEdgeTriangles(iVertex, neighbors[iLoop]) == 1)
+						return true;
+				}
+				return false;
+			}
+
+			bool CanCollapse(GLuint iFrom, GLuint iTo) const
+			{
+				if(m_isLocked[iFrom])
+					return false;
+
+				size_t edgeTris = CountEdgeTriangles(iFrom, iTo);
+				if(edgeTris == 0 || edgeTris > 2)
+					return false;
+
+				std::vector<GLuint> fromNeighbors, toNeighbors;
+				GetNeighbors(iFrom, fromNeighbors);
+				GetNeighbors(iTo, toNeighbors);
+
+				//Border vertices may only slide along the border.
+				if(edgeTris == 2 && IsBorderVertex(iFrom, fromNeighbors))
+					return false;
+
+				//The link condition: the only shared neighbors are the ones opposite the edge.
+				//Otherwise the collapse would pinch the surface into a non-manifold shape.
+				std::vector<GLuint> shared;
+				std::set_intersection(fromNeighbors.begin(), fromNeighbors.end(),
+					toNeighbors.begin(), toNeighbors.end(), std::back_inserter(shared));
+				if(shared.size() != edgeTris)
+					return false;
+
+				//No remaining triangle may flip over or become degenerate. Comparing with the starting
+				//normal as well keeps a run of small turns from adding up to a flip.
+				const std::vector<GLuint> &tris = m_vertexTris[iFrom];
+				for(size_t iLoop = 0; iLoop < tris.size(); iLoop++)
+				{
+					GLuint iTri = tris[iLoop];
+					if(!m_isTriAlive[iTri] || TriangleHasVertex(iTri, iTo))
+						continue;
+
+					glm::vec3 corners[3];
+					for(int iCorner = 0; iCorner < 3; iCorner++)
+					{
+						GLuint iVertex = m_triangles[iTri * 3 + iCorner];
+						corners[iCorner] = m_positions[iVertex == iFrom ? iTo : iVertex];
+					}
+
+					glm::vec3 newNormal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+					if(glm::dot(newNormal, TriangleNormal(iTri)) <= 0.0f ||
+						glm::dot(newNormal, m_startNormals[iTri]) <= 0.0f)
+						return false;
+				}
+
+				return true;
+			}
+
+			void DoCollapse(GLuint iFrom, GLuint iTo)
+			{
+				std::vector<GLuint> &fromTris = m_vertexTris[iFrom];
+				std::vector<GLuint> &toTris = m_vertexTris[iTo];
+				for(size_t iLoop = 0; iLoop < fromTris.size(); iLoop++)
+				{
+					GLuint iTri = fromTris[iLoop];
+					if(!m_isTriAlive[iTri])
+						continue;
+
+					if(TriangleHasVertex(iTri, iTo))
+					{
+						m_isTriAlive[iTri] = false;
+						m_numTriangles--;
+						continue;
+					}
+
+					for(int iCorner = 0; iCorner < 3; iCorner++)
+					{
+						if(m_triangles[iTri * 3 + iCorner] == iFrom)
+							m_triangles[iTri * 3 + iCorner] = iTo;
+					}
+					toTris.push_back(iTri);
+				}
+
+				std::vector<GLuint> aliveTris;
+				for(size_t iLoop = 0; iLoop < toTris.size(); iLoop++)
+				{
+					if(m_isTriAlive[toTris[iLoop]])
+						aliveTris.push_back(toTris[iLoop]);
+				}
+				toTris.swap(aliveTris);
+				fromTris.clear();
+
+				m_isRemoved[iFrom] = true;
+				m_quadrics[iTo] += m_quadrics[iFrom];
+				m_versions[iTo]++;
+				PushCollapses(iTo);
+			}
+
+			void PushCollapse(GLuint iFrom, GLuint iTo)
+			{
+				if(m_isLocked[iFrom])
+					return;
+
+				Quadric quadric = m_quadrics[iFrom];
+				quadric += m_quadrics[iTo];
+
+				Collapse collapse;
+				collapse.cost = quadric.Evaluate(m_positions[iTo]);
+				collapse.from = iFrom;
+				collapse.to = iTo;
+				collapse.fromVersion = m_versions[iFrom];
+				collapse.toVersion = m_versions[iTo];
+				m_queue.push(collapse);
+			}
+
+			//Queues the collapses of every edge around the vertex, in both directions.
+			void PushCollapses(GLuint iVertex)
+			{
+				std::vector<GLuint> neighbors;
+				GetNeighbors(iVertex, neighbors);
+				for(size_t iLoop = 0; iLoop < neighbors.size(); iLoop++)
+				{
+					PushCollapse(iVertex, neighbors[iLoop]);
+					PushCollapse(neighbors[iLoop], iVertex);
+				}
+			}
+		};
+
+		class VertexLess
+		{
+		public:
+			explicit VertexLess(const MeshGeometry &geom) : m_geom(geom) {}
+
+			bool operator()(GLuint iLeft, GLuint iRight) const
+			{
+				for(size_t iAttrib = 0; iAttrib < m_geom.attribs.size(); iAttrib++)
+				{
+					const MeshAttribute &attrib = m_geom.attribs[iAttrib];
+					size_t vertexBytes = attrib.VertexBytes();
+					int compare = memcmp(&attrib.data[iLeft * vertexBytes], &attrib.data[iRight * vertexBytes],
+						vertexBytes);
+					if(compare != 0)
+						return compare < 0;
+				}
+				return false;
+			}
+
+		private:
+			const MeshGeometry &m_geom;
+		};
+
+		bool PositionLess(const glm::vec3 &left, const glm::vec3 &right)
+		{
+			if(left.x != right.x)
+				return left.x < right.x;
+			if(left.y != right.y)
+				return left.y < right.y;
+			return left.z < right.z;
+		}
+
+		class PositionIndexLess
+		{
+		public:
+			explicit PositionIndexLess(const std::vector<glm::vec3> &positions) : m_positions(positions) {}
+
+			bool operator()(GLuint iLeft, GLuint iRight) const
+			{
+				return PositionLess(m_positions[iLeft], m_positions[iRight]);
+			}
+
+		private:
+			const std::vector<glm::vec3> &m_positions;
+		};
+
+		//Maps every vertex to the first vertex with exactly the same data.
+		void FindUniqueVertices(const MeshGeometry &geom, std::vector<GLuint> &remap)
+		{
+			std::vector<GLuint> order(geom.NumVertices());
+			for(GLuint iVertex = 0; iVertex < order.size(); iVertex++)
+				order[iVertex] = iVertex;
+
+			VertexLess less(geom);
+			std::stable_sort(order.begin(), order.end(), less);
+
+			remap.resize(order.size());
+			for(size_t iLoop = 0; iLoop < order.size(); iLoop++)
+			{
+				if(iLoop > 0 && !less(order[iLoop - 1], order[iLoop]))
+					remap[order[iLoop]] = remap[order[iLoop - 1]];
+				else
+					remap[order[iLoop]] = order[iLoop];
+			}
+		}
+
+		//Locks vertices that share their position with a vertex that has different attributes, and
+		//the ends of edges with more than two triangles.
+		void FindLockedVertices(const std::vector<GLuint> &triangles, const std::vector<glm::vec3> &positions,
+			const std::vector<GLuint> &remap, std::vector<bool> &isLocked)
+		{
+			isLocked.assign(positions.size(), false);
+
+			std::vector<GLuint> order;
+			for(GLuint iVertex = 0; iVertex < remap.size(); iVertex++)
+			{
+				if(remap[iVertex] == iVertex)
+					order.push_back(iVertex);
+			}
+
+			PositionIndexLess less(positions);
+			std::sort(order.begin(), order.end(), less);
+			for(size_t iLoop = 1; iLoop < order.size(); iLoop++)
+			{
+				if(!less(order[iLoop - 1], order[iLoop]))
+				{
+					isLocked[order[iLoop - 1]] = true;
+					isLocked[order[iLoop]] = true;
+				}
+			}
+
+			std::vector<std::pair<GLuint, GLuint> > edges;
+			for(size_t iLoop = 0; iLoop < triangles.size(); iLoop += 3)
+			{
+				for(int iCorner = 0; iCorner < 3; iCorner++)
+				{
+					GLuint iStart = triangles[iLoop + iCorner];
+					GLuint iEnd = triangles[iLoop + (iCorner + 1) % 3];
+					edges.push_back(std::make_pair(std::min(iStart, iEnd), std::max(iStart, iEnd)));
+				}
+			}
+
+			std::sort(edges.begin(), edges.end());
+			for(size_t iLoop = 2; iLoop < edges.size(); iLoop++)
+			{
+				if(edges[iLoop] == edges[iLoop - 2])
+				{
+					isLocked[edges[iLoop].first] = true;
+					isLocked[edges[iLoop].second] = true;
+				}
+			}
+		}
+	}
+
+	void BuildMeshLods(MeshGeometry &geom, const std::vector<float> &triangleRatios)
+	{
+		const MeshAttribute *pPositions = geom.FindAttrib(0);
+		if(!pPositions || triangleRatios.empty())
+			return;
+
+		std::vector<GLuint> remap;
+		FindUniqueVertices(geom, remap);
+
+		//Identical vertices are treated as one, so that they are not mistaken for seams.
+		std::vector<GLuint> triangles;
+		for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+		{
+			if(!IsTriangleCmd(geom.cmds[iCmd]))
+				continue;
+
+			std::vector<GLuint> cmdTriangles;
+			AppendCmdTriangles(geom, geom.cmds[iCmd], cmdTriangles);
+			for(size_t iLoop = 0; iLoop < cmdTriangles.size(); iLoop += 3)
+			{
+				GLuint tri[3] = {remap[cmdTriangles[iLoop]], remap[cmdTriangles[iLoop + 1]],
+					remap[cmdTriangles[iLoop + 2]]};
+				if(tri[0] != tri[1] && tri[1] != tri[2] && tri[2] != tri[0])
+					triangles.insert(triangles.end(), tri, tri + 3);
+			}
+		}
+
+		if(triangles.empty())
+			return;
+
+		std::vector<glm::vec3> positions(geom.NumVertices(), glm::vec3(0.0f));
+		for(size_t iVertex = 0; iVertex < positions.size(); iVertex++)
+		{
+			for(int iComp = 0; iComp < pPositions->iSize && iComp < 3; iComp++)
+				positions[iVertex][iComp] = pPositions->GetComponent(iVertex, iComp);
+		}
+
+		std::vector<bool> isLocked;
+		FindLockedVertices(triangles, positions, remap, isLocked);
+
+		size_t numTriangles = triangles.size() / 3;
+		Simplifier simplifier(triangles, positions, isLocked);
+		size_t prevTriangles = numTriangles;
+
+		for(size_t iRatio = 0; iRatio < triangleRatios.size(); iRatio++)
+		{
+			simplifier.Simplify((size_t)(numTriangles * triangleRatios[iRatio]));
+			if(simplifier.GetNumTriangles() >= prevTriangles)
+				continue;
+
+			MeshLod lod;
+			lod.firstIndex = (GLuint)geom.indices.size();
+			simplifier.AppendTriangles(geom.indices);
+			lod.numIndices = (GLuint)geom.indices.size() - lod.firstIndex;
+			lod.geometricError = simplifier.GetError();
+			geom.lods.push_back(lod);
+
+			prevTriangles = simplifier.GetNumTriangles();
+		}
+	}
+
+	float CalcLodErrorScale(float distance, float fovYDeg, float viewportHeight)
+	{
+		return viewportHeight / (2.0f * tanf(DegToRad(fovYDeg) * 0.5f) * distance);
+	}
+}
@@ -0,0 +1,38 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_SIMPLIFY_H
+#define FRAMEWORK_MESH_SIMPLIFY_H
+
+#include <vector>
+
+namespace Framework
+{
+	struct MeshGeometry;
+
+	//A simplified version of a mesh's triangles: a GL_TRIANGLES range of MeshGeometry::indices that
+	//uses the mesh's own vertices.
+	struct MeshLod
+	{
+		GLuint firstIndex;
+		GLuint numIndices;
+		float geometricError;		//Estimated root mean square distance from the full mesh, in model space.
+	};
+
+	//Simplifies the mesh's triangles by edge collapse, ordered by quadric error, and appends a level
+	//for each of the ratios of the original triangle count. The ratios must be decreasing.
+	//
+	//Each collapse moves a vertex onto one of its neighbors, so no vertex data is made up. Vertices
+	//where the attributes differ across one position (seams) and non-manifold vertices never move;
+	//vertices on a border only move along it. A level that cannot get any smaller than the
+	//previous one is left out. Other commands are not affected.
+	void BuildMeshLods(MeshGeometry &geom, const std::vector<float> &triangleRatios);
+
+	//The factor from model-space error to pixels, for an object at the given distance from the
+	//camera, seen with a perspective projection of the given vertical field of view.
+	float CalcLodErrorScale(float distance, float fovYDeg, float viewportHeight);
+}
+
+
+#endif //FRAMEWORK_MESH_SIMPLIFY_H
@@ -0,0 +1,168 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include "MeshGeometry.h"
+#include "MeshIndices.h"
+#include "MeshStats.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		glm::vec3 GetPosition(const MeshAttribute &positions, GLuint iVertex)
+		{
+			glm::vec3 position(0.0f);
+			for(int iComp = 0; iComp < positions.iSize && iComp < 3; iComp++)
+				position[iComp] = positions.GetComponent(iVertex, iComp);
+			return position;
+		}
+
+		//Rotates the triangle so that its smallest index is first. Two triangles with the same
+		//winding then compare equal.
+		void CanonicalTriangle(const GLuint *pIndices, GLuint *pOut)
+		{
+			int iFirst = 0;
+			if(pIndices[1] < pIndices[iFirst])
+				iFirst = 1;
+			if(pIndices[2] < pIndices[iFirst])
+				iFirst = 2;
+
+			for(int iCorner = 0; iCorner < 3; iCorner++)
+				pOut[iCorner] = pIndices[(iFirst + iCorner) % 3];
+		}
+
+		struct TriangleKey
+		{
+			GLuint indices[3];
+
+			bool operator<(const TriangleKey &other) const
+			{
+				return std::lexicographical_compare(indices, indices + 3, other.indices, other.indices + 3);
+			}
+
+			bool operator==(const TriangleKey &other) const
+			{
+				return std::equal(indices, indices + 3, other.indices);
+			}
+		};
+
+		class VertexCache
+		{
+		public:
+			explicit VertexCache(size_t size) : m_size(size) {}
+
+			void Clear() {m_entries.clear();}
+
+			//Returns true on a miss.
+			bool Access(GLuint iVertex)
+			{
+				if(std::find(m_entries.begin(), m_entries.end(), iVertex) != m_entries.end())
+					return false;
+
+				m_entries.push_back(iVertex);
+				if(m_entries.size() > m_size)
+					m_entries.pop_front();
+				return true;
+			}
+
+		private:
+			size_t m_size;
+			std::deque<GLuint> m_entries;
+		};
+	}
+
+	void CalcMeshStats(const MeshGeometry &geom, size_t cacheSize, MeshStats &stats)
+	{
+		stats.iNumVertices = geom.NumVertices();
+		stats.iNumDrawCmds = geom.cmds.size();
+
+		stats.attribBytes.clear();
+		stats.iVertexBytes = 0;
+		for(size_t iAttrib = 0; iAttrib < geom.attribs.size(); iAttrib++)
+		{
+			stats.attribBytes.push_back(geom.attribs[iAttrib].data.size());
+			stats.iVertexBytes += geom.attribs[iAttrib].VertexBytes();
+		}
+
+		std::vector<bool> isReferenced(stats.iNumVertices, false);
+		std::vector<TriangleKey> triangleKeys;
+		VertexCache cache(std::max(cacheSize, (size_t)1));
+
+		stats.iNumIndices = 0;
+		stats.iCacheMisses = 0;
+		stats.iDegenerateTriangles = 0;
+		size_t numElements = 0;
+
+		const MeshAttribute *pPositions = geom.FindAttrib(0);
+		for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+		{
+			const MeshRenderCmd &cmd = geom.cmds[iCmd];
+			if(cmd.bIsIndexedCmd)
+				stats.iNumIndices += cmd.elemCount;
+
+			cache.Clear();
+			for(GLuint iElem = 0; iElem < cmd.elemCount; iElem++)
+			{
+				GLuint iVertex = cmd.bIsIndexedCmd ? geom.indices[cmd.start + iElem] : cmd.start + iElem;
+				if(cmd.bIsIndexedCmd && cmd.bPrimRestart && iVertex == cmd.primRestart)
+					continue;
+
+				isReferenced[iVertex] = true;
+				numElements++;
+
+				//Without indices, nothing can be reused.
+				if(!cmd.bIsIndexedCmd || cache.Access(iVertex))
+					stats.iCacheMisses++;
+			}
+
+			if(!IsTriangleCmd(cmd))
+				continue;
+
+			std::vector<GLuint> triangles;
+			AppendCmdTriangles(geom, cmd, triangles, true);
+			for(size_t iLoop = 0; iLoop < triangles.size(); iLoop += 3)
+			{
+				const GLuint *pTri = &triangles[iLoop];
+				bool bIsDegenerate = pTri[0] == pTri[1] || pTri[1] == pTri[2] || pTri[2] == pTri[0];
+				if(!bIsDegenerate && pPositions)
+				{
+					glm::vec3 pos0 = GetPosition(*pPositions, pTri[0]);
+					glm::vec3 normal = glm::cross(GetPosition(*pPositions, pTri[1]) - pos0,
+						GetPosition(*pPositions, pTri[2]) - pos0);
+					bIsDegenerate = glm::dot(normal, normal) == 0.0f;
+				}
+
+				if(bIsDegenerate)
+				{
+					stats.iDegenerateTriangles++;
+					continue;
+				}
+
+				TriangleKey key;
+				CanonicalTriangle(pTri, key.indices);
+				triangleKeys.push_back(key);
+			}
+		}
+
+		stats.iNumTriangles = triangleKeys.size() + stats.iDegenerateTriangles;
+
+		std::sort(triangleKeys.begin(), triangleKeys.end());
+		stats.iDuplicateTriangles = triangleKeys.size() -
+			(std::unique(triangleKeys.begin(), triangleKeys.end()) - triangleKeys.begin());
+
+		stats.iUnreferencedVertices = std::count(isReferenced.begin(), isReferenced.end(), false);
+
+		stats.iIndexBytes = geom.indices.size() * IndexTypeBytes(geom.eIndexType);
+		stats.fCacheMissRatio = numElements ? stats.iCacheMisses / (float)numElements : 0.0f;
+		stats.fAcmr = stats.iNumTriangles ? stats.iCacheMisses / (float)stats.iNumTriangles : 0.0f;
+		stats.iFetchBytesPerDraw = stats.iNumIndices * IndexTypeBytes(geom.eIndexType) +
+			stats.iCacheMisses * stats.iVertexBytes;
+	}
+}
@@ -0,0 +1,44 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_STATS_H
+#define FRAMEWORK_MESH_STATS_H
+
+#include <vector>
+
+namespace Framework
+{
+	struct MeshGeometry;
+
+	//Measurements of a mesh as it would be drawn by Mesh::Render. Only the rendering commands count;
+	//LOD ranges are not included.
+	struct MeshStats
+	{
+		size_t iNumVertices;
+		size_t iNumIndices;
+		size_t iNumTriangles;
+		size_t iNumDrawCmds;
+
+		std::vector<size_t> attribBytes;	//Size of each attribute array, in MeshGeometry order.
+		size_t iVertexBytes;				//Bytes per vertex, over all attributes.
+		size_t iIndexBytes;
+
+		size_t iUnreferencedVertices;		//Vertices no command uses.
+		size_t iDegenerateTriangles;		//Triangles that repeat an index or have no area.
+		size_t iDuplicateTriangles;			//Copies of an earlier triangle, with the same winding.
+
+		//From a FIFO simulation of the post-transform vertex cache, emptied at the start of each command.
+		size_t iCacheMisses;
+		float fCacheMissRatio;				//Misses per index.
+		float fAcmr;						//Average cache misses per triangle.
+
+		//Index data plus the vertex data for every cache miss.
+		size_t iFetchBytesPerDraw;
+	};
+
+	void CalcMeshStats(const MeshGeometry &geom, size_t cacheSize, MeshStats &stats);
+}
+
+
+#endif //FRAMEWORK_MESH_STATS_H
@@ -0,0 +1,175 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <glload/gl_3_3.h>
+#include "MeshGeometry.h"
+#include "MeshWeld.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		//Fills in the bytes that identify each vertex: the data of every attribute, in order, except
+		//that positions are replaced by their grid cell when there is an epsilon. Returns the number
+		//of bytes per vertex.
+		size_t BuildVertexKeys(const MeshGeometry &geom, float positionEpsilon, std::vector<GLubyte> &keys)
+		{
+			size_t numVertices = geom.NumVertices();
+			size_t keyBytes = 0;
+			for(size_t iAttrib = 0; iAttrib < geom.attribs.size(); iAttrib++)
+			{
+				const MeshAttribute &attrib = geom.attribs[iAttrib];
+				if(positionEpsilon > 0.0f && attrib.iAttribIx == 0)
+					keyBytes += attrib.iSize * sizeof(GLint);
+				else
+					keyBytes += attrib.VertexBytes();
+			}
+
+			keys.resize(numVertices * keyBytes);
+
+			size_t offset = 0;
+			for(size_t iAttrib = 0; iAttrib < geom.attribs.size(); iAttrib++)
+			{
+				const MeshAttribute &attrib = geom.attribs[iAttrib];
+				if(positionEpsilon > 0.0f && attrib.iAttribIx == 0)
+				{
+					for(size_t iVertex = 0; iVertex < numVertices; iVertex++)
+					{
+						for(int iComp = 0; iComp < attrib.iSize; iComp++)
+						{
+							double cell = floor(attrib.GetComponent(iVertex, iComp) / (double)positionEpsilon + 0.5);
+							GLint iCell = (GLint)std::max(std::min(cell, 2147483647.0), -2147483648.0);
+							memcpy(&keys[iVertex * keyBytes + offset + iComp * sizeof(GLint)], &iCell, sizeof(GLint));
+						}
+					}
+
+					offset += attrib.iSize * sizeof(GLint);
+				}
+				else
+				{
+					size_t vertexBytes = attrib.VertexBytes();
+					for(size_t iVertex = 0; iVertex < numVertices; iVertex++)
+						memcpy(&keys[iVertex * keyBytes + offset], &attrib.data[iVertex * vertexBytes], vertexBytes);
+
+					offset += vertexBytes;
+				}
+			}
+
+			return keyBytes;
+		}
+
+		//FNV-1a.
+		size_t HashBytes(const GLubyte *pBytes, size_t numBytes)
+		{
+			GLuint hash = 2166136261u;
+			for(size_t iByte = 0; iByte < numBytes; iByte++)
+			{
+				hash ^= pBytes[iByte];
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+
+		void MakeCmdsIndexed(MeshGeometry &geom)
+		{
+			for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+			{
+				MeshRenderCmd &cmd = geom.cmds[iCmd];
+				if(cmd.bIsIndexedCmd)
+					continue;
+
+				GLuint iFirstVertex = cmd.start;
+				cmd.start = (GLuint)geom.indices.size();
+				for(GLuint iElem = 0; iElem < cmd.elemCount; iElem++)
+					geom.indices.push_back(iFirstVertex + iElem);
+
+				cmd.bIsIndexedCmd = true;
+				cmd.bPrimRestart = false;
+			}
+		}
+	}
+
+	size_t WeldMeshVertices(MeshGeometry &geom, float positionEpsilon)
+	{
+		size_t numVertices = geom.NumVertices();
+		if(numVertices == 0)
+			return 0;
+
+		std::vector<GLubyte> keys;
+		size_t keyBytes = BuildVertexKeys(geom, positionEpsilon, keys);
+
+		//Open addressing with linear probing, in a power of two table at most half full. Each slot
+		//holds the new number of a kept vertex.
+		size_t tableSize = 1;
+		while(tableSize < numVertices * 2)
+			tableSize *= 2;
+
+		const GLuint emptySlot = 0xFFFFFFFF;
+		std::vector<GLuint> table(tableSize, emptySlot);
+		std::vector<GLuint> keptVertices;
+		std::vector<GLuint> remap(numVertices);
+
+		for(size_t iVertex = 0; iVertex < numVertices; iVertex++)
+		{
+			const GLubyte *pKey = &keys[iVertex * keyBytes];
+			size_t iSlot = HashBytes(pKey, keyBytes) & (tableSize - 1);
+			while(table[iSlot] != emptySlot &&
+				memcmp(&keys[keptVertices[table[iSlot]] * keyBytes], pKey, keyBytes) != 0)
+			{
+				iSlot = (iSlot + 1) & (tableSize - 1);
+			}
+
+			if(table[iSlot] == emptySlot)
+			{
+				table[iSlot] = (GLuint)keptVertices.size();
+				keptVertices.push_back((GLuint)iVertex);
+			}
+
+			remap[iVertex] = table[iSlot];
+		}
+
+		if(keptVertices.size() == numVertices)
+			return 0;
+
+		MakeCmdsIndexed(geom);
+
+		//Primitive restart indices are not vertices, so they are left alone.
+		std::vector<bool> isRemapped(geom.indices.size(), false);
+		for(size_t iCmd = 0; iCmd < geom.cmds.size(); iCmd++)
+		{
+			const MeshRenderCmd &cmd = geom.cmds[iCmd];
+			for(GLuint iIndex = cmd.start; iIndex < cmd.start + cmd.elemCount; iIndex++)
+			{
+				if(isRemapped[iIndex] || (cmd.bPrimRestart && geom.indices[iIndex] == cmd.primRestart))
+					continue;
+
+				geom.indices[iIndex] = remap[geom.indices[iIndex]];
+				isRemapped[iIndex] = true;
+			}
+		}
+
+		for(size_t iAttrib = 0; iAttrib < geom.attribs.size(); iAttrib++)
+		{
+			MeshAttribute &attrib = geom.attribs[iAttrib];
+			size_t vertexBytes = attrib.VertexBytes();
+
+			std::vector<GLubyte> data(keptVertices.size() * vertexBytes);
+			for(size_t iVertex = 0; iVertex < keptVertices.size(); iVertex++)
+			{
+				memcpy(&data[iVertex * vertexBytes], &attrib.data[keptVertices[iVertex] * vertexBytes],
+					vertexBytes);
+			}
+
+			attrib.data.swap(data);
+		}
+
+		return numVertices - keptVertices.size();
+	}
+}
@@ -0,0 +1,27 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_MESH_WELD_H
+#define FRAMEWORK_MESH_WELD_H
+
+
+namespace Framework
+{
+	struct MeshGeometry;
+
+	//Merges vertices whose data is identical in every attribute array, and remaps the indices to the
+	//vertices that remain. Every named VAO draws from the same arrays, so they all stay valid.
+	//Non-indexed commands are turned into indexed ones, since their vertices may no longer be
+	//contiguous.
+	//
+	//With a positionEpsilon greater than zero, positions (attribute 0) only need to round to the
+	//same multiple of positionEpsilon; the other attributes must still match exactly. The vertex
+	//that is kept is the first one in the original order.
+	//
+	//Returns the number of vertices removed. This should be done before any other processing.
+	size_t WeldMeshVertices(MeshGeometry &geom, float positionEpsilon = 0.0f);
+}
+
+
+#endif //FRAMEWORK_MESH_WELD_H
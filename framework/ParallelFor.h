@@ -0,0 +1,78 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_PARALLEL_FOR_H
+#define FRAMEWORK_PARALLEL_FOR_H
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+namespace Framework
+{
+	//Threads that are joined when the group is destroyed. If starting a thread throws, the ones
+	//already started are joined as the exception unwinds, rather than terminating the program.
+	class ThreadGroup
+	{
+	public:
+		ThreadGroup() {}
+		~ThreadGroup() {Join();}
+
+		//Starts a thread that calls func(arg).
+		template<typename Function, typename Arg>
+		void Start(const Function &func, const Arg &arg)
+		{
+			m_workers.reserve(m_workers.size() + 1);
+			m_workers.push_back(std::thread(func, arg));
+		}
+
+		//Starts a thread that calls func(arg1, arg2).
+		template<typename Function, typename Arg1, typename Arg2>
+		void Start(const Function &func, const Arg1 &arg1, const Arg2 &arg2)
+		{
+			m_workers.reserve(m_workers.size() + 1);
+			m_workers.push_back(std::thread(func, arg1, arg2));
+		}
+
+		//Waits for every thread started so far.
+		void Join()
+		{
+			for(size_t iThread = 0; iThread < m_workers.size(); iThread++)
+				m_workers[iThread].join();
+			m_workers.clear();
+		}
+
+	private:
+		std::vector<std::thread> m_workers;
+
+		ThreadGroup(const ThreadGroup &);
+		ThreadGroup &operator=(const ThreadGroup &);
+	};
+
+	//Calls kernel(begin, end) over [0, count), split into one range per thread. The calling thread
+	//does the first range. Every range starts on a multiple of rangeAlignment.
+	//
+	//If numThreads is 0, one thread per hardware core is used. Fewer threads are used if the ranges
+	//would have fewer than minPerThread items, so small counts are done on the calling thread.
+	template<typename Kernel>
+	void ParallelFor(const Kernel &kernel, size_t count, size_t minPerThread, unsigned int numThreads,
+		size_t rangeAlignment = 1)
+	{
+		if(numThreads == 0)
+			numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+		numThreads = (unsigned int)std::min((size_t)numThreads, std::max(count / minPerThread, (size_t)1));
+
+		size_t rangeSize = (count + numThreads - 1) / numThreads;
+		rangeSize = (rangeSize + rangeAlignment - 1) / rangeAlignment * rangeAlignment;
+
+		ThreadGroup workers;
+		for(size_t begin = rangeSize; begin < count; begin += rangeSize)
+			workers.Start(kernel, begin, std::min(begin + rangeSize, count));
+
+		kernel(0, std::min(rangeSize, count));
+	}
+}
+
+
+#endif //FRAMEWORK_PARALLEL_FOR_H
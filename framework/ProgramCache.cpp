@@ -0,0 +1,323 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <new>
+#include <chrono>
+#include <glload/gl_3_3.h>
+#include "framework.h"
+#include "ProgramCache.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		const GLuint g_cacheFileMagic = 0x32504C47;		//"GLP2"
+
+		//The key and driver hash are stored so that a file is never used for the wrong program, even if
+		//two keys collide in the filename or the file was copied from another machine.
+		struct CacheFileHeader
+		{
+			unsigned long long key;
+			unsigned long long driverHash;
+			GLuint magic;
+			GLuint binaryFormat;
+			GLuint binaryLength;
+			GLuint padding;
+		};
+
+		const unsigned long long g_hashStart = 14695981039346656037ULL;
+
+		//FNV-1a, 64-bit.
+		void HashBytes(const void *pBytes, size_t numBytes, unsigned long long &hash)
+		{
+			const unsigned char *pData = static_cast<const unsigned char *>(pBytes);
+			for(size_t iByte = 0; iByte < numBytes; iByte++)
+			{
+				hash ^= pData[iByte];
+				hash *= 1099511628211ULL;
+			}
+		}
+
+		void HashString(const std::string &strText, unsigned long long &hash)
+		{
+			//The terminator keeps "ab" + "c" from hashing the same as "a" + "bc".
+			HashBytes(strText.c_str(), strText.size() + 1, hash);
+		}
+
+		std::string GetGLString(GLenum eName)
+		{
+			const GLubyte *pString = glGetString(eName);
+			return pString ? std::string(reinterpret_cast<const char *>(pString)) : std::string();
+		}
+
+		std::string ReadShaderFile(const std::string &strFilename)
+		{
+			std::string strPath = FindFileOrThrow(strFilename);
+			std::ifstream shaderFile(strPath.c_str());
+			std::stringstream shaderData;
+			shaderData << shaderFile.rdbuf();
+			return shaderData.str();
+		}
+
+		double SecondsSince(const std::chrono::steady_clock::time_point &start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+	}
+
+	ProgramCache::ProgramCache(const std::string &strCachePrefix)
+		: m_strCachePrefix(strCachePrefix)
+		, m_driverHash(0)
+		, m_bHasDriverInfo(false)
+		, m_bCanCache(false)
+	{}
+
+	void ProgramCache::GetDriverInfo()
+	{
+		if(m_bHasDriverInfo)
+			return;
+
+		m_strDriverId = GetGLString(GL_VENDOR) + "\n" + GetGLString(GL_RENDERER) + "\n" +
+			GetGLString(GL_VERSION);
+		m_driverHash = g_hashStart;
+		HashString(m_strDriverId, m_driverHash);
+
+		//Some implementations expose the extension but have no binary formats to give back.
+		if(glext_ARB_get_program_binary)
+		{
+			GLint numFormats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+			m_bCanCache = numFormats > 0;
+		}
+
+		m_bHasDriverInfo = true;
+	}
+
+	unsigned long long ProgramCache::GetCacheKey(const std::vector<ShaderSource> &shaders) const
+	{
+		unsigned long long hash = g_hashStart;
+		HashString(m_strDriverId, hash);
+		for(size_t iShader = 0; iShader < shaders.size(); iShader++)
+		{
+			HashBytes(&shaders[iShader].eShaderType, sizeof(GLenum), hash);
+			HashString(shaders[iShader].strText, hash);
+		}
+
+		return hash;
+	}
+
+	std::string ProgramCache::GetCacheFilename(unsigned long long key) const
+	{
+		char strKey[17];
+		sprintf(strKey, "%016llx", key);
+		return m_strCachePrefix + strKey + ".bin";
+	}
+
+	GLuint ProgramCache::LoadBinary(unsigned long long key) const
+	{
+		std::ifstream cacheFile(GetCacheFilename(key).c_str(), std::ios::binary);
+		if(!cacheFile)
+			return 0;
+
+		CacheFileHeader header;
+		if(!cacheFile.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+			header.magic != g_cacheFileMagic || header.key != key || header.driverHash != m_driverHash ||
+			header.binaryLength == 0)
+		{
+			return 0;
+		}
+
+		//Check the length against the file before trusting it with an allocation.
+		std::streamoff binaryStart = cacheFile.tellg();
+		if(!cacheFile.seekg(0, std::ios::end))
+			return 0;
+		std::streamoff fileSize = cacheFile.tellg();
+		if(binaryStart < 0 || fileSize - binaryStart != (std::streamoff)header.binaryLength ||
+			!cacheFile.seekg(binaryStart))
+		{
+			return 0;
+		}
+
+		std::vector<char> binary(header.binaryLength);
+		if(!cacheFile.read(&binary[0], binary.size()))
+			return 0;
+
+		//The driver may still refuse the binary; then it is as if there was no file.
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, header.binaryFormat, &binary[0], (GLsizei)binary.size());
+
+		GLint status;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if(status == GL_FALSE)
+		{
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		return program;
+	}
+
+	void ProgramCache::StoreBinary(unsigned long long key, GLuint program) const
+	{
+		GLint binaryLength = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+		if(binaryLength <= 0)
+			return;
+
+		std::vector<char> binary(binaryLength);
+		CacheFileHeader header;
+		header.key = key;
+		header.driverHash = m_driverHash;
+		header.magic = g_cacheFileMagic;
+		header.binaryLength = 0;
+		header.padding = 0;
+		glGetProgramBinary(program, binaryLength, (GLsizei *)&header.binaryLength, &header.binaryFormat,
+			&binary[0]);
+		if(header.binaryLength == 0)
+			return;
+
+		//Written to a temporary file and renamed, so that a failed or interrupted write never leaves a
+		//partial file under the real name.
+		std::string strFilename = GetCacheFilename(key);
+		std::string strTempFilename = strFilename + ".tmp";
+		{
+			std::ofstream cacheFile(strTempFilename.c_str(), std::ios::binary | std::ios::trunc);
+			cacheFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			cacheFile.write(&binary[0], header.binaryLength);
+			cacheFile.close();
+			if(!cacheFile.good())
+			{
+				remove(strTempFilename.c_str());
+				return;
+			}
+		}
+
+		//rename does not replace an existing file everywhere.
+		remove(strFilename.c_str());
+		if(rename(strTempFilename.c_str(), strFilename.c_str()) != 0)
+			remove(strTempFilename.c_str());
+	}
+
+	GLuint ProgramCache::FindProgram(const std::vector<ShaderSource> &shaders)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		GetDriverInfo();
+
+		GLuint program = 0;
+		try
+		{
+			if(m_bCanCache)
+				program = LoadBinary(GetCacheKey(shaders));
+		}
+		catch(std::bad_alloc &)
+		{
+			//Not worth failing over; the program is compiled instead.
+		}
+
+		if(program)
+		{
+			m_stats.iNumHits++;
+			m_stats.hitSeconds += SecondsSince(start);
+		}
+
+		return program;
+	}
+
+	void ProgramCache::AddProgram(const std::vector<ShaderSource> &shaders, GLuint program, double compileSeconds)
+	{
+		if(m_bCanCache)
+			StoreBinary(GetCacheKey(shaders), program);
+
+		m_stats.iNumMisses++;
+		m_stats.missSeconds += compileSeconds;
+	}
+
+	GLuint ProgramCache::CreateProgram(const std::vector<ShaderSource> &shaders)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		GLuint program = FindProgram(shaders);
+		if(program)
+			return program;
+
+		std::vector<GLuint> shaderList;
+		try
+		{
+			for(size_t iShader = 0; iShader < shaders.size(); iShader++)
+			{
+				shaderList.push_back(Framework::CreateShader(shaders[iShader].eShaderType,
+					shaders[iShader].strText, shaders[iShader].strName));
+			}
+
+			program = LinkProgram(shaderList);
+		}
+		catch(...)
+		{
+			for(size_t iLoop = 0; iLoop < shaderList.size(); iLoop++)
+				glDeleteShader(shaderList[iLoop]);
+			throw;
+		}
+
+		for(size_t iLoop = 0; iLoop < shaderList.size(); iLoop++)
+			glDeleteShader(shaderList[iLoop]);
+
+		AddProgram(shaders, program, SecondsSince(start));
+		return program;
+	}
+
+	GLuint ProgramCache::LoadProgram(const std::string &strVertexShader, const std::string &strFragmentShader)
+	{
+		std::vector<ShaderSource> shaders;
+		shaders.push_back(ShaderSource(GL_VERTEX_SHADER, strVertexShader, ReadShaderFile(strVertexShader)));
+		shaders.push_back(ShaderSource(GL_FRAGMENT_SHADER, strFragmentShader, ReadShaderFile(strFragmentShader)));
+		return CreateProgram(shaders);
+	}
+
+	GLuint LinkProgram(const std::vector<GLuint> &shaderList)
+	{
+		GLuint program = StartLink(shaderList);
+		FinishLink(program, shaderList);
+		return program;
+	}
+
+	GLuint StartLink(const std::vector<GLuint> &shaderList)
+	{
+		GLuint program = glCreateProgram();
+		//The hint has to be given before linking.
+		if(glext_ARB_get_program_binary)
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+		for(size_t iLoop = 0; iLoop < shaderList.size(); iLoop++)
+			glAttachShader(program, shaderList[iLoop]);
+
+		glLinkProgram(program);
+		return program;
+	}
+
+	void FinishLink(GLuint program, const std::vector<GLuint> &shaderList)
+	{
+		GLint status;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+		for(size_t iLoop = 0; iLoop < shaderList.size(); iLoop++)
+			glDetachShader(program, shaderList[iLoop]);
+
+		if(status == GL_FALSE)
+		{
+			GLint infoLogLength;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+			std::vector<GLchar> infoLog(infoLogLength + 1, 0);
+			glGetProgramInfoLog(program, infoLogLength, NULL, &infoLog[0]);
+			glDeleteProgram(program);
+			throw std::runtime_error(std::string("Linker failure: ") + &infoLog[0]);
+		}
+	}
+}
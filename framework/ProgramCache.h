@@ -0,0 +1,86 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_PROGRAM_CACHE_H
+#define FRAMEWORK_PROGRAM_CACHE_H
+
+#include <vector>
+#include <string>
+
+namespace Framework
+{
+	struct ShaderSource
+	{
+		ShaderSource(GLenum eShaderType, const std::string &strName, const std::string &strText)
+			: eShaderType(eShaderType), strName(strName), strText(strText)
+		{}
+
+		GLenum eShaderType;
+		std::string strName;	//Only used in error messages.
+		std::string strText;	//The complete text given to the compiler.
+	};
+
+	struct ProgramCacheStats
+	{
+		ProgramCacheStats() : iNumHits(0), iNumMisses(0), hitSeconds(0.0), missSeconds(0.0) {}
+
+		int iNumHits;			//Programs restored from a cached binary.
+		int iNumMisses;			//Programs compiled and linked from source.
+		double hitSeconds;
+		double missSeconds;
+	};
+
+	//Keeps linked program binaries on disk, so that a program is only compiled from source the first
+	//time it is used with a particular driver. The cache key is a hash of the shader text and the
+	//GL_VENDOR, GL_RENDERER and GL_VERSION strings, so a driver update or an edited shader simply
+	//misses. Without ARB_get_program_binary, every program is compiled.
+	class ProgramCache
+	{
+	public:
+		//Cache files are named strCachePrefix, then the key in hexadecimal, then ".bin". If the prefix
+		//names a directory, it must already exist. No OpenGL calls are made here.
+		explicit ProgramCache(const std::string &strCachePrefix);
+
+		//Returns a linked program. Throws std::runtime_error if compiling or linking fails. Failing to
+		//read or write a cache file is not an error.
+		GLuint CreateProgram(const std::vector<ShaderSource> &shaders);
+
+		//Reads the shaders with FindFileOrThrow and calls CreateProgram.
+		GLuint LoadProgram(const std::string &strVertexShader, const std::string &strFragmentShader);
+
+		//For callers that make their own shader objects, such as ShaderLibrary. FindProgram returns 0
+		//on a miss; then link the program with LinkProgram and give it to AddProgram, along with the
+		//time spent compiling it.
+		GLuint FindProgram(const std::vector<ShaderSource> &shaders);
+		void AddProgram(const std::vector<ShaderSource> &shaders, GLuint program, double compileSeconds);
+
+		const ProgramCacheStats &GetStats() const {return m_stats;}
+
+	private:
+		std::string m_strCachePrefix;
+		std::string m_strDriverId;
+		unsigned long long m_driverHash;
+		bool m_bHasDriverInfo;
+		bool m_bCanCache;
+		ProgramCacheStats m_stats;
+
+		void GetDriverInfo();
+		unsigned long long GetCacheKey(const std::vector<ShaderSource> &shaders) const;
+		std::string GetCacheFilename(unsigned long long key) const;
+		GLuint LoadBinary(unsigned long long key) const;
+		void StoreBinary(unsigned long long key, GLuint program) const;
+	};
+
+	//Links the shaders and detaches them, but does not delete them. The program's binary can be
+	//retrieved if ARB_get_program_binary is available. Throws std::runtime_error if linking fails.
+	GLuint LinkProgram(const std::vector<GLuint> &shaderList);
+
+	//The two halves of LinkProgram, so that the driver can link while the caller does other work.
+	//FinishLink waits for the link, and deletes the program before throwing if it failed.
+	GLuint StartLink(const std::vector<GLuint> &shaderList);
+	void FinishLink(GLuint program, const std::vector<GLuint> &shaderList);
+}
+
+
+#endif //FRAMEWORK_PROGRAM_CACHE_H
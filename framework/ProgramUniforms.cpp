@@ -0,0 +1,218 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "ProgramUniforms.h"
+
+
+namespace Framework
+{
+	namespace
+	{
+		//Bytes in one element of a uniform of the given type.
+		size_t UniformTypeBytes(GLenum eType)
+		{
+			switch(eType)
+			{
+			case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL: return 4;
+			case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: return 8;
+			case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: return 12;
+			case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: return 16;
+			case GL_FLOAT_MAT2: return 16;
+			case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2: return 24;
+			case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2: return 32;
+			case GL_FLOAT_MAT3: return 36;
+			case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3: return 48;
+			case GL_FLOAT_MAT4: return 64;
+			}
+
+			//Samplers, which are set as a single int.
+			return 4;
+		}
+
+		//glUniform1i sets ints, bools and samplers: every single-value type but float and uint.
+		bool IsIntType(GLenum eType)
+		{
+			return UniformTypeBytes(eType) == 4 && eType != GL_FLOAT && eType != GL_UNSIGNED_INT;
+		}
+
+		const char *GetSetterTypeName(GLenum eType)
+		{
+			switch(eType)
+			{
+			case GL_FLOAT: return "float";
+			case GL_FLOAT_VEC4: return "vec4";
+			case GL_FLOAT_MAT4: return "mat4";
+			}
+
+			return "int";
+		}
+	}
+
+	ProgramUniforms::ProgramUniforms(GLuint program, UniformUploadStats *pStats)
+		: m_program(program)
+		, m_pStats(pStats)
+	{
+		GLint numUniforms = 0;
+		GLint maxNameLength = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::vector<GLchar> nameBuffer(maxNameLength + 1, 0);
+		for(GLint iUniform = 0; iUniform < numUniforms; iUniform++)
+		{
+			Uniform uniform;
+			GLsizei nameLength = 0;
+			glGetActiveUniform(program, iUniform, (GLsizei)nameBuffer.size(), &nameLength, &uniform.arraySize,
+				&uniform.eType, &nameBuffer[0]);
+			uniform.strName.assign(&nameBuffer[0], nameLength);
+
+			//Members of uniform blocks have no location; they are set through buffer objects.
+			uniform.location = glGetUniformLocation(program, uniform.strName.c_str());
+			if(uniform.location == -1)
+				continue;
+
+			if(uniform.strName.size() > 3 && uniform.strName.compare(uniform.strName.size() - 3, 3, "[0]") == 0)
+				uniform.strName.erase(uniform.strName.size() - 3);
+
+			uniform.shadowOffset = m_shadow.size();
+			uniform.bHasValue = false;
+			m_shadow.resize(m_shadow.size() + UniformTypeBytes(uniform.eType));
+			m_uniforms.push_back(uniform);
+		}
+
+		GLint numBlocks = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &numBlocks);
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+
+		nameBuffer.assign(maxNameLength + 1, 0);
+		for(GLint iBlock = 0; iBlock < numBlocks; iBlock++)
+		{
+			Block block;
+			GLsizei nameLength = 0;
+			glGetActiveUniformBlockName(program, iBlock, (GLsizei)nameBuffer.size(), &nameLength, &nameBuffer[0]);
+			block.strName.assign(&nameBuffer[0], nameLength);
+			block.blockIndex = iBlock;
+
+			GLint binding = 0;
+			glGetActiveUniformBlockiv(program, iBlock, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+			glGetActiveUniformBlockiv(program, iBlock, GL_UNIFORM_BLOCK_BINDING, &binding);
+			block.bindingIndex = binding;
+
+			m_blocks.push_back(block);
+		}
+	}
+
+	int ProgramUniforms::FindUniform(const std::string &strName) const
+	{
+		std::string strBaseName = strName;
+		if(strBaseName.size() > 3 && strBaseName.compare(strBaseName.size() - 3, 3, "[0]") == 0)
+			strBaseName.erase(strBaseName.size() - 3);
+
+		for(size_t iUniform = 0; iUniform < m_uniforms.size(); iUniform++)
+		{
+			if(m_uniforms[iUniform].strName == strBaseName)
+				return (int)iUniform;
+		}
+
+		return -1;
+	}
+
+	int ProgramUniforms::FindBlock(const std::string &strName) const
+	{
+		for(size_t iBlock = 0; iBlock < m_blocks.size(); iBlock++)
+		{
+			if(m_blocks[iBlock].strName == strName)
+				return (int)iBlock;
+		}
+
+		return -1;
+	}
+
+	void ProgramUniforms::CountSkipped()
+	{
+		if(m_pStats)
+			m_pStats->iNumSkipped++;
+	}
+
+	void ProgramUniforms::CountUpload()
+	{
+		if(m_pStats)
+			m_pStats->iNumUploads++;
+	}
+
+	ProgramUniforms::Uniform *ProgramUniforms::UpdateShadow(int iUniform, GLenum eType, const void *pValue,
+		size_t valueBytes)
+	{
+		if(iUniform < 0)
+			return NULL;
+
+		Uniform &uniform = m_uniforms[iUniform];
+		bool bTypeMatches = eType == GL_INT ? IsIntType(uniform.eType) : uniform.eType == eType;
+		if(!bTypeMatches)
+		{
+			throw std::runtime_error("The uniform " + uniform.strName + " cannot be set as a " +
+				GetSetterTypeName(eType) + ".");
+		}
+
+		GLubyte *pShadow = &m_shadow[uniform.shadowOffset];
+		if(uniform.bHasValue && memcmp(pShadow, pValue, valueBytes) == 0)
+		{
+			CountSkipped();
+			return NULL;
+		}
+
+		memcpy(pShadow, pValue, valueBytes);
+		uniform.bHasValue = true;
+		CountUpload();
+		return &uniform;
+	}
+
+	void ProgramUniforms::SetFloat(int iUniform, float value)
+	{
+		if(Uniform *pUniform = UpdateShadow(iUniform, GL_FLOAT, &value, sizeof(value)))
+			glUniform1f(pUniform->location, value);
+	}
+
+	void ProgramUniforms::SetVec4(int iUniform, const glm::vec4 &value)
+	{
+		if(Uniform *pUniform = UpdateShadow(iUniform, GL_FLOAT_VEC4, glm::value_ptr(value), sizeof(value)))
+			glUniform4fv(pUniform->location, 1, glm::value_ptr(value));
+	}
+
+	void ProgramUniforms::SetMat4(int iUniform, const glm::mat4 &value)
+	{
+		if(Uniform *pUniform = UpdateShadow(iUniform, GL_FLOAT_MAT4, glm::value_ptr(value), sizeof(value)))
+			glUniformMatrix4fv(pUniform->location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	void ProgramUniforms::SetInt(int iUniform, GLint value)
+	{
+		if(Uniform *pUniform = UpdateShadow(iUniform, GL_INT, &value, sizeof(value)))
+			glUniform1i(pUniform->location, value);
+	}
+
+	void ProgramUniforms::SetBlockBinding(int iBlock, GLuint bindingIndex)
+	{
+		if(iBlock < 0)
+			return;
+
+		Block &block = m_blocks[iBlock];
+		if(block.bindingIndex == bindingIndex)
+		{
+			CountSkipped();
+			return;
+		}
+
+		glUniformBlockBinding(m_program, block.blockIndex, bindingIndex);
+		block.bindingIndex = bindingIndex;
+		CountUpload();
+	}
+}
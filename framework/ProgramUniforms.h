@@ -0,0 +1,85 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_PROGRAM_UNIFORMS_H
+#define FRAMEWORK_PROGRAM_UNIFORMS_H
+
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+
+namespace Framework
+{
+	struct UniformUploadStats
+	{
+		UniformUploadStats() : iNumUploads(0), iNumSkipped(0) {}
+
+		int iNumUploads;		//glUniform* and glUniformBlockBinding calls made.
+		int iNumSkipped;		//Calls left out because the program already had the value.
+	};
+
+	//The active uniforms and uniform blocks of a linked program, read from the program after linking.
+	//Each uniform keeps a copy of the value the program has, and the setters only call OpenGL when
+	//the new value is different.
+	//
+	//The shadow values are only right if every change goes through this object, so there should be
+	//one per program, shared by everything that sets its uniforms.
+	class ProgramUniforms
+	{
+	public:
+		//Upload counts are added to pStats, if it is not NULL. It must outlive this object.
+		explicit ProgramUniforms(GLuint program, UniformUploadStats *pStats = NULL);
+
+		GLuint GetProgram() const {return m_program;}
+
+		//Returns the index of the uniform or block, or -1 if the program has no active one of that
+		//name. Array uniforms can be found with or without "[0]".
+		int FindUniform(const std::string &strName) const;
+		int FindBlock(const std::string &strName) const;
+
+		//The program must be in use. The index may be -1, in which case nothing happens. Throws
+		//std::runtime_error if the uniform's type does not match the setter. SetInt also takes
+		//samplers and bools.
+		void SetFloat(int iUniform, float value);
+		void SetVec4(int iUniform, const glm::vec4 &value);
+		void SetMat4(int iUniform, const glm::mat4 &value);
+		void SetInt(int iUniform, GLint value);
+
+		//The program does not need to be in use.
+		void SetBlockBinding(int iBlock, GLuint bindingIndex);
+
+	private:
+		struct Uniform
+		{
+			std::string strName;
+			GLint location;
+			GLenum eType;
+			GLint arraySize;
+			size_t shadowOffset;		//Into m_shadow, where the value of the first element is kept.
+			bool bHasValue;				//False until the first upload; before that, any value is new.
+		};
+
+		struct Block
+		{
+			std::string strName;
+			GLuint blockIndex;
+			GLint dataSize;
+			GLuint bindingIndex;
+		};
+
+		GLuint m_program;
+		UniformUploadStats *m_pStats;
+		std::vector<Uniform> m_uniforms;
+		std::vector<Block> m_blocks;
+		std::vector<GLubyte> m_shadow;
+
+		//Returns NULL if the value is unchanged.
+		Uniform *UpdateShadow(int iUniform, GLenum eType, const void *pValue, size_t valueBytes);
+		void CountSkipped();
+		void CountUpload();
+	};
+}
+
+
+#endif //FRAMEWORK_PROGRAM_UNIFORMS_H
@@ -0,0 +1,371 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <glload/gl_3_3.h>
+#include "framework.h"
+#include "ProgramCache.h"
+#include "ShaderLibrary.h"
+
+//From KHR_parallel_shader_compile and ARB_parallel_shader_compile, which glload does not have.
+#ifndef GL_COMPLETION_STATUS_ARB
+#define GL_COMPLETION_STATUS_ARB 0x91B1
+#endif
+
+
+namespace Framework
+{
+	namespace
+	{
+		std::string ReadFileText(const std::string &strFilename)
+		{
+			std::string strPath = FindFileOrThrow(strFilename);
+			std::ifstream file(strPath.c_str());
+			if(!file)
+				throw std::runtime_error("Could not open the shader file: " + strPath);
+
+			std::stringstream data;
+			data << file.rdbuf();
+			return data.str();
+		}
+
+		//Returns the position just after the directive's name, or std::string::npos if the line is
+		//not that directive.
+		size_t FindDirective(const std::string &strLine, const std::string &strDirective)
+		{
+			size_t pos = strLine.find_first_not_of(" \t");
+			if(pos == std::string::npos || strLine[pos] != '#')
+				return std::string::npos;
+
+			pos = strLine.find_first_not_of(" \t", pos + 1);
+			if(pos == std::string::npos || strLine.compare(pos, strDirective.size(), strDirective) != 0)
+				return std::string::npos;
+
+			return pos + strDirective.size();
+		}
+
+		bool ParseInclude(const std::string &strLine, std::string &strFilename)
+		{
+			size_t pos = FindDirective(strLine, "include");
+			if(pos == std::string::npos)
+				return false;
+
+			size_t openQuote = strLine.find('"', pos);
+			size_t closeQuote = openQuote == std::string::npos ? openQuote : strLine.find('"', openQuote + 1);
+			if(closeQuote == std::string::npos)
+				throw std::runtime_error("Malformed #include: " + strLine);
+
+			strFilename = strLine.substr(openQuote + 1, closeQuote - openQuote - 1);
+			return true;
+		}
+
+		void AppendFile(const std::string &strFilename, std::vector<std::string> &includeStack,
+			std::ostringstream &output)
+		{
+			if(std::find(includeStack.begin(), includeStack.end(), strFilename) != includeStack.end())
+				throw std::runtime_error("Recursive #include of " + strFilename);
+
+			includeStack.push_back(strFilename);
+
+			std::istringstream input(ReadFileText(strFilename));
+			std::string strLine;
+			int iLine = 0;
+			while(std::getline(input, strLine))
+			{
+				iLine++;
+
+				std::string strInclude;
+				if(ParseInclude(strLine, strInclude))
+				{
+					output << "#line 1\n";
+					AppendFile(strInclude, includeStack, output);
+					output << "#line " << iLine + 1 << "\n";
+				}
+				else
+					output << strLine << "\n";
+			}
+
+			includeStack.pop_back();
+		}
+
+		bool HasExtension(const std::string &strExtension)
+		{
+			GLint numExtensions = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+			for(GLint iExt = 0; iExt < numExtensions; iExt++)
+			{
+				const GLubyte *pName = glGetStringi(GL_EXTENSIONS, iExt);
+				if(pName && strExtension == reinterpret_cast<const char *>(pName))
+					return true;
+			}
+
+			return false;
+		}
+
+		const char *GetShaderTypeName(GLenum eShaderType)
+		{
+			switch(eShaderType)
+			{
+			case GL_VERTEX_SHADER: return "vertex";
+			case GL_GEOMETRY_SHADER: return "geometry";
+			case GL_FRAGMENT_SHADER: return "fragment";
+			}
+
+			return "unknown";
+		}
+
+		//Does not wait for the compile to finish.
+		GLuint StartCompile(GLenum eShaderType, const std::string &strText)
+		{
+			GLuint shader = glCreateShader(eShaderType);
+			const char *strTextData = strText.c_str();
+			glShaderSource(shader, 1, &strTextData, NULL);
+			glCompileShader(shader);
+			return shader;
+		}
+
+		void FinishCompile(GLuint shader, GLenum eShaderType, const std::string &strName)
+		{
+			GLint status;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+			if(status == GL_TRUE)
+				return;
+
+			GLint infoLogLength;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+			std::vector<GLchar> infoLog(infoLogLength + 1, 0);
+			glGetShaderInfoLog(shader, infoLogLength, NULL, &infoLog[0]);
+			throw std::runtime_error(std::string("Compile failure in ") + GetShaderTypeName(eShaderType) +
+				" shader " + strName + ":\n" + &infoLog[0]);
+		}
+
+		double SecondsSince(const std::chrono::steady_clock::time_point &start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		std::string MakeDefineLines(const std::string &strDefines)
+		{
+			std::ostringstream output;
+			std::istringstream input(strDefines);
+			std::string strDefine;
+			while(input >> strDefine)
+			{
+				size_t equals = strDefine.find('=');
+				if(equals == std::string::npos)
+					output << "#define " << strDefine << "\n";
+				else
+					output << "#define " << strDefine.substr(0, equals) << " " << strDefine.substr(equals + 1) << "\n";
+			}
+
+			return output.str();
+		}
+	}
+
+	ShaderLibrary::ShaderLibrary(ProgramCache *pProgramCache)
+		: m_pProgramCache(pProgramCache)
+		, m_bCheckedExtensions(false)
+		, m_bParallelCompile(false)
+	{}
+
+	std::string ShaderLibrary::Preprocess(const std::string &strFilename, const std::string &strDefines) const
+	{
+		std::vector<std::string> includeStack;
+		std::ostringstream expanded;
+		AppendFile(strFilename, includeStack, expanded);
+
+		std::string strDefineLines = MakeDefineLines(strDefines);
+		if(strDefineLines.empty())
+			return expanded.str();
+
+		//The defines go right after #version, which must come before anything else.
+		std::istringstream input(expanded.str());
+		std::ostringstream output;
+		std::string strLine;
+		int iLine = 0;
+		bool bInserted = false;
+		while(std::getline(input, strLine))
+		{
+			iLine++;
+			output << strLine << "\n";
+			if(!bInserted && FindDirective(strLine, "version") != std::string::npos)
+			{
+				output << strDefineLines << "#line " << iLine + 1 << "\n";
+				bInserted = true;
+			}
+		}
+
+		if(!bInserted)
+			return strDefineLines + "#line 1\n" + expanded.str();
+
+		return output.str();
+	}
+
+	GLuint ShaderLibrary::GetShaderFromText(GLenum eShaderType, const std::string &strText)
+	{
+		m_stats.iNumShaderRequests++;
+
+		std::ostringstream key;
+		key << eShaderType << "\n" << strText;
+
+		std::map<std::string, GLuint>::const_iterator shaderIt = m_shaders.find(key.str());
+		if(shaderIt != m_shaders.end())
+			return shaderIt->second;
+
+		GLuint shader = StartCompile(eShaderType, strText);
+		m_shaders[key.str()] = shader;
+		m_stats.iNumShadersCompiled++;
+		return shader;
+	}
+
+	GLuint ShaderLibrary::GetShader(GLenum eShaderType, const std::string &strFilename,
+		const std::string &strDefines)
+	{
+		GLuint shader = GetShaderFromText(eShaderType, Preprocess(strFilename, strDefines));
+		FinishCompile(shader, eShaderType, strFilename);
+		return shader;
+	}
+
+	GLuint ShaderLibrary::LoadProgram(const std::string &strVertexShader, const std::string &strFragmentShader)
+	{
+		return LoadProgram(strVertexShader, "", strFragmentShader, "");
+	}
+
+	GLuint ShaderLibrary::LoadProgram(const std::string &strVertexShader, const std::string &strVertexDefines,
+		const std::string &strFragmentShader, const std::string &strFragmentDefines)
+	{
+		return FinishProgram(BeginProgram(strVertexShader, strVertexDefines, strFragmentShader, strFragmentDefines));
+	}
+
+	ShaderLibrary::ProgramHandle ShaderLibrary::BeginProgram(const std::string &strVertexShader,
+		const std::string &strVertexDefines, const std::string &strFragmentShader,
+		const std::string &strFragmentDefines)
+	{
+		if(!m_bCheckedExtensions)
+		{
+			m_bParallelCompile = HasExtension("GL_KHR_parallel_shader_compile") ||
+				HasExtension("GL_ARB_parallel_shader_compile");
+			m_bCheckedExtensions = true;
+		}
+
+		m_programs.push_back(PendingProgram());
+		PendingProgram &pending = m_programs.back();
+		pending.start = std::chrono::steady_clock::now();
+		pending.bFinished = false;
+		pending.bPolled = false;
+
+		pending.shaders.push_back(ShaderSource(GL_VERTEX_SHADER, strVertexShader,
+			Preprocess(strVertexShader, strVertexDefines)));
+		pending.shaders.push_back(ShaderSource(GL_FRAGMENT_SHADER, strFragmentShader,
+			Preprocess(strFragmentShader, strFragmentDefines)));
+
+		pending.program = m_pProgramCache ? m_pProgramCache->FindProgram(pending.shaders) : 0;
+		if(pending.program)
+		{
+			pending.bFinished = true;
+			return ProgramHandle((int)m_programs.size() - 1);
+		}
+
+		for(size_t iShader = 0; iShader < pending.shaders.size(); iShader++)
+		{
+			pending.shaderList.push_back(GetShaderFromText(pending.shaders[iShader].eShaderType,
+				pending.shaders[iShader].strText));
+		}
+
+		pending.program = StartLink(pending.shaderList);
+		return ProgramHandle((int)m_programs.size() - 1);
+	}
+
+	ShaderLibrary::PendingProgram &ShaderLibrary::GetPending(ProgramHandle hProgram)
+	{
+		if(!hProgram.IsValid() || (size_t)hProgram.m_iIndex >= m_programs.size())
+			throw std::runtime_error("Invalid program handle.");
+
+		return m_programs[hProgram.m_iIndex];
+	}
+
+	bool ShaderLibrary::IsProgramReady(ProgramHandle hProgram)
+	{
+		PendingProgram &pending = GetPending(hProgram);
+		if(pending.bFinished)
+			return true;
+
+		if(!m_bParallelCompile)
+		{
+			bool bFirstPoll = !pending.bPolled;
+			pending.bPolled = true;
+			return !bFirstPoll;
+		}
+
+		//Linking waits for the shaders, so this covers them too.
+		GLint status = GL_FALSE;
+		glGetProgramiv(pending.program, GL_COMPLETION_STATUS_ARB, &status);
+		return status == GL_TRUE;
+	}
+
+	GLuint ShaderLibrary::FinishProgram(ProgramHandle hProgram)
+	{
+		PendingProgram &pending = GetPending(hProgram);
+		if(!pending.bFinished)
+		{
+			pending.bFinished = true;
+
+			try
+			{
+				for(size_t iShader = 0; iShader < pending.shaders.size(); iShader++)
+				{
+					try
+					{
+						FinishCompile(pending.shaderList[iShader], pending.shaders[iShader].eShaderType,
+							pending.shaders[iShader].strName);
+					}
+					catch(...)
+					{
+						glDeleteProgram(pending.program);
+						throw;
+					}
+				}
+
+				FinishLink(pending.program, pending.shaderList);
+			}
+			catch(std::exception &except)
+			{
+				pending.program = 0;
+				pending.strError = except.what();
+			}
+
+			if(pending.program && m_pProgramCache)
+				m_pProgramCache->AddProgram(pending.shaders, pending.program, SecondsSince(pending.start));
+
+			//The text is only needed for the cache.
+			pending.shaders.clear();
+			pending.shaderList.clear();
+		}
+
+		if(!pending.program)
+			throw std::runtime_error(pending.strError);
+
+		return pending.program;
+	}
+
+	void ShaderLibrary::DeleteShaders()
+	{
+		for(std::map<std::string, GLuint>::const_iterator shaderIt = m_shaders.begin();
+			shaderIt != m_shaders.end(); ++shaderIt)
+		{
+			glDeleteShader(shaderIt->second);
+		}
+
+		m_shaders.clear();
+	}
+}
@@ -0,0 +1,126 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_SHADER_LIBRARY_H
+#define FRAMEWORK_SHADER_LIBRARY_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include "ProgramCache.h"
+
+namespace Framework
+{
+	struct ShaderLibraryStats
+	{
+		ShaderLibraryStats() : iNumShaderRequests(0), iNumShadersCompiled(0) {}
+
+		int iNumShaderRequests;
+		int iNumShadersCompiled;	//The rest reused a shader object that was already compiled.
+	};
+
+	//Builds shaders from files with two preprocessing steps, and compiles each distinct shader once.
+	//
+	//A line of the form #include "file" is replaced by that file, found with FindFileOrThrow.
+	//Included files may include others, but not themselves, and must not have a #version line.
+	//Permutations are given as a space-separated list of defines, NAME or NAME=VALUE, which are
+	//inserted after the #version line. #line directives keep compiler error line numbers matching
+	//the file that contains the error.
+	//
+	//Shader objects are shared by every program that uses the same stage with the same text. They
+	//are kept until DeleteShaders, so that programs linked later can reuse them.
+	//
+	//Programs can also be built without waiting for the driver: BeginProgram submits the compile and
+	//link, and nothing asks for their results until FinishProgram.
+	class ShaderLibrary
+	{
+	public:
+		//Refers to a program started with BeginProgram. Only valid for the library that returned it.
+		class ProgramHandle
+		{
+		public:
+			ProgramHandle() : m_iIndex(-1) {}
+
+			bool IsValid() const {return m_iIndex >= 0;}
+
+		private:
+			friend class ShaderLibrary;
+			explicit ProgramHandle(int iIndex) : m_iIndex(iIndex) {}
+
+			int m_iIndex;
+		};
+
+		//If pProgramCache is not NULL, programs are looked up in it first, and a shader is only
+		//compiled when a program that uses it is not in the cache. It must outlive the library.
+		explicit ShaderLibrary(ProgramCache *pProgramCache = NULL);
+
+		//Returns the text that would be compiled. Throws std::runtime_error if a file is missing or
+		//an include is recursive.
+		std::string Preprocess(const std::string &strFilename, const std::string &strDefines) const;
+
+		//Returns a shader object owned by the library. Throws std::runtime_error on compile errors.
+		GLuint GetShader(GLenum eShaderType, const std::string &strFilename, const std::string &strDefines = "");
+
+		//Links a program from the library's shaders. The caller owns the program. Defines are given per
+		//stage, so that a stage that does not change can still be shared.
+		GLuint LoadProgram(const std::string &strVertexShader, const std::string &strFragmentShader);
+		GLuint LoadProgram(const std::string &strVertexShader, const std::string &strVertexDefines,
+			const std::string &strFragmentShader, const std::string &strFragmentDefines);
+
+		//Starts compiling and linking a program, and returns without waiting for either. A program
+		//found in the program cache is ready at once.
+		ProgramHandle BeginProgram(const std::string &strVertexShader, const std::string &strVertexDefines,
+			const std::string &strFragmentShader, const std::string &strFragmentDefines);
+
+		//Never waits. With KHR_ or ARB_parallel_shader_compile, this asks the driver whether the program
+		//is done. Without either, there is no way to ask, so it returns false the first time it is
+		//called for a program and true after that. Polling once per frame then gives the driver at
+		//least one frame to work before FinishProgram waits for it. Throws std::runtime_error if the
+		//handle is invalid.
+		bool IsProgramReady(ProgramHandle hProgram);
+
+		//Waits for the program if it is not ready, and returns it. The caller owns the program. Throws
+		//std::runtime_error if the handle is invalid, and on compile or link errors, from this and any
+		//later call for the program.
+		GLuint FinishProgram(ProgramHandle hProgram);
+
+		//True if the driver can report compile progress. Only valid after the first BeginProgram.
+		bool HasParallelCompile() const {return m_bParallelCompile;}
+
+		//Deletes all of the library's shader objects. Programs that were linked from them are not
+		//affected, but programs that are still pending must be finished first.
+		void DeleteShaders();
+
+		const ShaderLibraryStats &GetStats() const {return m_stats;}
+
+	private:
+		struct PendingProgram
+		{
+			std::vector<ShaderSource> shaders;
+			std::vector<GLuint> shaderList;
+			GLuint program;
+			bool bFinished;
+			bool bPolled;		//IsProgramReady has been called for it.
+			std::string strError;
+			std::chrono::steady_clock::time_point start;
+		};
+
+		ProgramCache *m_pProgramCache;
+		std::map<std::string, GLuint> m_shaders;	//Keyed by shader type and text.
+		std::vector<PendingProgram> m_programs;
+		bool m_bCheckedExtensions;
+		bool m_bParallelCompile;
+		ShaderLibraryStats m_stats;
+
+		//The shader may still be compiling.
+		GLuint GetShaderFromText(GLenum eShaderType, const std::string &strText);
+
+		//Throws std::runtime_error if the handle did not come from this library's BeginProgram.
+		PendingProgram &GetPending(ProgramHandle hProgram);
+	};
+}
+
+
+#endif //FRAMEWORK_SHADER_LIBRARY_H
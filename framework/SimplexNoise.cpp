@@ -0,0 +1,508 @@
+//Copyright (C) 2010-2012 by Jason L. McKesson
+//This file is licensed under the MIT License.
+
+
+#include <algorithm>
+#include <glload/gl_3_3.h>
+#include <glm/glm.hpp>
+#include "SimplexNoise.h"
+#include "ParallelFor.h"
+
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+#define FRAMEWORK_BATCH_SSE
+#endif
+
+
+namespace Framework
+{
+	namespace
+	{
+		//Below this many samples per thread, starting the threads costs more than they save.
+		const size_t g_minSamplesPerThread = 16384;
+
+		//Skewing from input space to the simplex grid, and back.
+		const float g_skew2 = 0.366025403784f;		//(sqrt(3) - 1) / 2
+		const float g_unskew2 = 0.211324865405f;	//(3 - sqrt(3)) / 6
+		const float g_skew3 = 1.0f / 3.0f;
+		const float g_unskew3 = 1.0f / 6.0f;
+
+		//Offsets of the later corners of a simplex, in input space.
+		const float g_corner2[2] = {g_unskew2, 2.0f * g_unskew2};
+		const float g_corner3[3] = {g_unskew3, 2.0f * g_unskew3, 3.0f * g_unskew3};
+
+		//Scales the sum of the corners to about [-1, 1]. Found by sampling.
+		const float g_scale2 = 45.0f;
+		const float g_scale3 = 76.0f;
+
+		//The gradient of a corner is picked by its hash. Both versions of each function do the same
+		//operations in the same order, so that they give the same bits.
+		int Hash(const unsigned char *pPerm, int i, int j)
+		{
+			return pPerm[i + pPerm[j]];
+		}
+
+		int Hash(const unsigned char *pPerm, int i, int j, int k)
+		{
+			return pPerm[i + pPerm[j + pPerm[k]]];
+		}
+
+#ifdef FRAMEWORK_BATCH_SSE
+		//Four points at once, one per lane. The hashes are looked up one lane at a time.
+		__m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+		}
+
+		__m128i FloorToInt(__m128 value)
+		{
+			__m128i truncated = _mm_cvttps_epi32(value);
+			__m128 isAbove = _mm_cmplt_ps(value, _mm_cvtepi32_ps(truncated));
+			return _mm_add_epi32(truncated, _mm_castps_si128(isAbove));
+		}
+
+		//1 where the mask is set, and 0 elsewhere.
+		__m128i MaskToInt(__m128 mask)
+		{
+			return _mm_srli_epi32(_mm_castps_si128(mask), 31);
+		}
+
+		__m128 MaskToFloat(__m128 mask)
+		{
+			return _mm_and_ps(mask, _mm_set1_ps(1.0f));
+		}
+
+		//Negates u where bit 0 of the hash is set, and v where bit 1 is.
+		__m128 SignedSum(__m128i hash, __m128 u, __m128 v)
+		{
+			__m128 uSign = _mm_castsi128_ps(_mm_slli_epi32(hash, 31));
+			__m128 vSign = _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(hash, 30), _mm_set1_epi32((int)0x80000000)));
+			return _mm_add_ps(_mm_xor_ps(u, uSign), _mm_xor_ps(v, vSign));
+		}
+
+		__m128 Gradient(__m128i hash, __m128 x, __m128 y)
+		{
+			__m128 useY = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(4)), _mm_set1_epi32(4)));
+			__m128 v = Select(useY, x, y);
+			return SignedSum(hash, Select(useY, y, x), _mm_add_ps(v, v));
+		}
+
+		__m128 Gradient(__m128i hash, __m128 x, __m128 y, __m128 z)
+		{
+			hash = _mm_and_si128(hash, _mm_set1_epi32(15));
+			__m128 below8 = _mm_castsi128_ps(_mm_cmplt_epi32(hash, _mm_set1_epi32(8)));
+			__m128 below4 = _mm_castsi128_ps(_mm_cmplt_epi32(hash, _mm_set1_epi32(4)));
+			__m128 useX = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(hash, _mm_set1_epi32(12)),
+				_mm_cmpeq_epi32(hash, _mm_set1_epi32(14))));
+			return SignedSum(hash, Select(below8, x, y), Select(below4, y, Select(useX, x, z)));
+		}
+
+		__m128 Falloff(__m128 distanceSqr, __m128 gradient)
+		{
+			__m128 t = _mm_max_ps(_mm_setzero_ps(), _mm_sub_ps(_mm_set1_ps(0.5f), distanceSqr));
+			t = _mm_mul_ps(t, t);
+			return _mm_mul_ps(_mm_mul_ps(t, t), gradient);
+		}
+
+		__m128 Corner(__m128i hash, __m128 x, __m128 y)
+		{
+			__m128 distanceSqr = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+			return Falloff(distanceSqr, Gradient(hash, x, y));
+		}
+
+		__m128 Corner(__m128i hash, __m128 x, __m128 y, __m128 z)
+		{
+			__m128 distanceSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			return Falloff(distanceSqr, Gradient(hash, x, y, z));
+		}
+
+		__m128 Noise2(const unsigned char *pPerm, __m128 x, __m128 y)
+		{
+			__m128 skew = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(g_skew2));
+			__m128i i = FloorToInt(_mm_add_ps(x, skew));
+			__m128i j = FloorToInt(_mm_add_ps(y, skew));
+
+			__m128 unskew = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(i, j)), _mm_set1_ps(g_unskew2));
+			__m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), unskew));
+			__m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), unskew));
+
+			//The middle corner is one step along x if x0 > y0, and along y otherwise.
+			__m128 alongX = _mm_cmpgt_ps(x0, y0);
+			__m128 alongY = _mm_cmpngt_ps(x0, y0);
+
+			int ii[4], jj[4], i1[4];
+			_mm_storeu_si128((__m128i *)ii, _mm_and_si128(i, _mm_set1_epi32(255)));
+			_mm_storeu_si128((__m128i *)jj, _mm_and_si128(j, _mm_set1_epi32(255)));
+			_mm_storeu_si128((__m128i *)i1, MaskToInt(alongX));
+
+			int hashes[3][4];
+			for(int iLane = 0; iLane < 4; iLane++)
+			{
+				int j1 = 1 - i1[iLane];
+				hashes[0][iLane] = Hash(pPerm, ii[iLane], jj[iLane]);
+				hashes[1][iLane] = Hash(pPerm, ii[iLane] + i1[iLane], jj[iLane] + j1);
+				hashes[2][iLane] = Hash(pPerm, ii[iLane] + 1, jj[iLane] + 1);
+			}
+
+			__m128 unskew1 = _mm_set1_ps(g_corner2[0]);
+			__m128 unskew2 = _mm_set1_ps(g_corner2[1]);
+			__m128 one = _mm_set1_ps(1.0f);
+
+			__m128 sum = Corner(_mm_loadu_si128((__m128i *)hashes[0]), x0, y0);
+			sum = _mm_add_ps(sum, Corner(_mm_loadu_si128((__m128i *)hashes[1]),
+				_mm_add_ps(_mm_sub_ps(x0, MaskToFloat(alongX)), unskew1),
+				_mm_add_ps(_mm_sub_ps(y0, MaskToFloat(alongY)), unskew1)));
+			sum = _mm_add_ps(sum, Corner(_mm_loadu_si128((__m128i *)hashes[2]),
+				_mm_add_ps(_mm_sub_ps(x0, one), unskew2), _mm_add_ps(_mm_sub_ps(y0, one), unskew2)));
+
+			return _mm_mul_ps(sum, _mm_set1_ps(g_scale2));
+		}
+
+		__m128 Noise3(const unsigned char *pPerm, __m128 x, __m128 y, __m128 z)
+		{
+			__m128 skew = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), _mm_set1_ps(g_skew3));
+			__m128i i = FloorToInt(_mm_add_ps(x, skew));
+			__m128i j = FloorToInt(_mm_add_ps(y, skew));
+			__m128i k = FloorToInt(_mm_add_ps(z, skew));
+
+			__m128 unskew = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(i, j), k)),
+				_mm_set1_ps(g_unskew3));
+			__m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), unskew));
+			__m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), unskew));
+			__m128 z0 = _mm_sub_ps(z, _mm_sub_ps(_mm_cvtepi32_ps(k), unskew));
+
+			//The second corner is one step along the largest of x0, y0 and z0, and the third is one
+			//step along each of the two largest.
+			__m128 xy = _mm_cmpge_ps(x0, y0);
+			__m128 yz = _mm_cmpge_ps(y0, z0);
+			__m128 xz = _mm_cmpge_ps(x0, z0);
+			__m128 allSet = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			__m128 step1[3] = {_mm_and_ps(xy, xz), _mm_andnot_ps(xy, yz), _mm_xor_ps(_mm_or_ps(yz, xz), allSet)};
+			__m128 step2[3] = {_mm_or_ps(xy, xz), _mm_xor_ps(_mm_andnot_ps(yz, xy), allSet),
+				_mm_xor_ps(_mm_and_ps(yz, xz), allSet)};
+
+			int ii[4], jj[4], kk[4], steps[6][4];
+			_mm_storeu_si128((__m128i *)ii, _mm_and_si128(i, _mm_set1_epi32(255)));
+			_mm_storeu_si128((__m128i *)jj, _mm_and_si128(j, _mm_set1_epi32(255)));
+			_mm_storeu_si128((__m128i *)kk, _mm_and_si128(k, _mm_set1_epi32(255)));
+			for(int iAxis = 0; iAxis < 3; iAxis++)
+			{
+				_mm_storeu_si128((__m128i *)steps[iAxis], MaskToInt(step1[iAxis]));
+				_mm_storeu_si128((__m128i *)steps[iAxis + 3], MaskToInt(step2[iAxis]));
+			}
+
+			int hashes[4][4];
+			for(int iLane = 0; iLane < 4; iLane++)
+			{
+				hashes[0][iLane] = Hash(pPerm, ii[iLane], jj[iLane], kk[iLane]);
+				hashes[1][iLane] = Hash(pPerm, ii[iLane] + steps[0][iLane], jj[iLane] + steps[1][iLane],
+					kk[iLane] + steps[2][iLane]);
+				hashes[2][iLane] = Hash(pPerm, ii[iLane] + steps[3][iLane], jj[iLane] + steps[4][iLane],
+					kk[iLane] + steps[5][iLane]);
+				hashes[3][iLane] = Hash(pPerm, ii[iLane] + 1, jj[iLane] + 1, kk[iLane] + 1);
+			}
+
+			__m128 unskew1 = _mm_set1_ps(g_corner3[0]);
+			__m128 unskew2 = _mm_set1_ps(g_corner3[1]);
+			__m128 unskew3 = _mm_set1_ps(g_corner3[2]);
+			__m128 one = _mm_set1_ps(1.0f);
+
+			__m128 sum = Corner(_mm_loadu_si128((__m128i *)hashes[0]), x0, y0, z0);
+			sum = _mm_add_ps(sum, Corner(_mm_loadu_si128((__m128i *)hashes[1]),
+				_mm_add_ps(_mm_sub_ps(x0, MaskToFloat(step1[0])), unskew1),
+				_mm_add_ps(_mm_sub_ps(y0, MaskToFloat(step1[1])), unskew1),
+				_mm_add_ps(_mm_sub_ps(z0, MaskToFloat(step1[2])), unskew1)));
+			sum = _mm_add_ps(sum, Corner(_mm_loadu_si128((__m128i *)hashes[2]),
+				_mm_add_ps(_mm_sub_ps(x0, MaskToFloat(step2[0])), unskew2),
+				_mm_add_ps(_mm_sub_ps(y0, MaskToFloat(step2[1])), unskew2),
+				_mm_add_ps(_mm_sub_ps(z0, MaskToFloat(step2[2])), unskew2)));
+			sum = _mm_add_ps(sum, Corner(_mm_loadu_si128((__m128i *)hashes[3]),
+				_mm_add_ps(_mm_sub_ps(x0, one), unskew3), _mm_add_ps(_mm_sub_ps(y0, one), unskew3),
+				_mm_add_ps(_mm_sub_ps(z0, one), unskew3)));
+
+			return _mm_mul_ps(sum, _mm_set1_ps(g_scale3));
+		}
+
+		//Sums the octaves. The first is not added to 0, so that one octave gives Noise2 exactly.
+		__m128 Fractal2(const unsigned char *pPerm, __m128 x, __m128 y, int iNumOctaves, float scale)
+		{
+			__m128 sum = Noise2(pPerm, x, y);
+			float amplitude = 1.0f;
+			for(int iOctave = 1; iOctave < iNumOctaves; iOctave++)
+			{
+				x = _mm_add_ps(x, x);
+				y = _mm_add_ps(y, y);
+				amplitude *= 0.5f;
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(amplitude), Noise2(pPerm, x, y)));
+			}
+
+			return _mm_mul_ps(sum, _mm_set1_ps(scale));
+		}
+
+		float Noise2(const unsigned char *pPerm, float x, float y)
+		{
+			return _mm_cvtss_f32(Noise2(pPerm, _mm_set1_ps(x), _mm_set1_ps(y)));
+		}
+
+		float Noise3(const unsigned char *pPerm, float x, float y, float z)
+		{
+			return _mm_cvtss_f32(Noise3(pPerm, _mm_set1_ps(x), _mm_set1_ps(y), _mm_set1_ps(z)));
+		}
+#else
+		int FloorToInt(float value)
+		{
+			int truncated = (int)value;
+			return truncated - (value < (float)truncated ? 1 : 0);
+		}
+
+		float Gradient(int hash, float x, float y)
+		{
+			float u = (hash & 4) ? y : x;
+			float v = (hash & 4) ? x : y;
+			v = v + v;
+			return ((hash & 1) ? -u : u) + ((hash & 2) ? -v : v);
+		}
+
+		float Gradient(int hash, float x, float y, float z)
+		{
+			hash &= 15;
+			float u = hash < 8 ? x : y;
+			float v = hash < 4 ? y : ((hash == 12 || hash == 14) ? x : z);
+			return ((hash & 1) ? -u : u) + ((hash & 2) ? -v : v);
+		}
+
+		float Falloff(float distanceSqr, float gradient)
+		{
+			float t = 0.5f - distanceSqr;
+			if(0.0f > t)
+				t = 0.0f;
+			t = t * t;
+			return (t * t) * gradient;
+		}
+
+		float Corner(int hash, float x, float y)
+		{
+			return Falloff(x * x + y * y, Gradient(hash, x, y));
+		}
+
+		float Corner(int hash, float x, float y, float z)
+		{
+			return Falloff(x * x + y * y + z * z, Gradient(hash, x, y, z));
+		}
+
+		float Noise2(const unsigned char *pPerm, float x, float y)
+		{
+			float skew = (x + y) * g_skew2;
+			int i = FloorToInt(x + skew);
+			int j = FloorToInt(y + skew);
+
+			float unskew = (float)(i + j) * g_unskew2;
+			float x0 = x - ((float)i - unskew);
+			float y0 = y - ((float)j - unskew);
+
+			int i1 = x0 > y0 ? 1 : 0;
+			int j1 = 1 - i1;
+			int ii = i & 255;
+			int jj = j & 255;
+
+			float sum = Corner(Hash(pPerm, ii, jj), x0, y0);
+			sum = sum + Corner(Hash(pPerm, ii + i1, jj + j1), (x0 - (float)i1) + g_corner2[0],
+				(y0 - (float)j1) + g_corner2[0]);
+			sum = sum + Corner(Hash(pPerm, ii + 1, jj + 1), (x0 - 1.0f) + g_corner2[1],
+				(y0 - 1.0f) + g_corner2[1]);
+
+			return sum * g_scale2;
+		}
+
+		float Noise3(const unsigned char *pPerm, float x, float y, float z)
+		{
+			float skew = (x + y + z) * g_skew3;
+			int i = FloorToInt(x + skew);
+			int j = FloorToInt(y + skew);
+			int k = FloorToInt(z + skew);
+
+			float unskew = (float)(i + j + k) * g_unskew3;
+			float x0 = x - ((float)i - unskew);
+			float y0 = y - ((float)j - unskew);
+			float z0 = z - ((float)k - unskew);
+
+			bool xy = x0 >= y0;
+			bool yz = y0 >= z0;
+			bool xz = x0 >= z0;
+			int i1 = (xy && xz) ? 1 : 0;
+			int j1 = (!xy && yz) ? 1 : 0;
+			int k1 = !(yz || xz) ? 1 : 0;
+			int i2 = (xy || xz) ? 1 : 0;
+			int j2 = !(xy && !yz) ? 1 : 0;
+			int k2 = !(yz && xz) ? 1 : 0;
+			int ii = i & 255;
+			int jj = j & 255;
+			int kk = k & 255;
+
+			float sum = Corner(Hash(pPerm, ii, jj, kk), x0, y0, z0);
+			sum = sum + Corner(Hash(pPerm, ii + i1, jj + j1, kk + k1), (x0 - (float)i1) + g_corner3[0],
+				(y0 - (float)j1) + g_corner3[0], (z0 - (float)k1) + g_corner3[0]);
+			sum = sum + Corner(Hash(pPerm, ii + i2, jj + j2, kk + k2), (x0 - (float)i2) + g_corner3[1],
+				(y0 - (float)j2) + g_corner3[1], (z0 - (float)k2) + g_corner3[1]);
+			sum = sum + Corner(Hash(pPerm, ii + 1, jj + 1, kk + 1), (x0 - 1.0f) + g_corner3[2],
+				(y0 - 1.0f) + g_corner3[2], (z0 - 1.0f) + g_corner3[2]);
+
+			return sum * g_scale3;
+		}
+#endif
+
+		float Fractal2(const unsigned char *pPerm, float x, float y, int iNumOctaves, float scale)
+		{
+			float sum = Noise2(pPerm, x, y);
+			float amplitude = 1.0f;
+			for(int iOctave = 1; iOctave < iNumOctaves; iOctave++)
+			{
+				x = x + x;
+				y = y + y;
+				amplitude *= 0.5f;
+				sum = sum + amplitude * Noise2(pPerm, x, y);
+			}
+
+			return sum * scale;
+		}
+
+		struct PointKernel2
+		{
+			const unsigned char *pPerm;
+			const glm::vec2 *pPoints;
+			float *pOut;
+
+			void operator()(size_t begin, size_t end) const
+			{
+				size_t iPoint = begin;
+#ifdef FRAMEWORK_BATCH_SSE
+				for(; iPoint + 4 <= end; iPoint += 4)
+				{
+					__m128 first = _mm_loadu_ps(&pPoints[iPoint][0]);
+					__m128 second = _mm_loadu_ps(&pPoints[iPoint + 2][0]);
+					_mm_storeu_ps(&pOut[iPoint], Noise2(pPerm, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)),
+						_mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1))));
+				}
+#endif
+				for(; iPoint < end; iPoint++)
+					pOut[iPoint] = Noise2(pPerm, pPoints[iPoint].x, pPoints[iPoint].y);
+			}
+		};
+
+		struct PointKernel3
+		{
+			const unsigned char *pPerm;
+			const glm::vec3 *pPoints;
+			float *pOut;
+
+			void operator()(size_t begin, size_t end) const
+			{
+				size_t iPoint = begin;
+#ifdef FRAMEWORK_BATCH_SSE
+				for(; iPoint + 4 <= end; iPoint += 4)
+				{
+					const glm::vec3 *pFour = &pPoints[iPoint];
+					_mm_storeu_ps(&pOut[iPoint], Noise3(pPerm,
+						_mm_setr_ps(pFour[0].x, pFour[1].x, pFour[2].x, pFour[3].x),
+						_mm_setr_ps(pFour[0].y, pFour[1].y, pFour[2].y, pFour[3].y),
+						_mm_setr_ps(pFour[0].z, pFour[1].z, pFour[2].z, pFour[3].z)));
+				}
+#endif
+				for(; iPoint < end; iPoint++)
+					pOut[iPoint] = Noise3(pPerm, pPoints[iPoint].x, pPoints[iPoint].y, pPoints[iPoint].z);
+			}
+		};
+
+		struct GridKernel
+		{
+			const unsigned char *pPerm;
+			glm::vec2 origin;
+			float spacing;
+			int width;
+			int iNumOctaves;
+			float scale;
+			float *pOut;
+
+			void operator()(size_t beginRow, size_t endRow) const
+			{
+				for(size_t iRow = beginRow; iRow < endRow; iRow++)
+				{
+					float y = origin.y + spacing * (float)iRow;
+					float *pRow = pOut + iRow * width;
+
+					int iColumn = 0;
+#ifdef FRAMEWORK_BATCH_SSE
+					for(; iColumn + 4 <= width; iColumn += 4)
+					{
+						__m128 columns = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(iColumn),
+							_mm_setr_epi32(0, 1, 2, 3)));
+						__m128 x = _mm_add_ps(_mm_set1_ps(origin.x), _mm_mul_ps(_mm_set1_ps(spacing), columns));
+						_mm_storeu_ps(&pRow[iColumn], Fractal2(pPerm, x, _mm_set1_ps(y), iNumOctaves, scale));
+					}
+#endif
+					for(; iColumn < width; iColumn++)
+					{
+						pRow[iColumn] = Fractal2(pPerm, origin.x + spacing * (float)iColumn, y, iNumOctaves,
+							scale);
+					}
+				}
+			}
+		};
+	}
+
+	SimplexNoise::SimplexNoise(unsigned int seed)
+	{
+		for(int iEntry = 0; iEntry < 256; iEntry++)
+			m_perm[iEntry] = (unsigned char)iEntry;
+
+		//A Fisher-Yates shuffle, with a fixed generator so that every platform gets the same table.
+		for(int iEntry = 255; iEntry > 0; iEntry--)
+		{
+			seed = seed * 1664525 + 1013904223;
+			std::swap(m_perm[iEntry], m_perm[(seed >> 8) % (iEntry + 1)]);
+		}
+
+		std::copy(m_perm, m_perm + 256, m_perm + 256);
+	}
+
+	float SimplexNoise::Noise(const glm::vec2 &point) const
+	{
+		return Noise2(m_perm, point.x, point.y);
+	}
+
+	float SimplexNoise::Noise(const glm::vec3 &point) const
+	{
+		return Noise3(m_perm, point.x, point.y, point.z);
+	}
+
+	void SimplexNoise::Noise(const glm::vec2 *pPoints, float *pOut, size_t count, unsigned int numThreads) const
+	{
+		PointKernel2 kernel = {m_perm, pPoints, pOut};
+		ParallelFor(kernel, count, g_minSamplesPerThread, numThreads);
+	}
+
+	void SimplexNoise::Noise(const glm::vec3 *pPoints, float *pOut, size_t count, unsigned int numThreads) const
+	{
+		PointKernel3 kernel = {m_perm, pPoints, pOut};
+		ParallelFor(kernel, count, g_minSamplesPerThread, numThreads);
+	}
+
+	void SimplexNoise::Grid(const glm::vec2 &origin, float spacing, int width, int height, int iNumOctaves,
+		float *pOut, unsigned int numThreads) const
+	{
+		if(width <= 0 || height <= 0)
+			return;
+
+		iNumOctaves = std::max(iNumOctaves, 1);
+		float totalAmplitude = 0.0f;
+		float amplitude = 1.0f;
+		for(int iOctave = 0; iOctave < iNumOctaves; iOctave++)
+		{
+			totalAmplitude += amplitude;
+			amplitude *= 0.5f;
+		}
+
+		GridKernel kernel = {m_perm, origin, spacing, width, iNumOctaves, 1.0f / totalAmplitude, pOut};
+		size_t minRowsPerThread = std::max(g_minSamplesPerThread / width, (size_t)1);
+		ParallelFor(kernel, (size_t)height, minRowsPerThread, numThreads);
+	}
+}
@@ -0,0 +1,47 @@
+/** Copyright (C) 2010-2012 by Jason L. McKesson **/
+/** This file is licensed under the MIT License. **/
+
+
+#ifndef FRAMEWORK_SIMPLEX_NOISE_H
+#define FRAMEWORK_SIMPLEX_NOISE_H
+
+#include <glm/glm.hpp>
+
+namespace Framework
+{
+	//Simplex noise, for making terrain heights, vegetation densities and the like at startup.
+	//Values are in about [-1, 1].
+	//
+	//A value depends only on the seed and the point. It is the same on every run, from the
+	//single and batch functions, for any number of threads, and with or without SSE2.
+	//
+	//Large batches are split across threads. If numThreads is 0, one thread per hardware core is
+	//used. Batches too small to gain from more threads are done on the calling thread.
+	class SimplexNoise
+	{
+	public:
+		explicit SimplexNoise(unsigned int seed = 0);
+
+		float Noise(const glm::vec2 &point) const;
+		float Noise(const glm::vec3 &point) const;
+
+		//pOut[i] = Noise(pPoints[i]).
+		void Noise(const glm::vec2 *pPoints, float *pOut, size_t count, unsigned int numThreads = 0) const;
+		void Noise(const glm::vec3 *pPoints, float *pOut, size_t count, unsigned int numThreads = 0) const;
+
+		//Fills pOut with width * height samples, row by row, for heightfields and density maps.
+		//The sample in column x of row y is at origin + spacing * vec2(x, y). With more than one
+		//octave, each octave has twice the frequency and half the amplitude of the one before, and
+		//the sum is divided by the total amplitude to stay in about [-1, 1]. With one octave, the
+		//samples are the same as from Noise().
+		void Grid(const glm::vec2 &origin, float spacing, int width, int height, int iNumOctaves,
+			float *pOut, unsigned int numThreads = 0) const;
+
+	private:
+		//A shuffle of 0-255, repeated twice so that sums of two entries need no wrapping.
+		unsigned char m_perm[512];
+	};
+}
+
+
+#endif //FRAMEWORK_SIMPLEX_NOISE_H
@@ -117,6 +117,42 @@ namespace glm
         //! \li GLSL 4.00.08 specification, section 8.4
 		detail::tvec2<detail::uint32> unpackDouble2x32(double const & v);
 
+        //! Packs each component of v into 10 bits, except for w, which gets the top 2 bits, in the
+        //! GL_UNSIGNED_INT_2_10_10_10_REV layout. The conversion is the same as for packUnorm4x8,
+        //! with 1023.0 as the scale for x, y and z, and 3.0 for w.
+		detail::uint32 packUnorm3x10_1x2(detail::tvec4<detail::float32> const & v);
+
+        //! Packs each component of v in the GL_INT_2_10_10_10_REV layout. The conversion is the
+        //! same as for packSnorm4x8, with 511.0 as the scale for x, y and z, and 1.0 for w.
+        //! GL 4.2 normalizes these vertex attributes the same way; GL 3.3 uses (2c + 1) / (2^b - 1),
+        //! which is up to half a step away.
+		detail::uint32 packSnorm3x10_1x2(detail::tvec4<detail::float32> const & v);
+
+        //! The inverse of packUnorm3x10_1x2: f / 1023.0 for x, y and z, and f / 3.0 for w.
+		detail::tvec4<detail::float32> unpackUnorm3x10_1x2(detail::uint32 const & p);
+
+        //! The inverse of packSnorm3x10_1x2: clamp(f / 511.0, -1, +1) for x, y and z, and
+        //! clamp(f, -1, +1) for w.
+		detail::tvec4<detail::float32> unpackSnorm3x10_1x2(detail::uint32 const & p);
+
+        //! Array versions, for whole vertex attributes. They convert count elements, using SSE2
+        //! when available, and give the same results as calling the scalar versions on each.
+		void packUnorm2x16(detail::tvec2<detail::float32> const * v, detail::uint32 * p, std::size_t count);
+		void packSnorm2x16(detail::tvec2<detail::float32> const * v, detail::uint32 * p, std::size_t count);
+		void packUnorm4x8(detail::tvec4<detail::float32> const * v, detail::uint32 * p, std::size_t count);
+		void packSnorm4x8(detail::tvec4<detail::float32> const * v, detail::uint32 * p, std::size_t count);
+		void packHalf2x16(detail::tvec2<detail::float32> const * v, detail::uint32 * p, std::size_t count);
+		void packUnorm3x10_1x2(detail::tvec4<detail::float32> const * v, detail::uint32 * p, std::size_t count);
+		void packSnorm3x10_1x2(detail::tvec4<detail::float32> const * v, detail::uint32 * p, std::size_t count);
+
+		void unpackUnorm2x16(detail::uint32 const * p, detail::tvec2<detail::float32> * v, std::size_t count);
+		void unpackSnorm2x16(detail::uint32 const * p, detail::tvec2<detail::float32> * v, std::size_t count);
+		void unpackUnorm4x8(detail::uint32 const * p, detail::tvec4<detail::float32> * v, std::size_t count);
+		void unpackSnorm4x8(detail::uint32 const * p, detail::tvec4<detail::float32> * v, std::size_t count);
+		void unpackHalf2x16(detail::uint32 const * p, detail::tvec2<detail::float32> * v, std::size_t count);
+		void unpackUnorm3x10_1x2(detail::uint32 const * p, detail::tvec4<detail::float32> * v, std::size_t count);
+		void unpackSnorm3x10_1x2(detail::uint32 const * p, detail::tvec4<detail::float32> * v, std::size_t count);
+
 		///@}
 
 	}//namespace packing
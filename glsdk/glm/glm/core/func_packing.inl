@@ -7,6 +7,8 @@
 // File    : glm/core/func_packing.inl
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "intrinsic_packing.hpp"
+
 namespace glm{
 namespace core{
 namespace function{
@@ -140,6 +142,379 @@ GLM_FUNC_QUALIFIER vec2 unpackHalf2x16(uint const & v)
 	return vec2(detail::toFloat32(Unpack.x), detail::toFloat32(Unpack.y));
 }
 
+GLM_FUNC_QUALIFIER detail::uint32 packUnorm3x10_1x2(detail::tvec4<detail::float32> const & v)
+{
+	detail::uint32 A(detail::uint32(round(clamp(v.x, 0.0f, 1.0f) * 1023.0f)));
+	detail::uint32 B(detail::uint32(round(clamp(v.y, 0.0f, 1.0f) * 1023.0f)));
+	detail::uint32 C(detail::uint32(round(clamp(v.z, 0.0f, 1.0f) * 1023.0f)));
+	detail::uint32 D(detail::uint32(round(clamp(v.w, 0.0f, 1.0f) * 3.0f)));
+	return detail::uint32((D << 30) | (C << 20) | (B << 10) | A);
+}
+
+GLM_FUNC_QUALIFIER detail::tvec4<detail::float32> unpackUnorm3x10_1x2(detail::uint32 const & p)
+{
+	detail::uint32 Mask10((1 << 10) - 1);
+	detail::uint32 A((p >>  0) & Mask10);
+	detail::uint32 B((p >> 10) & Mask10);
+	detail::uint32 C((p >> 20) & Mask10);
+	detail::uint32 D((p >> 30));
+	return detail::tvec4<detail::float32>(
+		A * 1.0f / 1023.0f, 
+		B * 1.0f / 1023.0f, 
+		C * 1.0f / 1023.0f, 
+		D * 1.0f / 3.0f);
+}
+
+GLM_FUNC_QUALIFIER detail::uint32 packSnorm3x10_1x2(detail::tvec4<detail::float32> const & v)
+{
+	detail::tvec4<detail::float32> Unpack = clamp(v, -1.0f, 1.0f) * detail::tvec4<detail::float32>(511.0f, 511.0f, 511.0f, 1.0f);
+	detail::uint32 Mask10((1 << 10) - 1);
+	detail::uint32 A(detail::uint32(detail::int32(round(Unpack.x))) & Mask10);
+	detail::uint32 B(detail::uint32(detail::int32(round(Unpack.y))) & Mask10);
+	detail::uint32 C(detail::uint32(detail::int32(round(Unpack.z))) & Mask10);
+	detail::uint32 D(detail::uint32(detail::int32(round(Unpack.w))));
+	return detail::uint32((D << 30) | (C << 20) | (B << 10) | A);
+}
+
+GLM_FUNC_QUALIFIER detail::tvec4<detail::float32> unpackSnorm3x10_1x2(detail::uint32 const & p)
+{
+	// Shifting each field to the top and back down extends its sign.
+	detail::int32 A(detail::int32(p << 22) >> 22);
+	detail::int32 B(detail::int32(p << 12) >> 22);
+	detail::int32 C(detail::int32(p <<  2) >> 22);
+	detail::int32 D(detail::int32(p) >> 30);
+	detail::tvec4<detail::float32> Pack(A, B, C, D);
+
+	return clamp(Pack * 1.0f / detail::tvec4<detail::float32>(511.0f, 511.0f, 511.0f, 1.0f), -1.0f, 1.0f);
+}
+
+GLM_FUNC_QUALIFIER void packUnorm2x16
+(
+	detail::tvec2<detail::float32> const * v,
+	detail::uint32 * p,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(65535.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		// Sign extend the low 16 bits, so that the signed saturation keeps them.
+		__m128i A = detail::sse_packUnorm_ps(_mm_loadu_ps(&v[i + 0].x), Scale);
+		__m128i B = detail::sse_packUnorm_ps(_mm_loadu_ps(&v[i + 2].x), Scale);
+		A = _mm_srai_epi32(_mm_slli_epi32(A, 16), 16);
+		B = _mm_srai_epi32(_mm_slli_epi32(B, 16), 16);
+		_mm_storeu_si128((__m128i *)(p + i), _mm_packs_epi32(A, B));
+	}
+#endif
+	for(; i < count; ++i)
+		p[i] = packUnorm2x16(v[i]);
+}
+
+GLM_FUNC_QUALIFIER void packSnorm2x16
+(
+	detail::tvec2<detail::float32> const * v,
+	detail::uint32 * p,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(32767.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i A = detail::sse_packSnorm_ps(_mm_loadu_ps(&v[i + 0].x), Scale);
+		__m128i B = detail::sse_packSnorm_ps(_mm_loadu_ps(&v[i + 2].x), Scale);
+		_mm_storeu_si128((__m128i *)(p + i), _mm_packs_epi32(A, B));
+	}
+#endif
+	for(; i < count; ++i)
+		p[i] = packSnorm2x16(v[i]);
+}
+
+GLM_FUNC_QUALIFIER void packUnorm4x8
+(
+	detail::tvec4<detail::float32> const * v,
+	detail::uint32 * p,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(255.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i A = detail::sse_packUnorm_ps(_mm_loadu_ps(&v[i + 0].x), Scale);
+		__m128i B = detail::sse_packUnorm_ps(_mm_loadu_ps(&v[i + 1].x), Scale);
+		__m128i C = detail::sse_packUnorm_ps(_mm_loadu_ps(&v[i + 2].x), Scale);
+		__m128i D = detail::sse_packUnorm_ps(_mm_loadu_ps(&v[i + 3].x), Scale);
+		_mm_storeu_si128((__m128i *)(p + i), _mm_packus_epi16(_mm_packs_epi32(A, B), _mm_packs_epi32(C, D)));
+	}
+#endif
+	for(; i < count; ++i)
+		p[i] = packUnorm4x8(v[i]);
+}
+
+GLM_FUNC_QUALIFIER void packSnorm4x8
+(
+	detail::tvec4<detail::float32> const * v,
+	detail::uint32 * p,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(127.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i A = detail::sse_packSnorm_ps(_mm_loadu_ps(&v[i + 0].x), Scale);
+		__m128i B = detail::sse_packSnorm_ps(_mm_loadu_ps(&v[i + 1].x), Scale);
+		__m128i C = detail::sse_packSnorm_ps(_mm_loadu_ps(&v[i + 2].x), Scale);
+		__m128i D = detail::sse_packSnorm_ps(_mm_loadu_ps(&v[i + 3].x), Scale);
+		_mm_storeu_si128((__m128i *)(p + i), _mm_packs_epi16(_mm_packs_epi32(A, B), _mm_packs_epi32(C, D)));
+	}
+#endif
+	for(; i < count; ++i)
+		p[i] = packSnorm4x8(v[i]);
+}
+
+GLM_FUNC_QUALIFIER void packHalf2x16
+(
+	detail::tvec2<detail::float32> const * v,
+	detail::uint32 * p,
+	std::size_t count
+)
+{
+	// Like the scalar version, this assumes that x goes in the low 16 bits in memory.
+	if(count)
+		detail::toFloat16(&v[0].x, (detail::hdata *)p, count * 2);
+}
+
+GLM_FUNC_QUALIFIER void packUnorm3x10_1x2
+(
+	detail::tvec4<detail::float32> const * v,
+	detail::uint32 * p,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(1023.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 X = _mm_loadu_ps(&v[i + 0].x);
+		__m128 Y = _mm_loadu_ps(&v[i + 1].x);
+		__m128 Z = _mm_loadu_ps(&v[i + 2].x);
+		__m128 W = _mm_loadu_ps(&v[i + 3].x);
+		_MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+		__m128i A = detail::sse_packUnorm_ps(X, Scale);
+		__m128i B = _mm_slli_epi32(detail::sse_packUnorm_ps(Y, Scale), 10);
+		__m128i C = _mm_slli_epi32(detail::sse_packUnorm_ps(Z, Scale), 20);
+		__m128i D = _mm_slli_epi32(detail::sse_packUnorm_ps(W, _mm_set1_ps(3.0f)), 30);
+		_mm_storeu_si128((__m128i *)(p + i), _mm_or_si128(_mm_or_si128(A, B), _mm_or_si128(C, D)));
+	}
+#endif
+	for(; i < count; ++i)
+		p[i] = packUnorm3x10_1x2(v[i]);
+}
+
+GLM_FUNC_QUALIFIER void packSnorm3x10_1x2
+(
+	detail::tvec4<detail::float32> const * v,
+	detail::uint32 * p,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(511.0f);
+	__m128i const Mask10 = _mm_set1_epi32((1 << 10) - 1);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 X = _mm_loadu_ps(&v[i + 0].x);
+		__m128 Y = _mm_loadu_ps(&v[i + 1].x);
+		__m128 Z = _mm_loadu_ps(&v[i + 2].x);
+		__m128 W = _mm_loadu_ps(&v[i + 3].x);
+		_MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+		__m128i A = _mm_and_si128(detail::sse_packSnorm_ps(X, Scale), Mask10);
+		__m128i B = _mm_slli_epi32(_mm_and_si128(detail::sse_packSnorm_ps(Y, Scale), Mask10), 10);
+		__m128i C = _mm_slli_epi32(_mm_and_si128(detail::sse_packSnorm_ps(Z, Scale), Mask10), 20);
+		__m128i D = _mm_slli_epi32(detail::sse_packSnorm_ps(W, _mm_set1_ps(1.0f)), 30);
+		_mm_storeu_si128((__m128i *)(p + i), _mm_or_si128(_mm_or_si128(A, B), _mm_or_si128(C, D)));
+	}
+#endif
+	for(; i < count; ++i)
+		p[i] = packSnorm3x10_1x2(v[i]);
+}
+
+GLM_FUNC_QUALIFIER void unpackUnorm2x16
+(
+	detail::uint32 const * p,
+	detail::tvec2<detail::float32> * v,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(65535.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i Pack = _mm_loadu_si128((__m128i const *)(p + i));
+		_mm_storeu_ps(&v[i + 0].x, detail::sse_unpackUnorm_ps(_mm_unpacklo_epi16(Pack, _mm_setzero_si128()), Scale));
+		_mm_storeu_ps(&v[i + 2].x, detail::sse_unpackUnorm_ps(_mm_unpackhi_epi16(Pack, _mm_setzero_si128()), Scale));
+	}
+#endif
+	for(; i < count; ++i)
+		v[i] = unpackUnorm2x16(p[i]);
+}
+
+GLM_FUNC_QUALIFIER void unpackSnorm2x16
+(
+	detail::uint32 const * p,
+	detail::tvec2<detail::float32> * v,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(32767.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		// Unpacking each value with itself and shifting back down extends the sign.
+		__m128i Pack = _mm_loadu_si128((__m128i const *)(p + i));
+		_mm_storeu_ps(&v[i + 0].x, detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Pack, Pack), 16), Scale));
+		_mm_storeu_ps(&v[i + 2].x, detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Pack, Pack), 16), Scale));
+	}
+#endif
+	for(; i < count; ++i)
+		v[i] = unpackSnorm2x16(p[i]);
+}
+
+GLM_FUNC_QUALIFIER void unpackUnorm4x8
+(
+	detail::uint32 const * p,
+	detail::tvec4<detail::float32> * v,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(255.0f);
+	__m128i const Zero = _mm_setzero_si128();
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i Pack = _mm_loadu_si128((__m128i const *)(p + i));
+		__m128i Low = _mm_unpacklo_epi8(Pack, Zero);
+		__m128i High = _mm_unpackhi_epi8(Pack, Zero);
+		_mm_storeu_ps(&v[i + 0].x, detail::sse_unpackUnorm_ps(_mm_unpacklo_epi16(Low, Zero), Scale));
+		_mm_storeu_ps(&v[i + 1].x, detail::sse_unpackUnorm_ps(_mm_unpackhi_epi16(Low, Zero), Scale));
+		_mm_storeu_ps(&v[i + 2].x, detail::sse_unpackUnorm_ps(_mm_unpacklo_epi16(High, Zero), Scale));
+		_mm_storeu_ps(&v[i + 3].x, detail::sse_unpackUnorm_ps(_mm_unpackhi_epi16(High, Zero), Scale));
+	}
+#endif
+	for(; i < count; ++i)
+		v[i] = unpackUnorm4x8(p[i]);
+}
+
+GLM_FUNC_QUALIFIER void unpackSnorm4x8
+(
+	detail::uint32 const * p,
+	detail::tvec4<detail::float32> * v,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(127.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		// Unpacking each value with itself and shifting back down extends the sign.
+		__m128i Pack = _mm_loadu_si128((__m128i const *)(p + i));
+		__m128i Low = _mm_srai_epi16(_mm_unpacklo_epi8(Pack, Pack), 8);
+		__m128i High = _mm_srai_epi16(_mm_unpackhi_epi8(Pack, Pack), 8);
+		_mm_storeu_ps(&v[i + 0].x, detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Low, Low), 16), Scale));
+		_mm_storeu_ps(&v[i + 1].x, detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Low, Low), 16), Scale));
+		_mm_storeu_ps(&v[i + 2].x, detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_unpacklo_epi16(High, High), 16), Scale));
+		_mm_storeu_ps(&v[i + 3].x, detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_unpackhi_epi16(High, High), 16), Scale));
+	}
+#endif
+	for(; i < count; ++i)
+		v[i] = unpackSnorm4x8(p[i]);
+}
+
+GLM_FUNC_QUALIFIER void unpackHalf2x16
+(
+	detail::uint32 const * p,
+	detail::tvec2<detail::float32> * v,
+	std::size_t count
+)
+{
+	if(count)
+		detail::toFloat32((detail::hdata const *)p, &v[0].x, count * 2);
+}
+
+GLM_FUNC_QUALIFIER void unpackUnorm3x10_1x2
+(
+	detail::uint32 const * p,
+	detail::tvec4<detail::float32> * v,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(1023.0f);
+	__m128i const Mask10 = _mm_set1_epi32((1 << 10) - 1);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i Pack = _mm_loadu_si128((__m128i const *)(p + i));
+		__m128 X = detail::sse_unpackUnorm_ps(_mm_and_si128(Pack, Mask10), Scale);
+		__m128 Y = detail::sse_unpackUnorm_ps(_mm_and_si128(_mm_srli_epi32(Pack, 10), Mask10), Scale);
+		__m128 Z = detail::sse_unpackUnorm_ps(_mm_and_si128(_mm_srli_epi32(Pack, 20), Mask10), Scale);
+		__m128 W = detail::sse_unpackUnorm_ps(_mm_srli_epi32(Pack, 30), _mm_set1_ps(3.0f));
+		_MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+		_mm_storeu_ps(&v[i + 0].x, X);
+		_mm_storeu_ps(&v[i + 1].x, Y);
+		_mm_storeu_ps(&v[i + 2].x, Z);
+		_mm_storeu_ps(&v[i + 3].x, W);
+	}
+#endif
+	for(; i < count; ++i)
+		v[i] = unpackUnorm3x10_1x2(p[i]);
+}
+
+GLM_FUNC_QUALIFIER void unpackSnorm3x10_1x2
+(
+	detail::uint32 const * p,
+	detail::tvec4<detail::float32> * v,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	__m128 const Scale = _mm_set1_ps(511.0f);
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i Pack = _mm_loadu_si128((__m128i const *)(p + i));
+		__m128 X = detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_slli_epi32(Pack, 22), 22), Scale);
+		__m128 Y = detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_slli_epi32(Pack, 12), 22), Scale);
+		__m128 Z = detail::sse_unpackSnorm_ps(_mm_srai_epi32(_mm_slli_epi32(Pack, 2), 22), Scale);
+		__m128 W = detail::sse_unpackSnorm_ps(_mm_srai_epi32(Pack, 30), _mm_set1_ps(1.0f));
+		_MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+		_mm_storeu_ps(&v[i + 0].x, X);
+		_mm_storeu_ps(&v[i + 1].x, Y);
+		_mm_storeu_ps(&v[i + 2].x, Z);
+		_mm_storeu_ps(&v[i + 3].x, W);
+	}
+#endif
+	for(; i < count; ++i)
+		v[i] = unpackSnorm3x10_1x2(p[i]);
+}
+
 }//namespace packing
 }//namespace function
 }//namespace core
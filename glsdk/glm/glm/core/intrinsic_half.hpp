@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-19
+// Updated : 2026-10-19
+// Licence : This source is under MIT License
+// File    : glm/core/intrinsic_half.hpp
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef glm_core_intrinsic_half
+#define glm_core_intrinsic_half
+
+#include "setup.hpp"
+
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+
+// F16C is not part of AVX, and compilers do not all say when they target it, so the F16C
+// kernels are only used when the compiler says so or GLM_FORCE_F16C is defined.
+#if(defined(__F16C__) || defined(__AVX2__) || defined(GLM_FORCE_F16C))
+#	define GLM_INTRINSIC_F16C
+#	include <immintrin.h>
+#endif
+
+namespace glm{
+namespace detail
+{
+	// Kernels for the array versions of toFloat16 and toFloat32. They give the same bits as the
+	// scalar versions for every input, including denormals, infinities and NaNs.
+
+	//! Four floats to halves, sign extended into the four 32-bit integers.
+	GLM_FUNC_DECL __m128i sse_toFloat16_ps(__m128 in);
+	//! Four halves, in the low 16 bits of the four 32-bit integers, to floats.
+	GLM_FUNC_DECL __m128 sse_toFloat32_ps(__m128i in);
+
+#ifdef GLM_INTRINSIC_F16C
+	//! The same as the SSE2 kernels, but with the four halves packed into the low 64 bits.
+	GLM_FUNC_DECL __m128i f16c_toFloat16_ps(__m128 in);
+	GLM_FUNC_DECL __m128 f16c_toFloat32_ps(__m128i in);
+#endif//GLM_INTRINSIC_F16C
+
+}//namespace detail
+}//namespace glm
+
+#include "intrinsic_half.inl"
+
+#endif//((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+
+#endif//glm_core_intrinsic_half
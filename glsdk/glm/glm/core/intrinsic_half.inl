@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-19
+// Updated : 2026-10-19
+// Licence : This source is under MIT License
+// File    : glm/core/intrinsic_half.inl
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail
+{
+	// Takes a where mask is set, and b elsewhere.
+	GLM_FUNC_QUALIFIER __m128i sse_select_si128
+	(
+		__m128i mask,
+		__m128i a,
+		__m128i b
+	)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	GLM_FUNC_QUALIFIER __m128i sse_toFloat16_ps
+	(
+		__m128 in
+	)
+	{
+		__m128i bits = _mm_castps_si128(in);
+		__m128i absBits = _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff));
+		__m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x00008000));
+
+		// Normalized half: rebias the exponent and round "0.5" up. A carry out of the
+		// significand goes into the exponent, and one out of the exponent gives infinity.
+		__m128i normal = _mm_add_epi32(_mm_sub_epi32(absBits, _mm_set1_epi32(0x38000000)), _mm_set1_epi32(0x00001000));
+		normal = _mm_srli_epi32(normal, 13);
+		normal = sse_select_si128(_mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x477fefff)), _mm_set1_epi32(0x7c00), normal);
+
+		// NaN: keep the 10 leftmost bits of the significand, but never let it become infinity.
+		__m128i nan = _mm_and_si128(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(0x000003ff));
+		nan = _mm_or_si128(nan, _mm_and_si128(_mm_cmpeq_epi32(nan, _mm_setzero_si128()), _mm_set1_epi32(1)));
+		nan = _mm_or_si128(nan, _mm_set1_epi32(0x7c00));
+		normal = sse_select_si128(_mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x7f800000)), nan, normal);
+
+		// Denormalized half: round(f * 2^24), "0.5" up. This is exact in float for values of at
+		// least half the smallest denormal.
+		__m128 scaled = _mm_mul_ps(_mm_castsi128_ps(absBits), _mm_set1_ps(16777216.0f));
+		__m128i denormal = _mm_cvttps_epi32(_mm_add_ps(scaled, _mm_set1_ps(0.5f)));
+		__m128i result = sse_select_si128(_mm_cmplt_epi32(absBits, _mm_set1_epi32(0x38800000)), denormal, normal);
+
+		// Smaller values become zero, and the scalar version loses their sign.
+		result = _mm_or_si128(result, sign);
+		result = _mm_andnot_si128(_mm_cmplt_epi32(absBits, _mm_set1_epi32(0x33000000)), result);
+		return _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+	}
+
+	GLM_FUNC_QUALIFIER __m128 sse_toFloat32_ps
+	(
+		__m128i in
+	)
+	{
+		__m128i sign = _mm_slli_epi32(_mm_and_si128(in, _mm_set1_epi32(0x00008000)), 16);
+		__m128i absBits = _mm_and_si128(in, _mm_set1_epi32(0x00007fff));
+		__m128i exponent = _mm_and_si128(in, _mm_set1_epi32(0x00007c00));
+
+		// Normalized half, infinity or NaN: move the bits over and rebias the exponent.
+		__m128i shifted = _mm_slli_epi32(absBits, 13);
+		__m128i normal = _mm_add_epi32(shifted, _mm_set1_epi32((127 - 15) << 23));
+		__m128i infNan = _mm_add_epi32(shifted, _mm_set1_epi32((255 - 31) << 23));
+		__m128i result = sse_select_si128(_mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x7c00)), infNan, normal);
+
+		// Zero or denormalized half: the significand times 2^-24, which is exact.
+		__m128 denormal = _mm_mul_ps(_mm_cvtepi32_ps(absBits), _mm_set1_ps(1.0f / 16777216.0f));
+		result = sse_select_si128(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()), _mm_castps_si128(denormal), result);
+
+		return _mm_castsi128_ps(_mm_or_si128(result, sign));
+	}
+
+#ifdef GLM_INTRINSIC_F16C
+	GLM_FUNC_QUALIFIER __m128i f16c_toFloat16_ps
+	(
+		__m128 in
+	)
+	{
+		// F16C rounds ties to even, so values that would round to a denormal, overflow, or are
+		// not finite go through the SSE2 kernel. They are rare in real data.
+		__m128i bits = _mm_castps_si128(in);
+		__m128i absBits = _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff));
+		__m128i denormal = _mm_and_si128(
+			_mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x32ffffff)),
+			_mm_cmplt_epi32(absBits, _mm_set1_epi32(0x38800000)));
+		__m128i special = _mm_or_si128(denormal, _mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x477fefff)));
+		if(_mm_movemask_epi8(special))
+		{
+			__m128i result = sse_toFloat16_ps(in);
+			return _mm_packs_epi32(result, result);
+		}
+
+		// Adding half a unit and truncating rounds "0.5" up. Values that flush to zero lose
+		// their sign, as in the scalar version.
+		__m128i zero = _mm_cmplt_epi32(absBits, _mm_set1_epi32(0x33000000));
+		bits = _mm_andnot_si128(_mm_and_si128(zero, _mm_set1_epi32(0x80000000)), bits);
+		bits = _mm_add_epi32(bits, _mm_set1_epi32(0x00001000));
+		return _mm_cvtps_ph(_mm_castsi128_ps(bits), _MM_FROUND_TO_ZERO);
+	}
+
+	GLM_FUNC_QUALIFIER __m128 f16c_toFloat32_ps
+	(
+		__m128i in
+	)
+	{
+		// F16C sets the quiet bit of signaling NaNs, and the scalar version does not.
+		__m128i absBits = _mm_and_si128(in, _mm_set1_epi16(0x7fff));
+		if(_mm_movemask_epi8(_mm_cmpgt_epi16(absBits, _mm_set1_epi16(0x7c00))) & 0xff)
+			return sse_toFloat32_ps(_mm_unpacklo_epi16(in, _mm_setzero_si128()));
+
+		return _mm_cvtph_ps(in);
+	}
+#endif//GLM_INTRINSIC_F16C
+
+}//namespace detail
+}//namespace glm
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-18
+// Updated : 2026-10-18
+// Licence : This source is under MIT License
+// File    : glm/core/intrinsic_matrix.hpp
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef glm_core_intrinsic_matrix
+#define glm_core_intrinsic_matrix
+
+#include "setup.hpp"
+
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+
+#include "type_mat4x4.hpp"
+#include "func_matrix.hpp"
+
+// VC2010 SP1 selects GLM_ARCH_AVX without knowing whether the target CPU has AVX, so the AVX
+// kernels are only used when the compiler is generating AVX code or GLM_FORCE_AVX is defined.
+#if(((GLM_ARCH & GLM_ARCH_AVX) == GLM_ARCH_AVX) && (defined(__AVX__) || defined(GLM_FORCE_AVX)))
+#	define GLM_INTRINSIC_AVX
+#endif
+
+namespace glm{
+namespace detail
+{
+	// Kernels for column-major float 4x4 matrices, one __m128 per column. They do the same
+	// float operations in the same order as the generic templates, so the results are the
+	// same bit for bit. The tmat4x4<float> versions of operator*, transpose, determinant and
+	// inverse are specialized to use them. Define GLM_FORCE_PURE to use the generic templates.
+
+	GLM_FUNC_DECL void sse_mul_ps(__m128 const in1[4], __m128 const in2[4], __m128 out[4]);
+	GLM_FUNC_DECL __m128 sse_mul_ps(__m128 const m[4], __m128 v);
+	GLM_FUNC_DECL void sse_transpose_ps(__m128 const in[4], __m128 out[4]);
+
+	//! Columns of the adjugate, the inverse before it is divided by the determinant.
+	GLM_FUNC_DECL void sse_adjugate_ps(__m128 const in[4], __m128 out[4]);
+	//! Determinant in all four components.
+	GLM_FUNC_DECL __m128 sse_det_ps(__m128 const in[4]);
+	GLM_FUNC_DECL void sse_inverse_ps(__m128 const in[4], __m128 out[4]);
+
+	//! Inverses for matrices whose last row is (0, 0, 0, 1), and for those whose upper 3x3 is
+	//! also a rotation. These do not match the generic templates bit for bit.
+	GLM_FUNC_DECL void sse_affine_inverse_ps(__m128 const in[4], __m128 out[4]);
+	GLM_FUNC_DECL void sse_rigid_inverse_ps(__m128 const in[4], __m128 out[4]);
+
+#ifdef GLM_INTRINSIC_AVX
+	//! Computes two columns at a time.
+	GLM_FUNC_DECL void avx_mul_ps(__m128 const in1[4], __m128 const in2[4], __m128 out[4]);
+#endif//GLM_INTRINSIC_AVX
+
+}//namespace detail
+}//namespace glm
+
+#include "intrinsic_matrix.inl"
+
+#endif//((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+
+#endif//glm_core_intrinsic_matrix
@@ -0,0 +1,401 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-18
+// Updated : 2026-10-19
+// Licence : This source is under MIT License
+// File    : glm/core/intrinsic_matrix.inl
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail
+{
+	// a0 * v.x + a1 * v.y + a2 * v.z + a3 * v.w, added in the same order as the generic templates.
+	GLM_FUNC_QUALIFIER __m128 sse_mul_col_ps
+	(
+		__m128 a0,
+		__m128 a1,
+		__m128 a2,
+		__m128 a3,
+		__m128 v
+	)
+	{
+		__m128 v0 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 v1 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 v2 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 v3 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m128 s0 = _mm_add_ps(_mm_mul_ps(a0, v0), _mm_mul_ps(a1, v1));
+		__m128 s1 = _mm_add_ps(s0, _mm_mul_ps(a2, v2));
+		return _mm_add_ps(s1, _mm_mul_ps(a3, v3));
+	}
+
+	GLM_FUNC_QUALIFIER void sse_mul_ps
+	(
+		__m128 const in1[4],
+		__m128 const in2[4],
+		__m128 out[4]
+	)
+	{
+		// Read into locals first; out may be in1 or in2, and otherwise the compiler has to
+		// assume that each store changes them.
+		__m128 a0 = in1[0];
+		__m128 a1 = in1[1];
+		__m128 a2 = in1[2];
+		__m128 a3 = in1[3];
+		__m128 b0 = in2[0];
+		__m128 b1 = in2[1];
+		__m128 b2 = in2[2];
+		__m128 b3 = in2[3];
+
+		out[0] = sse_mul_col_ps(a0, a1, a2, a3, b0);
+		out[1] = sse_mul_col_ps(a0, a1, a2, a3, b1);
+		out[2] = sse_mul_col_ps(a0, a1, a2, a3, b2);
+		out[3] = sse_mul_col_ps(a0, a1, a2, a3, b3);
+	}
+
+	GLM_FUNC_QUALIFIER __m128 sse_mul_ps
+	(
+		__m128 const m[4],
+		__m128 v
+	)
+	{
+		return sse_mul_col_ps(m[0], m[1], m[2], m[3], v);
+	}
+
+	GLM_FUNC_QUALIFIER void sse_transpose_ps
+	(
+		__m128 const in[4],
+		__m128 out[4]
+	)
+	{
+		__m128 r0 = in[0];
+		__m128 r1 = in[1];
+		__m128 r2 = in[2];
+		__m128 r3 = in[3];
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		out[0] = r0;
+		out[1] = r1;
+		out[2] = r2;
+		out[3] = r3;
+	}
+
+	// The 2x2 determinants of rows p and q that the generic inverse calls Fac0 to Fac5:
+	// (in[2][p] * in[3][q] - in[3][p] * in[2][q], the same again,
+	//  in[1][p] * in[3][q] - in[3][p] * in[1][q],
+	//  in[1][p] * in[2][q] - in[2][p] * in[1][q])
+	template <int p, int q>
+	GLM_FUNC_QUALIFIER __m128 sse_inverse_factor_ps
+	(
+		__m128 const in[4]
+	)
+	{
+		__m128 P21 = _mm_shuffle_ps(in[2], in[1], _MM_SHUFFLE(p, p, p, p));
+		__m128 Q21 = _mm_shuffle_ps(in[2], in[1], _MM_SHUFFLE(q, q, q, q));
+		__m128 P32 = _mm_shuffle_ps(in[3], in[2], _MM_SHUFFLE(p, p, p, p));
+		__m128 Q32 = _mm_shuffle_ps(in[3], in[2], _MM_SHUFFLE(q, q, q, q));
+		P32 = _mm_shuffle_ps(P32, P32, _MM_SHUFFLE(2, 0, 0, 0));
+		Q32 = _mm_shuffle_ps(Q32, Q32, _MM_SHUFFLE(2, 0, 0, 0));
+		return _mm_sub_ps(_mm_mul_ps(P21, Q32), _mm_mul_ps(P32, Q21));
+	}
+
+	// (in[1][r], in[0][r], in[0][r], in[0][r]), which the generic inverse calls Vec0 to Vec3.
+	template <int r>
+	GLM_FUNC_QUALIFIER __m128 sse_inverse_vec_ps
+	(
+		__m128 const in[4]
+	)
+	{
+		__m128 R10 = _mm_shuffle_ps(in[1], in[0], _MM_SHUFFLE(r, r, r, r));
+		return _mm_shuffle_ps(R10, R10, _MM_SHUFFLE(2, 2, 2, 0));
+	}
+
+	GLM_FUNC_QUALIFIER void sse_adjugate_ps
+	(
+		__m128 const in[4],
+		__m128 out[4]
+	)
+	{
+		__m128 Fac0 = sse_inverse_factor_ps<2, 3>(in);
+		__m128 Fac1 = sse_inverse_factor_ps<1, 3>(in);
+		__m128 Fac2 = sse_inverse_factor_ps<1, 2>(in);
+		__m128 Fac3 = sse_inverse_factor_ps<0, 3>(in);
+		__m128 Fac4 = sse_inverse_factor_ps<0, 2>(in);
+		__m128 Fac5 = sse_inverse_factor_ps<0, 1>(in);
+
+		__m128 Vec0 = sse_inverse_vec_ps<0>(in);
+		__m128 Vec1 = sse_inverse_vec_ps<1>(in);
+		__m128 Vec2 = sse_inverse_vec_ps<2>(in);
+		__m128 Vec3 = sse_inverse_vec_ps<3>(in);
+
+		__m128 SignA = _mm_set_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+		__m128 SignB = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+
+		// Multiplying by the signs, rather than flipping the sign bits, keeps NaNs the same too.
+		__m128 Inv0 = _mm_sub_ps(_mm_mul_ps(Vec1, Fac0), _mm_mul_ps(Vec2, Fac1));
+		out[0] = _mm_mul_ps(SignA, _mm_add_ps(Inv0, _mm_mul_ps(Vec3, Fac2)));
+		__m128 Inv1 = _mm_sub_ps(_mm_mul_ps(Vec0, Fac0), _mm_mul_ps(Vec2, Fac3));
+		out[1] = _mm_mul_ps(SignB, _mm_add_ps(Inv1, _mm_mul_ps(Vec3, Fac4)));
+		__m128 Inv2 = _mm_sub_ps(_mm_mul_ps(Vec0, Fac1), _mm_mul_ps(Vec1, Fac3));
+		out[2] = _mm_mul_ps(SignA, _mm_add_ps(Inv2, _mm_mul_ps(Vec3, Fac5)));
+		__m128 Inv3 = _mm_sub_ps(_mm_mul_ps(Vec0, Fac2), _mm_mul_ps(Vec1, Fac4));
+		out[3] = _mm_mul_ps(SignB, _mm_add_ps(Inv3, _mm_mul_ps(Vec2, Fac5)));
+	}
+
+	// The first row of the adjugate holds the cofactors of the first column, so its dot product
+	// with that column is the determinant. The sum is done in the same order as glm::dot.
+	GLM_FUNC_QUALIFIER __m128 sse_det_from_adjugate_ps
+	(
+		__m128 const in[4],
+		__m128 const adj[4]
+	)
+	{
+		__m128 Row0 = _mm_movelh_ps(_mm_unpacklo_ps(adj[0], adj[1]), _mm_unpacklo_ps(adj[2], adj[3]));
+		__m128 Prod = _mm_mul_ps(in[0], Row0);
+
+		__m128 Sum = _mm_add_ss(Prod, _mm_shuffle_ps(Prod, Prod, _MM_SHUFFLE(1, 1, 1, 1)));
+		Sum = _mm_add_ss(Sum, _mm_shuffle_ps(Prod, Prod, _MM_SHUFFLE(2, 2, 2, 2)));
+		Sum = _mm_add_ss(Sum, _mm_shuffle_ps(Prod, Prod, _MM_SHUFFLE(3, 3, 3, 3)));
+		return _mm_shuffle_ps(Sum, Sum, _MM_SHUFFLE(0, 0, 0, 0));
+	}
+
+	GLM_FUNC_QUALIFIER __m128 sse_det_ps
+	(
+		__m128 const in[4]
+	)
+	{
+		__m128 Adj[4];
+		sse_adjugate_ps(in, Adj);
+		return sse_det_from_adjugate_ps(in, Adj);
+	}
+
+	GLM_FUNC_QUALIFIER void sse_inverse_ps
+	(
+		__m128 const in[4],
+		__m128 out[4]
+	)
+	{
+		__m128 Adj[4];
+		sse_adjugate_ps(in, Adj);
+		__m128 Det = sse_det_from_adjugate_ps(in, Adj);
+
+		out[0] = _mm_div_ps(Adj[0], Det);
+		out[1] = _mm_div_ps(Adj[1], Det);
+		out[2] = _mm_div_ps(Adj[2], Det);
+		out[3] = _mm_div_ps(Adj[3], Det);
+	}
+
+	// Given the columns of the inverse of the upper 3x3, with w = 0, fills in the translation.
+	GLM_FUNC_QUALIFIER void sse_affine_translation_ps
+	(
+		__m128 const in[4],
+		__m128 out[4]
+	)
+	{
+		__m128 tx = _mm_shuffle_ps(in[3], in[3], _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 ty = _mm_shuffle_ps(in[3], in[3], _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 tz = _mm_shuffle_ps(in[3], in[3], _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 Sum = _mm_add_ps(_mm_mul_ps(out[0], tx), _mm_mul_ps(out[1], ty));
+		Sum = _mm_add_ps(Sum, _mm_mul_ps(out[2], tz));
+		out[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), Sum);
+	}
+
+	GLM_FUNC_QUALIFIER void sse_rigid_inverse_ps
+	(
+		__m128 const in[4],
+		__m128 out[4]
+	)
+	{
+		// The inverse of a rotation is its transpose.
+		__m128 r0 = in[0];
+		__m128 r1 = in[1];
+		__m128 r2 = in[2];
+		__m128 r3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		out[0] = r0;
+		out[1] = r1;
+		out[2] = r2;
+		sse_affine_translation_ps(in, out);
+	}
+
+	// (a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x, 0) if a.w and b.w are 0.
+	GLM_FUNC_QUALIFIER __m128 sse_cross_ps
+	(
+		__m128 a,
+		__m128 b
+	)
+	{
+		__m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 a_zxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+		__m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 b_zxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+		return _mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx));
+	}
+
+	GLM_FUNC_QUALIFIER void sse_affine_inverse_ps
+	(
+		__m128 const in[4],
+		__m128 out[4]
+	)
+	{
+		// The rows of the inverse of the upper 3x3 are the cross products of pairs of its
+		// columns, divided by the determinant.
+		__m128 Col0 = _mm_and_ps(in[0], _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+		__m128 Col1 = _mm_and_ps(in[1], _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+		__m128 Col2 = _mm_and_ps(in[2], _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+		__m128 r0 = sse_cross_ps(Col1, Col2);
+		__m128 r1 = sse_cross_ps(Col2, Col0);
+		__m128 r2 = sse_cross_ps(Col0, Col1);
+
+		__m128 Prod = _mm_mul_ps(Col0, r0);
+		__m128 Det = _mm_add_ss(Prod, _mm_shuffle_ps(Prod, Prod, _MM_SHUFFLE(1, 1, 1, 1)));
+		Det = _mm_add_ss(Det, _mm_shuffle_ps(Prod, Prod, _MM_SHUFFLE(2, 2, 2, 2)));
+		Det = _mm_shuffle_ps(Det, Det, _MM_SHUFFLE(0, 0, 0, 0));
+
+		__m128 r3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		__m128 InvDet = _mm_div_ps(_mm_set1_ps(1.0f), Det);
+		out[0] = _mm_mul_ps(r0, InvDet);
+		out[1] = _mm_mul_ps(r1, InvDet);
+		out[2] = _mm_mul_ps(r2, InvDet);
+		sse_affine_translation_ps(in, out);
+	}
+
+#ifdef GLM_INTRINSIC_AVX
+	GLM_FUNC_QUALIFIER void avx_mul_ps
+	(
+		__m128 const in1[4],
+		__m128 const in2[4],
+		__m128 out[4]
+	)
+	{
+		// Each column of in1 in both halves, and two columns of in2 side by side.
+		__m256 a0 = _mm256_insertf128_ps(_mm256_castps128_ps256(in1[0]), in1[0], 1);
+		__m256 a1 = _mm256_insertf128_ps(_mm256_castps128_ps256(in1[1]), in1[1], 1);
+		__m256 a2 = _mm256_insertf128_ps(_mm256_castps128_ps256(in1[2]), in1[2], 1);
+		__m256 a3 = _mm256_insertf128_ps(_mm256_castps128_ps256(in1[3]), in1[3], 1);
+		__m256 b01 = _mm256_insertf128_ps(_mm256_castps128_ps256(in2[0]), in2[1], 1);
+		__m256 b23 = _mm256_insertf128_ps(_mm256_castps128_ps256(in2[2]), in2[3], 1);
+
+		__m256 s01 = _mm256_add_ps(
+			_mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0))),
+			_mm256_mul_ps(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1))));
+		s01 = _mm256_add_ps(s01, _mm256_mul_ps(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2))));
+		s01 = _mm256_add_ps(s01, _mm256_mul_ps(a3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3))));
+
+		__m256 s23 = _mm256_add_ps(
+			_mm256_mul_ps(a0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0))),
+			_mm256_mul_ps(a1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1))));
+		s23 = _mm256_add_ps(s23, _mm256_mul_ps(a2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2))));
+		s23 = _mm256_add_ps(s23, _mm256_mul_ps(a3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3))));
+
+		out[0] = _mm256_castps256_ps128(s01);
+		out[1] = _mm256_extractf128_ps(s01, 1);
+		out[2] = _mm256_castps256_ps128(s23);
+		out[3] = _mm256_extractf128_ps(s23, 1);
+	}
+#endif//GLM_INTRINSIC_AVX
+
+	GLM_FUNC_QUALIFIER void sse_load_ps
+	(
+		tmat4x4<float> const & m,
+		__m128 out[4]
+	)
+	{
+		out[0] = _mm_loadu_ps(&m[0][0]);
+		out[1] = _mm_loadu_ps(&m[1][0]);
+		out[2] = _mm_loadu_ps(&m[2][0]);
+		out[3] = _mm_loadu_ps(&m[3][0]);
+	}
+
+	GLM_FUNC_QUALIFIER tmat4x4<float> sse_store_ps
+	(
+		__m128 const in[4]
+	)
+	{
+		tmat4x4<float> Result(tmat4x4<float>::null);
+		_mm_storeu_ps(&Result[0][0], in[0]);
+		_mm_storeu_ps(&Result[1][0], in[1]);
+		_mm_storeu_ps(&Result[2][0], in[2]);
+		_mm_storeu_ps(&Result[3][0], in[3]);
+		return Result;
+	}
+
+	template <>
+	GLM_FUNC_QUALIFIER tmat4x4<float> operator*
+	(
+		tmat4x4<float> const & m1,
+		tmat4x4<float> const & m2
+	)
+	{
+		__m128 In1[4], In2[4], Out[4];
+		sse_load_ps(m1, In1);
+		sse_load_ps(m2, In2);
+#ifdef GLM_INTRINSIC_AVX
+		avx_mul_ps(In1, In2, Out);
+#else
+		sse_mul_ps(In1, In2, Out);
+#endif//GLM_INTRINSIC_AVX
+		return sse_store_ps(Out);
+	}
+
+	template <>
+	GLM_FUNC_QUALIFIER tvec4<float> operator*
+	(
+		tmat4x4<float> const & m,
+		tvec4<float> const & v
+	)
+	{
+		__m128 In[4];
+		sse_load_ps(m, In);
+		tvec4<float> Result;
+		_mm_storeu_ps(&Result[0], sse_mul_ps(In, _mm_loadu_ps(&v[0])));
+		return Result;
+	}
+
+}//namespace detail
+
+	namespace core{
+	namespace function{
+	namespace matrix{
+
+	template <>
+	GLM_FUNC_QUALIFIER detail::tmat4x4<float> transpose
+	(
+		detail::tmat4x4<float> const & m
+	)
+	{
+		__m128 In[4], Out[4];
+		detail::sse_load_ps(m, In);
+		detail::sse_transpose_ps(In, Out);
+		return detail::sse_store_ps(Out);
+	}
+
+	template <>
+	GLM_FUNC_QUALIFIER float determinant
+	(
+		detail::tmat4x4<float> const & m
+	)
+	{
+		__m128 In[4];
+		detail::sse_load_ps(m, In);
+		return _mm_cvtss_f32(detail::sse_det_ps(In));
+	}
+
+	template <>
+	GLM_FUNC_QUALIFIER detail::tmat4x4<float> inverse
+	(
+		detail::tmat4x4<float> const & m
+	)
+	{
+		__m128 In[4], Out[4];
+		detail::sse_load_ps(m, In);
+		detail::sse_inverse_ps(In, Out);
+		return detail::sse_store_ps(Out);
+	}
+
+	}//namespace matrix
+	}//namespace function
+	}//namespace core
+}//namespace glm
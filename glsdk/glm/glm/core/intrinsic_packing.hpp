@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-19
+// Updated : 2026-10-19
+// Licence : This source is under MIT License
+// File    : glm/core/intrinsic_packing.hpp
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef glm_core_intrinsic_packing
+#define glm_core_intrinsic_packing
+
+#include "setup.hpp"
+
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+
+namespace glm{
+namespace detail
+{
+	// Kernels for the array versions of the packing functions. They do the same float operations
+	// as the scalar versions, including glm's clamp and round, so the results are the same bit
+	// for bit. scale is the largest packed value, per component.
+
+	//! round(clamp(v, 0, 1) * scale)
+	GLM_FUNC_DECL __m128i sse_packUnorm_ps(__m128 v, __m128 scale);
+	//! round(clamp(v, -1, 1) * scale)
+	GLM_FUNC_DECL __m128i sse_packSnorm_ps(__m128 v, __m128 scale);
+	//! p * 1.0f / scale
+	GLM_FUNC_DECL __m128 sse_unpackUnorm_ps(__m128i p, __m128 scale);
+	//! clamp(p * 1.0f / scale, -1, 1)
+	GLM_FUNC_DECL __m128 sse_unpackSnorm_ps(__m128i p, __m128 scale);
+
+}//namespace detail
+}//namespace glm
+
+#include "intrinsic_packing.inl"
+
+#endif//((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+
+#endif//glm_core_intrinsic_packing
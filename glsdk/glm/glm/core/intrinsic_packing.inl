@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-19
+// Updated : 2026-10-19
+// Licence : This source is under MIT License
+// File    : glm/core/intrinsic_packing.inl
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace detail
+{
+	// glm::round: truncate x + 0.5, or x - 0.5 for negative x.
+	GLM_FUNC_QUALIFIER __m128i sse_round_ps
+	(
+		__m128 x
+	)
+	{
+		__m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+		__m128 half = _mm_or_ps(_mm_and_ps(negative, _mm_set1_ps(-0.5f)), _mm_andnot_ps(negative, _mm_set1_ps(0.5f)));
+		return _mm_cvttps_epi32(_mm_add_ps(x, half));
+	}
+
+	// glm::clamp is max(min(x, maxVal), minVal), with min(x, y) being x < y ? x : y, the same
+	// as minps. So NaN becomes maxVal in both.
+	GLM_FUNC_QUALIFIER __m128 sse_clamp_ps
+	(
+		__m128 x,
+		__m128 minVal,
+		__m128 maxVal
+	)
+	{
+		return _mm_max_ps(_mm_min_ps(x, maxVal), minVal);
+	}
+
+	GLM_FUNC_QUALIFIER __m128i sse_packUnorm_ps
+	(
+		__m128 v,
+		__m128 scale
+	)
+	{
+		return sse_round_ps(_mm_mul_ps(sse_clamp_ps(v, _mm_setzero_ps(), _mm_set1_ps(1.0f)), scale));
+	}
+
+	GLM_FUNC_QUALIFIER __m128i sse_packSnorm_ps
+	(
+		__m128 v,
+		__m128 scale
+	)
+	{
+		return sse_round_ps(_mm_mul_ps(sse_clamp_ps(v, _mm_set1_ps(-1.0f), _mm_set1_ps(1.0f)), scale));
+	}
+
+	GLM_FUNC_QUALIFIER __m128 sse_unpackUnorm_ps
+	(
+		__m128i p,
+		__m128 scale
+	)
+	{
+		return _mm_div_ps(_mm_cvtepi32_ps(p), scale);
+	}
+
+	GLM_FUNC_QUALIFIER __m128 sse_unpackSnorm_ps
+	(
+		__m128i p,
+		__m128 scale
+	)
+	{
+		return sse_clamp_ps(_mm_div_ps(_mm_cvtepi32_ps(p), scale), _mm_set1_ps(-1.0f), _mm_set1_ps(1.0f));
+	}
+
+}//namespace detail
+}//namespace glm
@@ -20,6 +20,11 @@ namespace detail
 	float toFloat32(hdata value);
 	hdata toFloat16(float const & value);
 
+	//! Convert count values, with SSE2 or F16C when available. The results are the same as the
+	//! scalar versions, bit for bit.
+	void toFloat32(hdata const * in, float * out, std::size_t count);
+	void toFloat16(float const * in, hdata * out, std::size_t count);
+
 	///16-bit floating point type.
 	/// \ingroup gtc_half_float
 	class thalf
@@ -12,6 +12,7 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "_detail.hpp"
+#include "intrinsic_half.hpp"
 
 namespace glm{
 namespace detail
@@ -235,6 +236,52 @@ namespace detail
 		}
 	}
 
+	GLM_FUNC_QUALIFIER void toFloat32
+	(
+		hdata const * in,
+		float * out,
+		std::size_t count
+	)
+	{
+		std::size_t i = 0;
+#if(defined(GLM_INTRINSIC_F16C))
+		for(; i + 4 <= count; i += 4)
+			_mm_storeu_ps(out + i, f16c_toFloat32_ps(_mm_loadl_epi64((__m128i const *)(in + i))));
+#elif((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+		for(; i + 8 <= count; i += 8)
+		{
+			__m128i halves = _mm_loadu_si128((__m128i const *)(in + i));
+			_mm_storeu_ps(out + i, sse_toFloat32_ps(_mm_unpacklo_epi16(halves, _mm_setzero_si128())));
+			_mm_storeu_ps(out + i + 4, sse_toFloat32_ps(_mm_unpackhi_epi16(halves, _mm_setzero_si128())));
+		}
+#endif
+		for(; i < count; ++i)
+			out[i] = toFloat32(in[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void toFloat16
+	(
+		float const * in,
+		hdata * out,
+		std::size_t count
+	)
+	{
+		std::size_t i = 0;
+#if(defined(GLM_INTRINSIC_F16C))
+		for(; i + 4 <= count; i += 4)
+			_mm_storel_epi64((__m128i *)(out + i), f16c_toFloat16_ps(_mm_loadu_ps(in + i)));
+#elif((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+		for(; i + 8 <= count; i += 8)
+		{
+			__m128i low = sse_toFloat16_ps(_mm_loadu_ps(in + i));
+			__m128i high = sse_toFloat16_ps(_mm_loadu_ps(in + i + 4));
+			_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(low, high));
+		}
+#endif
+		for(; i < count; ++i)
+			out[i] = toFloat16(in[i]);
+	}
+
 	GLM_FUNC_QUALIFIER thalf::thalf() :
 		data(0)
 	{}
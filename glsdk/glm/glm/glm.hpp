@@ -71,6 +71,7 @@ namespace glm
 #include "./core/func_integer.hpp"
 #include "./core/func_noise.hpp"
 #include "./core/_swizzle.hpp"
+#include "./core/intrinsic_matrix.hpp"
 
 ////////////////////
 // check type sizes
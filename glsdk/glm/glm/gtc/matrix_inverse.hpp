@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-18
+// Updated : 2026-10-18
+// Licence : This source is under MIT License
+// File    : glm/gtc/matrix_inverse.hpp
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Dependency:
+// - GLM core
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef glm_gtc_matrix_inverse
+#define glm_gtc_matrix_inverse
+
+// Dependency:
+#include "../glm.hpp"
+
+#if(defined(GLM_MESSAGES) && !defined(glm_ext))
+#	pragma message("GLM: GLM_GTC_matrix_inverse extension included")
+#endif
+
+namespace glm{
+namespace gtc{
+namespace matrix_inverse ///< GLM_GTC_matrix_inverse extension: Inverses for matrices of known structure.
+{
+
+	/// \addtogroup gtc_matrix_inverse
+	///@{
+
+	//! Fast inverse of a matrix whose last row is (0, 0, 0, 1): any combination of rotations,
+	//! scales and translations. Only the upper 3x3 is inverted.
+	//! From GLM_GTC_matrix_inverse extension.
+	template <typename T>
+	detail::tmat4x4<T> affineInverse(
+		detail::tmat4x4<T> const & m);
+
+	//! Fast inverse of a matrix that is only a rotation and a translation, such as a camera or
+	//! view matrix. The rotation is inverted by transposing it.
+	//! From GLM_GTC_matrix_inverse extension.
+	template <typename T>
+	detail::tmat4x4<T> rigidInverse(
+		detail::tmat4x4<T> const & m);
+
+	///@}
+
+}//namespace matrix_inverse
+}//namespace gtc
+}//namespace glm
+
+#include "matrix_inverse.inl"
+
+namespace glm{using namespace gtc::matrix_inverse;}
+
+#endif//glm_gtc_matrix_inverse
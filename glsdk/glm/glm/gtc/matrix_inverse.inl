@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OpenGL Mathematics Copyright (c) 2005 - 2011 G-Truc Creation (www.g-truc.net)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Created : 2026-10-18
+// Updated : 2026-10-18
+// Licence : This source is under MIT License
+// File    : glm/gtc/matrix_inverse.inl
+// Note    : A local addition to the glm 0.9.2.6 in glsdk; not part of any glm release.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace glm{
+namespace gtc{
+namespace matrix_inverse
+{
+	template <typename T>
+	GLM_FUNC_QUALIFIER detail::tmat4x4<T> affineInverse
+	(
+		detail::tmat4x4<T> const & m
+	)
+	{
+		detail::tmat3x3<T> const Inv(glm::inverse(detail::tmat3x3<T>(m)));
+
+		return detail::tmat4x4<T>(
+			detail::tvec4<T>(Inv[0], T(0)),
+			detail::tvec4<T>(Inv[1], T(0)),
+			detail::tvec4<T>(Inv[2], T(0)),
+			detail::tvec4<T>(-(Inv * detail::tvec3<T>(m[3])), T(1)));
+	}
+
+	template <typename T>
+	GLM_FUNC_QUALIFIER detail::tmat4x4<T> rigidInverse
+	(
+		detail::tmat4x4<T> const & m
+	)
+	{
+		detail::tmat3x3<T> const Inv(glm::transpose(detail::tmat3x3<T>(m)));
+
+		return detail::tmat4x4<T>(
+			detail::tvec4<T>(Inv[0], T(0)),
+			detail::tvec4<T>(Inv[1], T(0)),
+			detail::tvec4<T>(Inv[2], T(0)),
+			detail::tvec4<T>(-(Inv * detail::tvec3<T>(m[3])), T(1)));
+	}
+
+#if((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+	template <>
+	GLM_FUNC_QUALIFIER detail::tmat4x4<float> affineInverse
+	(
+		detail::tmat4x4<float> const & m
+	)
+	{
+		__m128 In[4], Out[4];
+		detail::sse_load_ps(m, In);
+		detail::sse_affine_inverse_ps(In, Out);
+		return detail::sse_store_ps(Out);
+	}
+
+	template <>
+	GLM_FUNC_QUALIFIER detail::tmat4x4<float> rigidInverse
+	(
+		detail::tmat4x4<float> const & m
+	)
+	{
+		__m128 In[4], Out[4];
+		detail::sse_load_ps(m, In);
+		detail::sse_rigid_inverse_ps(In, Out);
+		return detail::sse_store_ps(Out);
+	}
+#endif//((GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2)
+
+}//namespace matrix_inverse
+}//namespace gtc
+}//namespace glm